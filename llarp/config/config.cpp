@@ -109,6 +109,11 @@ namespace llarp
       m_DefaultLinkProto = str(val);
       LogInfo("overriding default link protocol to '", val, "'");
     }
+    if(key == "congestion-control")
+    {
+      m_CongestionControl = str(val);
+      LogInfo("using '", val, "' congestion control on links");
+    }
     if(key == "netid")
     {
       if(val.size() <= NetID::size())
@@ -232,6 +237,10 @@ namespace llarp
       m_routerProfilesFile = str(val);
       llarp::LogInfo("setting profiles to ", routerProfilesFile());
     }
+    else if(key == "path-randomness")
+    {
+      m_pathRandomness = svtoi(val);
+    }
     else if(key == "strict-connect")
     {
       m_strictConnect = str(val);
@@ -628,6 +637,8 @@ llarp_generic_ensure_config(std::ofstream &f, std::string basepath,
   f << "# hard limit of routers globally we are connected to at any given "
        "time\n";
   f << "max-routers=" << std::to_string(limits.DefaultMaxRouters) << std::endl;
+  f << "# link congestion control, cubic (loss based) or bbr (delay based)\n";
+  f << "#congestion-control=bbr\n";
   f << "\n\n";
 
   // logging
@@ -772,6 +783,9 @@ llarp_ensure_client_config(std::ofstream &f, std::string basepath)
       example_f << "# ifname is the name to try and give to the network "
                    "interface this snap owns\n";
       example_f << "ifname=snapp-tun0\n";
+      example_f << "# linux only: how many queues to read the network "
+                   "interface through\n";
+      example_f << "#tun-queues=1\n";
     }
     else
     {
@@ -789,6 +803,9 @@ llarp_ensure_client_config(std::ofstream &f, std::string basepath)
   f << "# network settings \n";
   f << "[network]\n";
   f << "profiles=" << basepath << "profiles.dat\n";
+  f << "# percent of path hops picked at random instead of by measured "
+       "latency\n";
+  f << "#path-randomness=25\n";
   f << "# uncomment next line to add router with pubkey to list of routers we "
        "connect directly to\n";
   f << "#strict-connect=pubkey\n";
@@ -67,6 +67,8 @@ namespace llarp
 
     std::string m_DefaultLinkProto = "iwp";
 
+    std::string m_CongestionControl = "bbr";
+
    public:
     // clang-format off
     size_t jobQueueSize() const                { return fromEnv(m_JobQueueSize, "JOB_QUEUE_SIZE"); }
@@ -84,6 +86,7 @@ namespace llarp
     int workerThreads() const                  { return fromEnv(m_workerThreads, "WORKER_THREADS"); }
     int numNetThreads() const                  { return fromEnv(m_numNetThreads, "NUM_NET_THREADS"); }
     std::string defaultLinkProto() const       { return fromEnv(m_DefaultLinkProto, "LINK_PROTO"); }
+    std::string congestionControl() const      { return fromEnv(m_CongestionControl, "CONGESTION_CONTROL"); }
     nonstd::optional< bool > blockBogons() const { return fromEnv(m_blockBogons, "BLOCK_BOGONS"); }
     // clang-format on
 
@@ -99,6 +102,8 @@ namespace llarp
    private:
     nonstd::optional< bool > m_enableProfiling;
     std::string m_routerProfilesFile = "profiles.dat";
+    /// percent of path hops picked without looking at their profiles
+    int m_pathRandomness = 25;
     std::string m_strictConnect;
     NetConfig m_netConfig;
 
@@ -106,6 +111,7 @@ namespace llarp
     // clang-format off
     nonstd::optional< bool > enableProfiling() const { return fromEnv(m_enableProfiling, "ENABLE_PROFILING"); }
     std::string routerProfilesFile() const         { return fromEnv(m_routerProfilesFile, "ROUTER_PROFILES_FILE"); }
+    int pathRandomness() const                     { return fromEnv(m_pathRandomness, "PATH_RANDOMNESS"); }
     std::string strictConnect() const              { return fromEnv(m_strictConnect, "STRICT_CONNECT"); }
     const NetConfig& netConfig() const             { return m_netConfig; }
     // clang-format on
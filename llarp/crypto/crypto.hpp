@@ -19,6 +19,18 @@
 
 namespace llarp
 {
+  /// one buffer of a batched crypto call
+  struct CryptoBatchItem
+  {
+    /// buffer to transform in place or to hash
+    byte_t *data;
+    size_t sz;
+    /// 24 byte xchacha20 nonce, only read by xchacha20_batch
+    const byte_t *nonce;
+    /// HMACSIZE bytes of output, only written by hmac_batch
+    byte_t *mac;
+  };
+
   /// library crypto configuration
   struct Crypto
   {
@@ -34,6 +46,10 @@ namespace llarp
     xchacha20_alt(const llarp_buffer_t &, const llarp_buffer_t &,
                   const SharedSecret &, const byte_t *) = 0;
 
+    /// xchacha symmetric cipher in place over many buffers sharing one key
+    virtual bool
+    xchacha20_batch(const CryptoBatchItem *, size_t, const SharedSecret &) = 0;
+
     /// path dh creator's side
     virtual bool
     dh_client(SharedSecret &, const PubKey &, const SecretKey &,
@@ -56,6 +72,9 @@ namespace llarp
     /// blake2s 256 bit "hmac" (keyed hash)
     virtual bool
     hmac(byte_t *, const llarp_buffer_t &, const SharedSecret &) = 0;
+    /// keyed hash of many buffers sharing one key
+    virtual bool
+    hmac_batch(const CryptoBatchItem *, size_t, const SharedSecret &) = 0;
     /// ed25519 sign
     virtual bool
     sign(Signature &, const SecretKey &, const llarp_buffer_t &) = 0;
@@ -82,10 +82,12 @@ namespace llarp
       if(avx2 && std::string(avx2) == "1")
       {
         ntru_init(1);
+        m_BatchKernel = multibuf::Kernel::Scalar;
       }
       else
       {
         ntru_init(0);
+        m_BatchKernel = multibuf::Best();
       }
       int seed = 0;
       randombytes(reinterpret_cast< unsigned char * >(&seed), sizeof(seed));
@@ -112,6 +114,27 @@ namespace llarp
           == 0;
     }
 
+    bool
+    CryptoLibSodium::xchacha20_batch(const CryptoBatchItem *items, size_t num,
+                                     const SharedSecret &k)
+    {
+      // libsodium is faster than our portable kernel for single buffers
+      if(m_BatchKernel != multibuf::Kernel::Scalar)
+      {
+        multibuf::xchacha20(m_BatchKernel, items, num, k.data());
+        return true;
+      }
+      for(size_t idx = 0; idx < num; ++idx)
+      {
+        if(crypto_stream_xchacha20_xor(items[idx].data, items[idx].data,
+                                       items[idx].sz, items[idx].nonce,
+                                       k.data())
+           != 0)
+          return false;
+      }
+      return true;
+    }
+
     bool
     CryptoLibSodium::dh_client(llarp::SharedSecret &shared, const PubKey &pk,
                                const SecretKey &sk, const TunnelNonce &n)
@@ -159,6 +182,26 @@ namespace llarp
           != -1;
     }
 
+    bool
+    CryptoLibSodium::hmac_batch(const CryptoBatchItem *items, size_t num,
+                                const SharedSecret &secret)
+    {
+      if(m_BatchKernel != multibuf::Kernel::Scalar)
+      {
+        multibuf::hmac(m_BatchKernel, items, num, secret.data());
+        return true;
+      }
+      for(size_t idx = 0; idx < num; ++idx)
+      {
+        if(crypto_generichash_blake2b(items[idx].mac, HMACSIZE, items[idx].data,
+                                      items[idx].sz, secret.data(),
+                                      HMACSECSIZE)
+           == -1)
+          return false;
+      }
+      return true;
+    }
+
     static bool
     hash(uint8_t *result, const llarp_buffer_t &buff)
     {
@@ -2,6 +2,7 @@
 #define LLARP_CRYPTO_LIBSODIUM_HPP
 
 #include <crypto/crypto.hpp>
+#include <crypto/multibuf.hpp>
 
 namespace llarp
 {
@@ -23,6 +24,11 @@ namespace llarp
       xchacha20_alt(const llarp_buffer_t &, const llarp_buffer_t &,
                     const SharedSecret &, const byte_t *) override;
 
+      /// xchacha symmetric cipher over many buffers sharing one key
+      bool
+      xchacha20_batch(const CryptoBatchItem *, size_t,
+                      const SharedSecret &) override;
+
       /// path dh creator's side
       bool
       dh_client(SharedSecret &, const PubKey &, const SecretKey &,
@@ -45,6 +51,10 @@ namespace llarp
       /// blake2s 256 bit hmac
       bool
       hmac(byte_t *, const llarp_buffer_t &, const SharedSecret &) override;
+      /// blake2b 256 bit hmac of many buffers sharing one key
+      bool
+      hmac_batch(const CryptoBatchItem *, size_t,
+                 const SharedSecret &) override;
       /// ed25519 sign
       bool
       sign(Signature &, const SecretKey &, const llarp_buffer_t &) override;
@@ -98,6 +108,10 @@ namespace llarp
 
       bool
       check_identity_privkey(const SecretKey &) override;
+
+     private:
+      /// kernel used for batches, scalar when AVX2_FORCE_DISABLE=1
+      multibuf::Kernel m_BatchKernel;
     };
   }  // namespace sodium
 
@@ -42,6 +42,13 @@ namespace llarp
       return true;
     }
 
+    bool
+    xchacha20_batch(const CryptoBatchItem *, size_t,
+                    const SharedSecret &) override
+    {
+      return true;
+    }
+
     bool
     dh_client(SharedSecret &shared, const PubKey &pk, const SecretKey &,
               const TunnelNonce &) override
@@ -105,6 +112,18 @@ namespace llarp
       return true;
     }
 
+    bool
+    hmac_batch(const CryptoBatchItem *items, size_t num,
+               const SharedSecret &secret) override
+    {
+      for(size_t idx = 0; idx < num; ++idx)
+      {
+        const llarp_buffer_t buf(items[idx].data, items[idx].sz);
+        hmac(items[idx].mac, buf, secret);
+      }
+      return true;
+    }
+
     bool
     sign(Signature &sig, const SecretKey &, const llarp_buffer_t &) override
     {
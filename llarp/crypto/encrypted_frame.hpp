@@ -51,7 +51,8 @@ namespace llarp
     EncryptInPlace(const SecretKey& seckey, const PubKey& other);
   };
 
-  /// TODO: can only handle 1 frame at a time
+  /// decrypts one frame for User, either queued on a worker pool by itself
+  /// or as a job handed to whoever batches decrypts up
   template < typename User >
   struct AsyncFrameDecrypter
   {
@@ -80,13 +81,20 @@ namespace llarp
     const SecretKey& seckey;
     EncryptedFrame target;
 
+    /// copy frame in and get back the job that decrypts it
+    std::function< void(void) >
+    DecryptJob(const EncryptedFrame& frame, User_ptr u)
+    {
+      target = frame;
+      return std::bind(&AsyncFrameDecrypter< User >::Decrypt, this,
+                       std::move(u));
+    }
+
     void
     AsyncDecrypt(const std::shared_ptr< thread::ThreadPool >& worker,
                  const EncryptedFrame& frame, User_ptr u)
     {
-      target = frame;
-      worker->addJob(
-          std::bind(&AsyncFrameDecrypter< User >::Decrypt, this, std::move(u)));
+      worker->addJob(DecryptJob(frame, std::move(u)));
     }
   };
 }  // namespace llarp
@@ -0,0 +1,271 @@
+#include <crypto/multibuf.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+namespace llarp
+{
+  namespace multibuf
+  {
+    namespace detail
+    {
+      const uint32_t ChaChaSigma[4] = {0x61707865, 0x3320646e, 0x79622d32,
+                                       0x6b206574};
+
+      const uint64_t Blake2bIV[8] = {
+          0x6a09e667f3bcc908ULL, 0xbb67ae8584caa73bULL, 0x3c6ef372fe94f82bULL,
+          0xa54ff53a5f1d36f1ULL, 0x510e527fade682d1ULL, 0x9b05688c2b3e6c1fULL,
+          0x1f83d9abfb41bd6bULL, 0x5be0cd19137e2179ULL};
+
+      const uint8_t Blake2bSigma[12][16] = {
+          {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15},
+          {14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3},
+          {11, 8, 12, 0, 5, 2, 15, 13, 10, 14, 3, 6, 7, 1, 9, 4},
+          {7, 9, 3, 1, 13, 12, 11, 14, 2, 6, 5, 10, 4, 0, 15, 8},
+          {9, 0, 5, 7, 2, 4, 10, 15, 14, 1, 11, 12, 6, 8, 3, 13},
+          {2, 12, 6, 10, 0, 11, 8, 3, 4, 13, 7, 5, 15, 14, 1, 9},
+          {12, 5, 1, 15, 14, 13, 4, 10, 0, 7, 6, 3, 9, 2, 8, 11},
+          {13, 11, 7, 14, 12, 1, 3, 9, 5, 0, 15, 4, 8, 6, 2, 10},
+          {6, 15, 14, 9, 11, 3, 0, 8, 12, 2, 13, 7, 1, 4, 10, 5},
+          {10, 2, 8, 4, 7, 6, 1, 5, 15, 11, 9, 14, 3, 12, 13, 0},
+          {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15},
+          {14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3}};
+    }  // namespace detail
+
+    namespace
+    {
+      using namespace detail;
+
+      uint32_t
+      Load32(const byte_t* ptr)
+      {
+        return uint32_t(ptr[0]) | (uint32_t(ptr[1]) << 8)
+            | (uint32_t(ptr[2]) << 16) | (uint32_t(ptr[3]) << 24);
+      }
+
+      uint64_t
+      Load64(const byte_t* ptr)
+      {
+        return uint64_t(Load32(ptr)) | (uint64_t(Load32(ptr + 4)) << 32);
+      }
+
+      void
+      Store32(byte_t* ptr, uint32_t val)
+      {
+        for(size_t idx = 0; idx < 4; ++idx)
+          ptr[idx] = byte_t(val >> (8 * idx));
+      }
+
+      uint32_t
+      Rotl32(uint32_t x, int n)
+      {
+        return (x << n) | (x >> (32 - n));
+      }
+
+      uint64_t
+      Rotr64(uint64_t x, int n)
+      {
+        return (x >> n) | (x << (64 - n));
+      }
+
+      void
+      QuarterRound(uint32_t* x, int a, int b, int c, int d)
+      {
+        x[a] += x[b];
+        x[d] = Rotl32(x[d] ^ x[a], 16);
+        x[c] += x[d];
+        x[b] = Rotl32(x[b] ^ x[c], 12);
+        x[a] += x[b];
+        x[d] = Rotl32(x[d] ^ x[a], 8);
+        x[c] += x[d];
+        x[b] = Rotl32(x[b] ^ x[c], 7);
+      }
+
+      void
+      ChaChaRounds(uint32_t* x)
+      {
+        for(int round = 0; round < 10; ++round)
+        {
+          QuarterRound(x, 0, 4, 8, 12);
+          QuarterRound(x, 1, 5, 9, 13);
+          QuarterRound(x, 2, 6, 10, 14);
+          QuarterRound(x, 3, 7, 11, 15);
+          QuarterRound(x, 0, 5, 10, 15);
+          QuarterRound(x, 1, 6, 11, 12);
+          QuarterRound(x, 2, 7, 8, 13);
+          QuarterRound(x, 3, 4, 9, 14);
+        }
+      }
+
+      void
+      XChaCha20(const CryptoBatchItem& item, const byte_t* key)
+      {
+        uint32_t state[16];
+        std::copy_n(ChaChaSigma, 4, state);
+        for(size_t idx = 0; idx < 8; ++idx)
+          state[4 + idx] = Load32(key + 4 * idx);
+        for(size_t idx = 0; idx < 4; ++idx)
+          state[12 + idx] = Load32(item.nonce + 4 * idx);
+        // hchacha20 derives the subkey from the first 16 bytes of nonce
+        ChaChaRounds(state);
+        std::copy_n(state + 12, 4, state + 8);
+        std::copy_n(state, 4, state + 4);
+        std::copy_n(ChaChaSigma, 4, state);
+        // 64 bit block counter then the last 8 bytes of nonce
+        state[12] = 0;
+        state[13] = 0;
+        state[14] = Load32(item.nonce + 16);
+        state[15] = Load32(item.nonce + 20);
+
+        byte_t* ptr = item.data;
+        size_t left = item.sz;
+        while(left)
+        {
+          uint32_t x[16];
+          std::copy_n(state, 16, x);
+          ChaChaRounds(x);
+          byte_t stream[ChaChaBlockSize];
+          for(size_t idx = 0; idx < 16; ++idx)
+            Store32(stream + 4 * idx, x[idx] + state[idx]);
+          const size_t sz = std::min(left, ChaChaBlockSize);
+          for(size_t idx = 0; idx < sz; ++idx)
+            ptr[idx] ^= stream[idx];
+          ptr += sz;
+          left -= sz;
+          if(++state[12] == 0)
+            ++state[13];
+        }
+      }
+
+      void
+      Blake2bCompress(uint64_t* h, const byte_t* block, uint64_t t, bool last)
+      {
+        uint64_t m[16];
+        uint64_t v[16];
+        for(size_t idx = 0; idx < 16; ++idx)
+          m[idx] = Load64(block + 8 * idx);
+        std::copy_n(h, 8, v);
+        std::copy_n(Blake2bIV, 8, v + 8);
+        v[12] ^= t;
+        if(last)
+          v[14] = ~v[14];
+        auto G = [&v, &m](const uint8_t* s, int a, int b, int c, int d,
+                          int i) {
+          v[a] = v[a] + v[b] + m[s[2 * i]];
+          v[d] = Rotr64(v[d] ^ v[a], 32);
+          v[c] = v[c] + v[d];
+          v[b] = Rotr64(v[b] ^ v[c], 24);
+          v[a] = v[a] + v[b] + m[s[2 * i + 1]];
+          v[d] = Rotr64(v[d] ^ v[a], 16);
+          v[c] = v[c] + v[d];
+          v[b] = Rotr64(v[b] ^ v[c], 63);
+        };
+        for(const auto& s : Blake2bSigma)
+        {
+          G(s, 0, 4, 8, 12, 0);
+          G(s, 1, 5, 9, 13, 1);
+          G(s, 2, 6, 10, 14, 2);
+          G(s, 3, 7, 11, 15, 3);
+          G(s, 0, 5, 10, 15, 4);
+          G(s, 1, 6, 11, 12, 5);
+          G(s, 2, 7, 8, 13, 6);
+          G(s, 3, 4, 9, 14, 7);
+        }
+        for(size_t idx = 0; idx < 8; ++idx)
+          h[idx] ^= v[idx] ^ v[idx + 8];
+      }
+
+      void
+      Blake2bKeyed(const CryptoBatchItem& item, const byte_t* key)
+      {
+        uint64_t h[8];
+        std::copy_n(Blake2bIV, 8, h);
+        h[0] ^= Blake2bParam;
+        // the key is hashed as a zero padded first block
+        byte_t block[Blake2bBlockSize] = {0};
+        std::copy_n(key, HMACSECSIZE, block);
+        uint64_t t = Blake2bBlockSize;
+        Blake2bCompress(h, block, t, item.sz == 0);
+        const byte_t* ptr = item.data;
+        size_t left       = item.sz;
+        while(left > Blake2bBlockSize)
+        {
+          t += Blake2bBlockSize;
+          Blake2bCompress(h, ptr, t, false);
+          ptr += Blake2bBlockSize;
+          left -= Blake2bBlockSize;
+        }
+        if(left)
+        {
+          std::fill_n(block, Blake2bBlockSize, 0);
+          std::copy_n(ptr, left, block);
+          t += left;
+          Blake2bCompress(h, block, t, true);
+        }
+        for(size_t idx = 0; idx < HMACSIZE; ++idx)
+          item.mac[idx] = byte_t(h[idx / 8] >> (8 * (idx % 8)));
+      }
+
+      Kernel
+      DetectBest()
+      {
+#ifdef LLARP_MULTIBUF_AVX2
+        __builtin_cpu_init();
+        if(__builtin_cpu_supports("avx2"))
+          return Kernel::AVX2;
+#endif
+        return Kernel::Scalar;
+      }
+    }  // namespace
+
+    Kernel
+    Best()
+    {
+      static const Kernel best = DetectBest();
+      return best;
+    }
+
+    const char*
+    KernelName(Kernel k)
+    {
+      switch(k)
+      {
+        case Kernel::AVX2:
+          return "avx2";
+        default:
+          return "scalar";
+      }
+    }
+
+    void
+    xchacha20(Kernel k, const CryptoBatchItem* items, size_t num,
+              const byte_t* key)
+    {
+#ifdef LLARP_MULTIBUF_AVX2
+      if(k == Kernel::AVX2)
+      {
+        avx2::xchacha20(items, num, key);
+        return;
+      }
+#endif
+      (void)k;
+      for(size_t idx = 0; idx < num; ++idx)
+        XChaCha20(items[idx], key);
+    }
+
+    void
+    hmac(Kernel k, const CryptoBatchItem* items, size_t num, const byte_t* key)
+    {
+#ifdef LLARP_MULTIBUF_AVX2
+      if(k == Kernel::AVX2)
+      {
+        avx2::hmac(items, num, key);
+        return;
+      }
+#endif
+      (void)k;
+      for(size_t idx = 0; idx < num; ++idx)
+        Blake2bKeyed(items[idx], key);
+    }
+  }  // namespace multibuf
+}  // namespace llarp
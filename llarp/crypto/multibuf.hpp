@@ -0,0 +1,79 @@
+#ifndef LLARP_CRYPTO_MULTIBUF_HPP
+#define LLARP_CRYPTO_MULTIBUF_HPP
+
+#include <crypto/crypto.hpp>
+
+#include <cstddef>
+
+#if(defined(__x86_64__) || defined(__i386__)) \
+    && (defined(__GNUC__) || defined(__clang__))
+#define LLARP_MULTIBUF_AVX2 1
+#endif
+
+namespace llarp
+{
+  /// multi-buffer xchacha20 and keyed blake2b-256
+  ///
+  /// every buffer in a batch shares one 32 byte key, like all the packets of
+  /// one iwp session do. the simd kernels give each buffer its own vector
+  /// lane, so a batch of short packets keeps the vector units busy where a
+  /// one buffer at a time implementation spends most of its time in per
+  /// call setup. output is bit for bit what libsodium's
+  /// crypto_stream_xchacha20_xor and crypto_generichash_blake2b produce.
+  namespace multibuf
+  {
+    enum class Kernel
+    {
+      Scalar,
+      AVX2
+    };
+
+    /// fastest kernel the cpu we run on supports
+    Kernel
+    Best();
+
+    const char*
+    KernelName(Kernel k);
+
+    /// xor each item's data with the xchacha20 keystream for its nonce
+    void
+    xchacha20(Kernel k, const CryptoBatchItem* items, size_t num,
+              const byte_t* key);
+
+    /// write the keyed blake2b-256 of each item's data to its mac
+    void
+    hmac(Kernel k, const CryptoBatchItem* items, size_t num,
+         const byte_t* key);
+
+    namespace detail
+    {
+      /// "expand 32-byte k"
+      extern const uint32_t ChaChaSigma[4];
+      extern const uint64_t Blake2bIV[8];
+      extern const uint8_t Blake2bSigma[12][16];
+      /// blake2b parameter block word 0 for a 32 byte key and digest
+      static constexpr uint64_t Blake2bParam =
+          0x01010000UL ^ (HMACSECSIZE << 8) ^ HMACSIZE;
+      static constexpr size_t Blake2bBlockSize = 128;
+      static constexpr size_t ChaChaBlockSize  = 64;
+    }  // namespace detail
+
+#ifdef LLARP_MULTIBUF_AVX2
+    namespace avx2
+    {
+      /// buffers per chacha20 pass
+      static constexpr size_t ChaChaLanes = 8;
+      /// buffers per blake2b pass
+      static constexpr size_t BlakeLanes = 4;
+
+      void
+      xchacha20(const CryptoBatchItem* items, size_t num, const byte_t* key);
+
+      void
+      hmac(const CryptoBatchItem* items, size_t num, const byte_t* key);
+    }  // namespace avx2
+#endif
+  }  // namespace multibuf
+}  // namespace llarp
+
+#endif
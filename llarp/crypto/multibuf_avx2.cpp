@@ -0,0 +1,382 @@
+#include <crypto/multibuf.hpp>
+
+#ifdef LLARP_MULTIBUF_AVX2
+#include <immintrin.h>
+
+#include <algorithm>
+#include <cstring>
+
+// compiled for avx2 per function so the rest of the tree keeps its baseline
+// target, only called after multibuf::Best() found avx2 on the cpu
+#define LLARP_AVX2 __attribute__((target("avx2")))
+
+namespace llarp
+{
+  namespace multibuf
+  {
+    namespace avx2
+    {
+      namespace
+      {
+        using namespace detail;
+
+        /// the buffers of one pass, one per lane
+        struct Group
+        {
+          const CryptoBatchItem* items;
+          size_t num;
+
+          size_t
+          Size(size_t lane) const
+          {
+            return lane < num ? items[lane].sz : 0;
+          }
+        };
+
+        template < int N >
+        LLARP_AVX2 inline __m256i
+        Rotl32(__m256i x)
+        {
+          return _mm256_or_si256(_mm256_slli_epi32(x, N),
+                                 _mm256_srli_epi32(x, 32 - N));
+        }
+
+        LLARP_AVX2 inline __m256i
+        Rotl32_16(__m256i x)
+        {
+          const __m256i mask = _mm256_setr_epi8(
+              2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13, 2, 3, 0, 1,
+              6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13);
+          return _mm256_shuffle_epi8(x, mask);
+        }
+
+        LLARP_AVX2 inline __m256i
+        Rotl32_8(__m256i x)
+        {
+          const __m256i mask = _mm256_setr_epi8(
+              3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14, 3, 0, 1, 2,
+              7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14);
+          return _mm256_shuffle_epi8(x, mask);
+        }
+
+        LLARP_AVX2 inline void
+        QuarterRound(__m256i& a, __m256i& b, __m256i& c, __m256i& d)
+        {
+          a = _mm256_add_epi32(a, b);
+          d = Rotl32_16(_mm256_xor_si256(d, a));
+          c = _mm256_add_epi32(c, d);
+          b = Rotl32< 12 >(_mm256_xor_si256(b, c));
+          a = _mm256_add_epi32(a, b);
+          d = Rotl32_8(_mm256_xor_si256(d, a));
+          c = _mm256_add_epi32(c, d);
+          b = Rotl32< 7 >(_mm256_xor_si256(b, c));
+        }
+
+        LLARP_AVX2 inline void
+        ChaChaRounds(__m256i* x)
+        {
+          for(int round = 0; round < 10; ++round)
+          {
+            QuarterRound(x[0], x[4], x[8], x[12]);
+            QuarterRound(x[1], x[5], x[9], x[13]);
+            QuarterRound(x[2], x[6], x[10], x[14]);
+            QuarterRound(x[3], x[7], x[11], x[15]);
+            QuarterRound(x[0], x[5], x[10], x[15]);
+            QuarterRound(x[1], x[6], x[11], x[12]);
+            QuarterRound(x[2], x[7], x[8], x[13]);
+            QuarterRound(x[3], x[4], x[9], x[14]);
+          }
+        }
+
+        /// turn 8 vectors of one state word per lane into 8 vectors of 8
+        /// consecutive state words of one lane each
+        LLARP_AVX2 inline void
+        Transpose8x8(const __m256i* in, __m256i* out)
+        {
+          const __m256i t0 = _mm256_unpacklo_epi32(in[0], in[1]);
+          const __m256i t1 = _mm256_unpackhi_epi32(in[0], in[1]);
+          const __m256i t2 = _mm256_unpacklo_epi32(in[2], in[3]);
+          const __m256i t3 = _mm256_unpackhi_epi32(in[2], in[3]);
+          const __m256i t4 = _mm256_unpacklo_epi32(in[4], in[5]);
+          const __m256i t5 = _mm256_unpackhi_epi32(in[4], in[5]);
+          const __m256i t6 = _mm256_unpacklo_epi32(in[6], in[7]);
+          const __m256i t7 = _mm256_unpackhi_epi32(in[6], in[7]);
+          const __m256i u0 = _mm256_unpacklo_epi64(t0, t2);
+          const __m256i u1 = _mm256_unpackhi_epi64(t0, t2);
+          const __m256i u2 = _mm256_unpacklo_epi64(t1, t3);
+          const __m256i u3 = _mm256_unpackhi_epi64(t1, t3);
+          const __m256i u4 = _mm256_unpacklo_epi64(t4, t6);
+          const __m256i u5 = _mm256_unpackhi_epi64(t4, t6);
+          const __m256i u6 = _mm256_unpacklo_epi64(t5, t7);
+          const __m256i u7 = _mm256_unpackhi_epi64(t5, t7);
+          out[0] = _mm256_permute2x128_si256(u0, u4, 0x20);
+          out[1] = _mm256_permute2x128_si256(u1, u5, 0x20);
+          out[2] = _mm256_permute2x128_si256(u2, u6, 0x20);
+          out[3] = _mm256_permute2x128_si256(u3, u7, 0x20);
+          out[4] = _mm256_permute2x128_si256(u0, u4, 0x31);
+          out[5] = _mm256_permute2x128_si256(u1, u5, 0x31);
+          out[6] = _mm256_permute2x128_si256(u2, u6, 0x31);
+          out[7] = _mm256_permute2x128_si256(u3, u7, 0x31);
+        }
+
+        /// load the 32 bit nonce word at offset off of every lane
+        LLARP_AVX2 inline __m256i
+        NonceWord(const Group& group, size_t off)
+        {
+          alignas(32) uint32_t words[ChaChaLanes] = {0};
+          for(size_t lane = 0; lane < group.num; ++lane)
+            std::memcpy(&words[lane], group.items[lane].nonce + off, 4);
+          return _mm256_load_si256(reinterpret_cast< const __m256i* >(words));
+        }
+
+        LLARP_AVX2 void
+        XChaCha20Group(const Group& group, const byte_t* key)
+        {
+          __m256i state[16];
+          for(size_t idx = 0; idx < 4; ++idx)
+            state[idx] = _mm256_set1_epi32(ChaChaSigma[idx]);
+          for(size_t idx = 0; idx < 8; ++idx)
+          {
+            uint32_t word;
+            std::memcpy(&word, key + 4 * idx, 4);
+            state[4 + idx] = _mm256_set1_epi32(word);
+          }
+          for(size_t idx = 0; idx < 4; ++idx)
+            state[12 + idx] = NonceWord(group, 4 * idx);
+          // hchacha20 for all lanes at once, the subkeys stay in their lanes
+          ChaChaRounds(state);
+          std::copy_n(state + 12, 4, state + 8);
+          std::copy_n(state, 4, state + 4);
+          for(size_t idx = 0; idx < 4; ++idx)
+            state[idx] = _mm256_set1_epi32(ChaChaSigma[idx]);
+          state[14] = NonceWord(group, 16);
+          state[15] = NonceWord(group, 20);
+
+          size_t blocks = 0;
+          for(size_t lane = 0; lane < group.num; ++lane)
+            blocks = std::max(blocks, (group.Size(lane) + ChaChaBlockSize - 1)
+                                  / ChaChaBlockSize);
+          // all lanes step through their blocks together
+          for(uint64_t block = 0; block < blocks; ++block)
+          {
+            state[12] = _mm256_set1_epi32(uint32_t(block));
+            state[13] = _mm256_set1_epi32(uint32_t(block >> 32));
+            __m256i x[16];
+            std::copy_n(state, 16, x);
+            ChaChaRounds(x);
+            for(size_t idx = 0; idx < 16; ++idx)
+              x[idx] = _mm256_add_epi32(x[idx], state[idx]);
+            __m256i lo[ChaChaLanes];
+            __m256i hi[ChaChaLanes];
+            Transpose8x8(x, lo);
+            Transpose8x8(x + 8, hi);
+
+            const size_t off = block * ChaChaBlockSize;
+            for(size_t lane = 0; lane < group.num; ++lane)
+            {
+              const size_t sz = group.Size(lane);
+              if(off >= sz)
+                continue;
+              byte_t* ptr = group.items[lane].data + off;
+              if(sz - off >= ChaChaBlockSize)
+              {
+                auto* vec = reinterpret_cast< __m256i* >(ptr);
+                _mm256_storeu_si256(
+                    vec, _mm256_xor_si256(_mm256_loadu_si256(vec), lo[lane]));
+                _mm256_storeu_si256(
+                    vec + 1,
+                    _mm256_xor_si256(_mm256_loadu_si256(vec + 1), hi[lane]));
+              }
+              else
+              {
+                alignas(32) byte_t stream[ChaChaBlockSize];
+                _mm256_store_si256(reinterpret_cast< __m256i* >(stream),
+                                   lo[lane]);
+                _mm256_store_si256(reinterpret_cast< __m256i* >(stream + 32),
+                                   hi[lane]);
+                for(size_t idx = 0; idx < sz - off; ++idx)
+                  ptr[idx] ^= stream[idx];
+              }
+            }
+          }
+        }
+
+        LLARP_AVX2 inline __m256i
+        Rotr64_32(__m256i x)
+        {
+          return _mm256_shuffle_epi32(x, _MM_SHUFFLE(2, 3, 0, 1));
+        }
+
+        LLARP_AVX2 inline __m256i
+        Rotr64_24(__m256i x)
+        {
+          const __m256i mask = _mm256_setr_epi8(
+              3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10, 3, 4, 5, 6,
+              7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10);
+          return _mm256_shuffle_epi8(x, mask);
+        }
+
+        LLARP_AVX2 inline __m256i
+        Rotr64_16(__m256i x)
+        {
+          const __m256i mask = _mm256_setr_epi8(
+              2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9, 2, 3, 4, 5,
+              6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9);
+          return _mm256_shuffle_epi8(x, mask);
+        }
+
+        LLARP_AVX2 inline __m256i
+        Rotr64_63(__m256i x)
+        {
+          return _mm256_xor_si256(_mm256_srli_epi64(x, 63),
+                                  _mm256_add_epi64(x, x));
+        }
+
+        LLARP_AVX2 inline void
+        G(__m256i* v, const __m256i* m, const uint8_t* s, int a, int b, int c,
+          int d, int i)
+        {
+          v[a] = _mm256_add_epi64(_mm256_add_epi64(v[a], v[b]), m[s[2 * i]]);
+          v[d] = Rotr64_32(_mm256_xor_si256(v[d], v[a]));
+          v[c] = _mm256_add_epi64(v[c], v[d]);
+          v[b] = Rotr64_24(_mm256_xor_si256(v[b], v[c]));
+          v[a] =
+              _mm256_add_epi64(_mm256_add_epi64(v[a], v[b]), m[s[2 * i + 1]]);
+          v[d] = Rotr64_16(_mm256_xor_si256(v[d], v[a]));
+          v[c] = _mm256_add_epi64(v[c], v[d]);
+          v[b] = Rotr64_63(_mm256_xor_si256(v[b], v[c]));
+        }
+
+        LLARP_AVX2 inline __m256i
+        LaneWords(const uint64_t* words)
+        {
+          return _mm256_loadu_si256(reinterpret_cast< const __m256i* >(words));
+        }
+
+        LLARP_AVX2 void
+        Blake2bGroup(const Group& group, const byte_t* key)
+        {
+          byte_t keyBlock[Blake2bBlockSize] = {0};
+          std::copy_n(key, HMACSECSIZE, keyBlock);
+          const byte_t zeroBlock[Blake2bBlockSize] = {0};
+
+          // compressions per lane, the key block counts as one
+          size_t count[BlakeLanes];
+          size_t steps = 0;
+          for(size_t lane = 0; lane < BlakeLanes; ++lane)
+          {
+            count[lane] = 1
+                + (group.Size(lane) + Blake2bBlockSize - 1) / Blake2bBlockSize;
+            if(lane < group.num)
+              steps = std::max(steps, count[lane]);
+          }
+
+          __m256i h[8];
+          for(size_t idx = 0; idx < 8; ++idx)
+            h[idx] = _mm256_set1_epi64x(Blake2bIV[idx]);
+          h[0] = _mm256_xor_si256(h[0], _mm256_set1_epi64x(Blake2bParam));
+
+          for(size_t step = 0; step < steps; ++step)
+          {
+            const byte_t* blocks[BlakeLanes];
+            alignas(32) byte_t tail[BlakeLanes][Blake2bBlockSize];
+            alignas(32) uint64_t t[BlakeLanes];
+            alignas(32) uint64_t f[BlakeLanes];
+            alignas(32) uint64_t active[BlakeLanes];
+            for(size_t lane = 0; lane < BlakeLanes; ++lane)
+            {
+              const size_t sz = group.Size(lane);
+              const bool last = step + 1 == count[lane];
+              active[lane] = lane < group.num && step < count[lane] ? ~0ULL : 0;
+              f[lane]      = last ? ~0ULL : 0;
+              t[lane]      = last ? Blake2bBlockSize + sz
+                                  : Blake2bBlockSize * (step + 1);
+              if(not active[lane])
+                blocks[lane] = zeroBlock;
+              else if(step == 0)
+                blocks[lane] = keyBlock;
+              else
+              {
+                const size_t off = (step - 1) * Blake2bBlockSize;
+                blocks[lane]     = group.items[lane].data + off;
+                if(sz - off < Blake2bBlockSize)
+                {
+                  std::fill_n(tail[lane], Blake2bBlockSize, 0);
+                  std::copy_n(blocks[lane], sz - off, tail[lane]);
+                  blocks[lane] = tail[lane];
+                }
+              }
+            }
+
+            __m256i m[16];
+            for(size_t idx = 0; idx < 16; ++idx)
+            {
+              alignas(32) uint64_t words[BlakeLanes];
+              for(size_t lane = 0; lane < BlakeLanes; ++lane)
+                std::memcpy(&words[lane], blocks[lane] + 8 * idx, 8);
+              m[idx] = LaneWords(words);
+            }
+
+            __m256i v[16];
+            std::copy_n(h, 8, v);
+            for(size_t idx = 0; idx < 8; ++idx)
+              v[8 + idx] = _mm256_set1_epi64x(Blake2bIV[idx]);
+            v[12] = _mm256_xor_si256(v[12], LaneWords(t));
+            v[14] = _mm256_xor_si256(v[14], LaneWords(f));
+
+            for(const auto& s : Blake2bSigma)
+            {
+              G(v, m, s, 0, 4, 8, 12, 0);
+              G(v, m, s, 1, 5, 9, 13, 1);
+              G(v, m, s, 2, 6, 10, 14, 2);
+              G(v, m, s, 3, 7, 11, 15, 3);
+              G(v, m, s, 0, 5, 10, 15, 4);
+              G(v, m, s, 1, 6, 11, 12, 5);
+              G(v, m, s, 2, 7, 8, 13, 6);
+              G(v, m, s, 3, 4, 9, 14, 7);
+            }
+
+            // lanes that are already done keep their state
+            const __m256i mask = LaneWords(active);
+            for(size_t idx = 0; idx < 8; ++idx)
+            {
+              const __m256i next = _mm256_xor_si256(
+                  h[idx], _mm256_xor_si256(v[idx], v[idx + 8]));
+              h[idx] = _mm256_blendv_epi8(h[idx], next, mask);
+            }
+          }
+
+          alignas(32) uint64_t out[HMACSIZE / 8][BlakeLanes];
+          for(size_t idx = 0; idx < HMACSIZE / 8; ++idx)
+            _mm256_store_si256(reinterpret_cast< __m256i* >(out[idx]), h[idx]);
+          for(size_t lane = 0; lane < group.num; ++lane)
+          {
+            for(size_t idx = 0; idx < HMACSIZE / 8; ++idx)
+              std::memcpy(group.items[lane].mac + 8 * idx, &out[idx][lane], 8);
+          }
+        }
+      }  // namespace
+
+      void
+      xchacha20(const CryptoBatchItem* items, size_t num, const byte_t* key)
+      {
+        for(size_t idx = 0; idx < num; idx += ChaChaLanes)
+        {
+          const Group group{items + idx, std::min(ChaChaLanes, num - idx)};
+          XChaCha20Group(group, key);
+        }
+      }
+
+      void
+      hmac(const CryptoBatchItem* items, size_t num, const byte_t* key)
+      {
+        for(size_t idx = 0; idx < num; idx += BlakeLanes)
+        {
+          const Group group{items + idx, std::min(BlakeLanes, num - idx)};
+          Blake2bGroup(group, key);
+        }
+      }
+    }  // namespace avx2
+  }  // namespace multibuf
+}  // namespace llarp
+#endif
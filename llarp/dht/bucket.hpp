@@ -3,9 +3,11 @@
 
 #include <dht/kademlia.hpp>
 #include <dht/key.hpp>
+#include <dht/sorted_closest.hpp>
 #include <util/status.hpp>
 
-#include <map>
+#include <algorithm>
+#include <functional>
 #include <set>
 #include <vector>
 
@@ -13,14 +15,18 @@ namespace llarp
 {
   namespace dht
   {
+    /// kademlia bucket of nodes kept in flat arrays sorted by xor distance
+    /// from us
+    ///
+    /// lookups are binary searches over the contiguous distances, closest
+    /// queries split that sorted run bit by bit and random picks index the
+    /// array directly, so none of them walk every node or allocate.
     template < typename Val_t >
     struct Bucket
     {
-      using BucketStorage_t = std::map< Key_t, Val_t, XorMetric >;
-      using Random_t        = std::function< uint64_t() >;
+      using Random_t = std::function< uint64_t() >;
 
-      Bucket(const Key_t& us, Random_t r)
-          : nodes(XorMetric(us)), random(std::move(r))
+      Bucket(const Key_t& us, Random_t r) : random(std::move(r)), m_Us(us)
       {
       }
 
@@ -28,9 +34,9 @@ namespace llarp
       ExtractStatus() const
       {
         util::StatusObject obj{};
-        for(const auto& item : nodes)
+        for(const auto& node : m_Nodes)
         {
-          obj[item.first.ToString()] = item.second.ExtractStatus();
+          obj[node.ID.ToString()] = node.ExtractStatus();
         }
         return obj;
       }
@@ -38,84 +44,74 @@ namespace llarp
       size_t
       size() const
       {
-        return nodes.size();
+        return m_Nodes.size();
       }
 
-      struct SetIntersector
-      {
-        bool
-        operator()(const typename BucketStorage_t::value_type& lhs,
-                   const Key_t& rhs)
-        {
-          return lhs.first < rhs;
-        }
-
-        bool
-        operator()(const Key_t& lhs,
-                   const typename BucketStorage_t::value_type& rhs)
-        {
-          return lhs < rhs.first;
-        }
-      };
-
       bool
       GetRandomNodeExcluding(Key_t& result,
                              const std::set< Key_t >& exclude) const
       {
-        std::vector< typename BucketStorage_t::value_type > candidates;
-        std::set_difference(nodes.begin(), nodes.end(), exclude.begin(),
-                            exclude.end(), std::back_inserter(candidates),
-                            SetIntersector());
-
-        if(candidates.empty())
+        static constexpr size_t RandomPicks = 16;
+        const size_t sz                     = m_Nodes.size();
+        if(sz == 0)
+          return false;
+        // cheap as long as exclude covers only a small part of us
+        for(size_t tries = 0; tries < RandomPicks; ++tries)
         {
+          const Key_t& key = m_Nodes[random() % sz].ID;
+          if(exclude.count(key) == 0)
+          {
+            result = key;
+            return true;
+          }
+        }
+        size_t excluded = 0;
+        for(const auto& key : exclude)
+          excluded += HasNode(key);
+        if(excluded == sz)
           return false;
+        size_t nth = random() % (sz - excluded);
+        for(const auto& node : m_Nodes)
+        {
+          if(exclude.count(node.ID))
+            continue;
+          if(nth-- == 0)
+          {
+            result = node.ID;
+            return true;
+          }
         }
-        result = candidates[random() % candidates.size()].first;
-        return true;
+        return false;
       }
 
       bool
       FindClosest(const Key_t& target, Key_t& result) const
       {
-        Key_t mindist;
-        mindist.Fill(0xff);
-        for(const auto& item : nodes)
-        {
-          auto curDist = item.first ^ target;
-          if(curDist < mindist)
-          {
-            mindist = curDist;
-            result  = item.first;
-          }
-        }
-        return nodes.size() > 0;
+        return FindCloseExcluding(target, result, {});
       }
 
       bool
       GetManyRandom(std::set< Key_t >& result, size_t N) const
       {
-        if(nodes.size() < N || nodes.empty())
+        if(m_Nodes.size() < N || m_Nodes.empty())
         {
-          llarp::LogWarn("Not enough dht nodes, have ", nodes.size(), " want ",
-                         N);
+          llarp::LogWarn("Not enough dht nodes, have ", m_Nodes.size(),
+                         " want ", N);
           return false;
         }
-        if(nodes.size() == N)
+        if(m_Nodes.size() == N)
         {
-          std::transform(nodes.begin(), nodes.end(),
+          std::transform(m_Nodes.begin(), m_Nodes.end(),
                          std::inserter(result, result.end()),
-                         [](const auto& a) { return a.first; });
+                         [](const auto& a) { return a.ID; });
 
           return true;
         }
         size_t expecting = N;
-        size_t sz        = nodes.size();
+        size_t sz        = m_Nodes.size();
         while(N)
         {
-          auto itr = nodes.begin();
-          std::advance(itr, random() % sz);
-          if(result.insert(itr->first).second)
+          if(result.insert(m_Nodes[random() % sz].ID).second)
           {
             --N;
           }
@@ -127,70 +123,94 @@ namespace llarp
       FindCloseExcluding(const Key_t& target, Key_t& result,
                          const std::set< Key_t >& exclude) const
       {
-        Key_t maxdist;
-        maxdist.Fill(0xff);
-        Key_t mindist;
-        mindist.Fill(0xff);
-        for(const auto& item : nodes)
-        {
-          if(exclude.count(item.first))
-          {
-            continue;
-          }
-
-          auto curDist = item.first ^ target;
-          if(curDist < mindist)
-          {
-            mindist = curDist;
-            result  = item.first;
-          }
-        }
-        return mindist < maxdist;
+        bool found = false;
+        VisitClosest(target, [&](const Val_t& node) -> bool {
+          if(exclude.count(node.ID))
+            return true;
+          result = node.ID;
+          found  = true;
+          return false;
+        });
+        return found;
       }
 
       bool
       GetManyNearExcluding(const Key_t& target, std::set< Key_t >& result,
                            size_t N, const std::set< Key_t >& exclude) const
       {
-        std::set< Key_t > s(exclude.begin(), exclude.end());
-
-        Key_t peer;
-        while(N--)
-        {
-          if(!FindCloseExcluding(target, peer, s))
-          {
+        VisitClosest(target, [&](const Val_t& node) -> bool {
+          if(N == 0)
             return false;
+          if(exclude.count(node.ID) == 0)
+          {
+            result.insert(node.ID);
+            --N;
           }
-          s.insert(peer);
-          result.insert(peer);
-        }
-        return true;
+          return true;
+        });
+        return N == 0;
+      }
+
+      /// call visit on nodes closest to target first until it returns false
+      template < typename Visit_t >
+      void
+      VisitClosest(const Key_t& target, Visit_t visit) const
+      {
+        // distance to target is distance from us xor the distance between
+        // us and target, so the sorted distances work as keys
+        VisitSortedClosest(m_Dists.begin(), m_Dists.end(), target ^ m_Us,
+                           [](const Key_t& dist) -> const Key_t& {
+                             return dist;
+                           },
+                           [&](auto itr) -> bool {
+                             return visit(m_Nodes[itr - m_Dists.begin()]);
+                           });
       }
 
       void
       PutNode(const Val_t& val)
       {
-        auto itr = nodes.find(val.ID);
-        if(itr == nodes.end() || itr->second < val)
+        const Key_t dist = val.ID ^ m_Us;
+        const auto itr   = LowerBound(dist);
+        const auto pos   = itr - m_Dists.cbegin();
+        if(itr == m_Dists.cend() || *itr != dist)
         {
-          nodes[val.ID] = val;
+          m_Dists.insert(itr, dist);
+          m_Nodes.insert(m_Nodes.begin() + pos, val);
+        }
+        else if(m_Nodes[pos] < val)
+        {
+          m_Nodes[pos] = val;
         }
       }
 
       void
       DelNode(const Key_t& key)
       {
-        auto itr = nodes.find(key);
-        if(itr != nodes.end())
+        const Key_t dist = key ^ m_Us;
+        const auto itr   = LowerBound(dist);
+        if(itr != m_Dists.cend() && *itr == dist)
         {
-          nodes.erase(itr);
+          m_Nodes.erase(m_Nodes.begin() + (itr - m_Dists.cbegin()));
+          m_Dists.erase(itr);
         }
       }
 
       bool
       HasNode(const Key_t& key) const
       {
-        return nodes.find(key) != nodes.end();
+        return std::binary_search(m_Dists.begin(), m_Dists.end(), key ^ m_Us);
+      }
+
+      /// the node with key or nullptr if we do not have it
+      const Val_t*
+      GetNode(const Key_t& key) const
+      {
+        const Key_t dist = key ^ m_Us;
+        const auto itr   = LowerBound(dist);
+        if(itr == m_Dists.cend() || *itr != dist)
+          return nullptr;
+        return &m_Nodes[itr - m_Dists.cbegin()];
       }
 
       // remove all nodes who's key matches a predicate
@@ -198,34 +218,62 @@ namespace llarp
       void
       RemoveIf(Predicate pred)
       {
-        auto itr = nodes.begin();
-        while(itr != nodes.end())
+        RemoveNodesIf([&pred](const Val_t& node) { return pred(node.ID); });
+      }
+
+      // remove all nodes matching a predicate
+      template < typename Predicate >
+      void
+      RemoveNodesIf(Predicate pred)
+      {
+        size_t keep = 0;
+        for(size_t idx = 0; idx < m_Nodes.size(); ++idx)
         {
-          if(pred(itr->first))
-            itr = nodes.erase(itr);
-          else
-            ++itr;
+          if(pred(m_Nodes[idx]))
+            continue;
+          if(keep != idx)
+          {
+            m_Nodes[keep] = std::move(m_Nodes[idx]);
+            m_Dists[keep] = m_Dists[idx];
+          }
+          ++keep;
         }
+        m_Nodes.resize(keep);
+        m_Dists.resize(keep);
       }
 
       template < typename Visit_t >
       void
       ForEachNode(Visit_t visit)
       {
-        for(const auto& item : nodes)
+        for(const auto& node : m_Nodes)
         {
-          visit(item.second);
+          visit(node);
         }
       }
 
       void
       Clear()
       {
-        nodes.clear();
+        m_Nodes.clear();
+        m_Dists.clear();
       }
 
-      BucketStorage_t nodes;
       Random_t random;
+
+     private:
+      /// where the node dist from us is or would go
+      typename std::vector< Key_t >::const_iterator
+      LowerBound(const Key_t& dist) const
+      {
+        return std::lower_bound(m_Dists.cbegin(), m_Dists.cend(), dist);
+      }
+
+      Key_t m_Us;
+      /// xor distances of the nodes from us, sorted
+      std::vector< Key_t > m_Dists;
+      /// the nodes in the same order as m_Dists
+      std::vector< Val_t > m_Nodes;
     };
   }  // namespace dht
 }  // namespace llarp
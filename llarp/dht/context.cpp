@@ -4,6 +4,7 @@
 #include <dht/localrouterlookup.hpp>
 #include <dht/localserviceaddresslookup.hpp>
 #include <dht/localtaglookup.hpp>
+#include <dht/lookup_cache.hpp>
 #include <dht/messages/findrouter.hpp>
 #include <dht/messages/gotintro.hpp>
 #include <dht/messages/gotrouter.hpp>
@@ -65,16 +66,7 @@ namespace llarp
                             RouterLookupHandler result = nullptr) override;
 
       bool
-      LookupRouter(const RouterID& target, RouterLookupHandler result) override
-      {
-        Key_t askpeer;
-        if(!_nodes->FindClosest(Key_t(target), askpeer))
-        {
-          return false;
-        }
-        LookupRouterRecursive(target, OurKey(), 0, askpeer, result);
-        return true;
-      }
+      LookupRouter(const RouterID& target, RouterLookupHandler result) override;
 
       bool
       HasRouterLookup(const RouterID& target) const override
@@ -268,8 +260,25 @@ namespace llarp
       void
       CleanupTX();
 
+      /// ask all of askpeers for target at once on behalf of whoasked
+      void
+      LookupRouterVia(const RouterID& target, const TXOwner& whoasked,
+                      const std::set< Key_t >& askpeers,
+                      RouterLookupHandler handler);
+
+      /// handler that remembers what a lookup for addr found, then calls
+      /// handler
+      service::EncryptedIntroSetLookupHandler
+      CacheIntroSets(const Key_t& addr,
+                     service::EncryptedIntroSetLookupHandler handler);
+
       uint64_t ids;
 
+      /// answers to our recent router and introset lookups
+      LookupCache< RouterID, RouterContact > _routerCache{1min, 1024};
+      LookupCache< Key_t, service::EncryptedIntroSet > _introsetCache{30s,
+                                                                      1024};
+
       Key_t ourKey;
     };
 
@@ -316,17 +325,9 @@ namespace llarp
       if(_services)
       {
         // expire intro sets
-        auto& nodes = _services->nodes;
-        auto itr    = nodes.begin();
-        while(itr != nodes.end())
-        {
-          if(itr->second.introset.IsExpired(now))
-          {
-            itr = nodes.erase(itr);
-          }
-          else
-            ++itr;
-        }
+        _services->RemoveNodesIf([now](const ISNode& node) {
+          return node.introset.IsExpired(now);
+        });
       }
       ScheduleCleanupTimer();
     }
@@ -349,6 +350,14 @@ namespace llarp
         replies.emplace_back(new GotRouterMessage(requester, txid, {}, false));
         return;
       }
+      const auto cached = _routerCache.Get(target.as_array(), Now());
+      if(cached.has_value())
+      {
+        // someone looked it up through us a moment ago
+        replies.emplace_back(
+            new GotRouterMessage(requester, txid, {cached.value()}, false));
+        return;
+      }
       const auto rc = GetRouter()->nodedb()->FindClosestTo(target);
       const Key_t next(rc.pubkey);
       {
@@ -395,10 +404,10 @@ namespace llarp
     nonstd::optional< llarp::service::EncryptedIntroSet >
     Context::GetIntroSetByLocation(const Key_t& key) const
     {
-      auto itr = _services->nodes.find(key);
-      if(itr == _services->nodes.end())
+      const ISNode* node = _services->GetNode(key);
+      if(node == nullptr)
         return {};
-      return itr->second.introset;
+      return node->introset;
     }
 
     void
@@ -410,6 +419,8 @@ namespace llarp
       pendingRouterLookups().Expire(now);
       _pendingIntrosetLookups.Expire(now);
       pendingExploreLookups().Expire(now);
+      _routerCache.Expire(now);
+      _introsetCache.Expire(now);
     }
 
     util::StatusObject
@@ -482,11 +493,21 @@ namespace llarp
                                    const Key_t& askpeer, uint64_t relayOrder)
     {
       const TXOwner asker(OurKey(), txid);
+      auto lookup = std::make_unique< LocalServiceAddressLookup >(
+          path, txid, relayOrder, addr, this, askpeer);
+      const auto cached = _introsetCache.Get(addr, Now());
+      if(cached.has_value() && not cached->IsExpired(Now()))
+      {
+        lookup->valuesFound.emplace_back(cached.value());
+        lookup->SendReply();
+        return;
+      }
+      lookup->handleResult = CacheIntroSets(addr, nullptr);
+      // only the router the client picked: clients already spread their
+      // lookups over the storing routers with relayOrder, fanning out here
+      // as well would multiply every lookup on the network
       const TXOwner peer(askpeer, ++ids);
-      _pendingIntrosetLookups.NewTX(
-          peer, asker, asker,
-          new LocalServiceAddressLookup(path, txid, relayOrder, addr, this,
-                                        askpeer));
+      _pendingIntrosetLookups.NewTX(peer, asker, asker, lookup.release());
     }
 
     void
@@ -524,7 +545,8 @@ namespace llarp
       const TXOwner peer(askpeer, ++ids);
       _pendingIntrosetLookups.NewTX(
           peer, asker, asker,
-          new ServiceAddressLookup(asker, addr, this, relayOrder, handler));
+          new ServiceAddressLookup(asker, addr, this, relayOrder,
+                                   CacheIntroSets(addr, handler)));
     }
 
     void
@@ -536,7 +558,22 @@ namespace llarp
       const TXOwner peer(askpeer, ++ids);
       _pendingIntrosetLookups.NewTX(
           peer, asker, asker,
-          new ServiceAddressLookup(asker, addr, this, 0, handler), 1s);
+          new ServiceAddressLookup(asker, addr, this, 0,
+                                   CacheIntroSets(addr, handler)),
+          1s);
+    }
+
+    service::EncryptedIntroSetLookupHandler
+    Context::CacheIntroSets(const Key_t& addr,
+                            service::EncryptedIntroSetLookupHandler handler)
+    {
+      return [this, addr, handler](
+                 const std::vector< service::EncryptedIntroSet >& found) {
+        if(not found.empty())
+          _introsetCache.Put(addr, found.front(), Now());
+        if(handler)
+          handler(found);
+      };
     }
 
     bool
@@ -604,11 +641,51 @@ namespace llarp
                                    const Key_t& askpeer,
                                    RouterLookupHandler handler)
     {
-      const TXOwner asker(whoasked, txid);
-      const TXOwner peer(askpeer, ++ids);
+      LookupRouterVia(target, TXOwner{whoasked, txid}, {askpeer}, handler);
+    }
+
+    bool
+    Context::LookupRouter(const RouterID& target, RouterLookupHandler result)
+    {
+      const auto cached = _routerCache.Get(target, Now());
+      if(cached.has_value())
+      {
+        if(result)
+        {
+          const std::vector< RouterContact > found{cached.value()};
+          LogicCall(router->logic(), [result, found]() { result(found); });
+        }
+        return true;
+      }
+      std::set< Key_t > askpeers;
+      _nodes->GetManyNearExcluding(Key_t(target), askpeers, LookupAlpha, {});
+      if(askpeers.empty())
+      {
+        return false;
+      }
+      LookupRouterVia(target, TXOwner{OurKey(), 0}, askpeers, result);
+      return true;
+    }
+
+    void
+    Context::LookupRouterVia(const RouterID& target, const TXOwner& whoasked,
+                             const std::set< Key_t >& askpeers,
+                             RouterLookupHandler handler)
+    {
+      std::vector< TXOwner > peers;
+      for(const auto& askpeer : askpeers)
+        peers.emplace_back(askpeer, ++ids);
+      auto cacheResult = [this, target, handler](
+                             const std::vector< RouterContact >& found) {
+        // the reply holds a blank rc when none of the found ones were good
+        if(not found.empty() && RouterID(found.front().pubkey) == target)
+          _routerCache.Put(target, found.front(), Now());
+        if(handler)
+          handler(found);
+      };
       _pendingRouterLookups.NewTX(
-          peer, asker, target,
-          new RecursiveRouterLookup(asker, target, this, handler));
+          peers, whoasked, target,
+          new RecursiveRouterLookup(whoasked, target, this, cacheResult));
     }
 
     llarp_time_t
@@ -32,6 +32,9 @@ namespace llarp
     static constexpr size_t IntroSetStorageRedundancy =
         (IntroSetRelayRedundancy * IntroSetRequestsPerRelay);
 
+    /// number of closest peers a lookup asks at once
+    static constexpr size_t LookupAlpha = 3;
+
     struct AbstractContext
     {
       using PendingIntrosetLookups =
@@ -24,16 +24,6 @@ namespace llarp
     void
     LocalServiceAddressLookup::SendReply()
     {
-      auto path = parent->GetRouter()->pathContext().GetByUpstream(
-          parent->OurKey().as_array(), localPath);
-      if(!path)
-      {
-        llarp::LogWarn(
-            "did not send reply for relayed dht request, no such local path "
-            "for pathid=",
-            localPath);
-        return;
-      }
       // pick newest if we have more than 1 result
       if(valuesFound.size())
       {
@@ -46,6 +36,20 @@ namespace llarp
         valuesFound.clear();
         valuesFound.emplace_back(found);
       }
+      if(handleResult)
+      {
+        handleResult(valuesFound);
+      }
+      auto path = parent->GetRouter()->pathContext().GetByUpstream(
+          parent->OurKey().as_array(), localPath);
+      if(!path)
+      {
+        llarp::LogWarn(
+            "did not send reply for relayed dht request, no such local path "
+            "for pathid=",
+            localPath);
+        return;
+      }
       routing::DHTMessage msg;
       msg.M.emplace_back(new GotIntroMessage(valuesFound, whoasked.txid));
       if(!path->SendRoutingMessage(msg, parent->GetRouter()))
@@ -0,0 +1,80 @@
+#ifndef LLARP_DHT_LOOKUP_CACHE_HPP
+#define LLARP_DHT_LOOKUP_CACHE_HPP
+
+#include <util/time.hpp>
+
+#include <nonstd/optional.hpp>
+
+#include <unordered_map>
+
+namespace llarp
+{
+  namespace dht
+  {
+    /// values found by lookups, kept for a while so lookups for the same key
+    /// get answered without going out to the network again. holds at most
+    /// maxEntries values, new ones are dropped while it is full.
+    template < typename K, typename V, typename K_Hash = typename K::Hash >
+    struct LookupCache
+    {
+      LookupCache(llarp_time_t ttl, size_t maxEntries)
+          : m_TTL(ttl), m_MaxEntries(maxEntries)
+      {
+      }
+
+      /// remember v for k until ttl from now
+      void
+      Put(const K& k, const V& v, llarp_time_t now)
+      {
+        auto itr = m_Values.find(k);
+        if(itr != m_Values.end())
+          itr->second = Entry{v, now + m_TTL};
+        else if(m_Values.size() < m_MaxEntries)
+          m_Values.emplace(k, Entry{v, now + m_TTL});
+      }
+
+      /// the value for k if we have one that did not time out yet
+      nonstd::optional< V >
+      Get(const K& k, llarp_time_t now) const
+      {
+        const auto itr = m_Values.find(k);
+        if(itr == m_Values.end() || itr->second.expiresAt <= now)
+          return {};
+        return itr->second.value;
+      }
+
+      /// drop everything that timed out
+      void
+      Expire(llarp_time_t now)
+      {
+        auto itr = m_Values.begin();
+        while(itr != m_Values.end())
+        {
+          if(itr->second.expiresAt <= now)
+            itr = m_Values.erase(itr);
+          else
+            ++itr;
+        }
+      }
+
+      size_t
+      size() const
+      {
+        return m_Values.size();
+      }
+
+     private:
+      struct Entry
+      {
+        V value;
+        llarp_time_t expiresAt;
+      };
+
+      llarp_time_t m_TTL;
+      size_t m_MaxEntries;
+      std::unordered_map< K, Entry, K_Hash > m_Values;
+    };
+  }  // namespace dht
+}  // namespace llarp
+
+#endif
@@ -1,10 +1,13 @@
 #include <dht/context.hpp>
 #include <dht/messages/gotrouter.hpp>
 
+#include <algorithm>
 #include <memory>
 #include <path/path_context.hpp>
 #include <router/abstractrouter.hpp>
 #include <router/i_rc_lookup_handler.hpp>
+#include <util/thread/logic.hpp>
+#include <util/thread/thread_pool.hpp>
 
 namespace llarp
 {
@@ -79,6 +82,29 @@ namespace llarp
       return read;
     }
 
+    /// store and pass on gossiped rcs once their signatures are checked,
+    /// none of them are kept if any one of them is bad
+    static bool
+    StoreGossip(AbstractRouter *router, const std::vector< RouterContact > &rcs,
+                bool valid)
+    {
+      if(not valid)
+      {
+        LogWarn("dropping gossip with ", rcs.size(),
+                " rcs, at least one has a bad signature");
+        return false;
+      }
+      // the signatures are in the verified cache now so CheckRC is cheap
+      for(const auto &rc : rcs)
+      {
+        if(not router->rcLookupHandler().CheckRC(rc))
+          return false;
+      }
+      for(const auto &rc : rcs)
+        router->GossipRCIfNeeded(rc);
+      return true;
+    }
+
     bool
     GotRouterMessage::HandleMessage(
         llarp_dht_context *ctx,
@@ -119,15 +145,39 @@ namespace llarp
           dht.pendingRouterLookups().Found(owner, foundRCs[0].pubkey, foundRCs);
         return true;
       }
+      if(txid == 0)
+      {
+        // gossip, anything that is bad without checking the signature is
+        // rejected right here and the signatures are left to the crypto
+        // workers so the logic thread never waits on them
+        for(const auto &rc : foundRCs)
+        {
+          if(not rc.VerifyFields(dht.Now()))
+            return false;
+        }
+        auto *router = dht.GetRouter();
+        auto rcs     = foundRCs;
+        auto pool    = router->threadpool();
+        auto job     = [router, rcs]() {
+          const bool valid = std::all_of(
+              rcs.begin(), rcs.end(),
+              [](const RouterContact &rc) { return rc.VerifySignature(); });
+          LogicCall(router->logic(),
+                    [router, rcs, valid]() { StoreGossip(router, rcs, valid); });
+        };
+        if(pool && pool->tryAddJob(job))
+          return true;
+        // workers are backed up, check them here
+        const bool valid = std::all_of(
+            rcs.begin(), rcs.end(),
+            [](const RouterContact &rc) { return rc.VerifySignature(); });
+        return StoreGossip(router, rcs, valid);
+      }
       // store if valid
       for(const auto &rc : foundRCs)
       {
         if(not dht.GetRouter()->rcLookupHandler().CheckRC(rc))
           return false;
-        if(txid == 0)
-        {
-          dht.GetRouter()->GossipRCIfNeeded(rc);
-        }
       }
       return true;
     }
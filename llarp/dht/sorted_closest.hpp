@@ -0,0 +1,53 @@
+#ifndef LLARP_DHT_SORTED_CLOSEST_HPP
+#define LLARP_DHT_SORTED_CLOSEST_HPP
+
+#include <dht/key.hpp>
+
+#include <algorithm>
+
+namespace llarp
+{
+  namespace dht
+  {
+    /// true if bit of key is set, counted from the top of byte 0
+    template < typename Key >
+    bool
+    KeyBit(const Key& key, size_t bit)
+    {
+      return (key[bit / 8] >> (7 - (bit % 8))) & 1;
+    }
+
+    /// call visit on the elements of a range sorted by key closest to target
+    /// first until it returns false, return false if it did
+    ///
+    /// keys sharing a prefix with target are one run of a sorted range, so
+    /// splitting runs on one bit after another and taking the side that
+    /// matches target first hands keys out in xor distance order. the k
+    /// closest cost about k log N binary search steps and no allocations.
+    ///
+    /// key maps an element to its key and visit gets an iterator. all keys in
+    /// the range must be unique and equal before bit.
+    template < typename Itr, typename Key_f, typename Visit_f >
+    bool
+    VisitSortedClosest(Itr begin, Itr end, const Key_t& target, Key_f&& key,
+                       Visit_f&& visit, size_t bit = 0)
+    {
+      if(begin == end)
+        return true;
+      if(std::next(begin) == end || bit == Key_t::SIZE * 8)
+        return visit(begin);
+      // the range is sorted so the keys with bit clear come first
+      const Itr mid =
+          std::partition_point(begin, end, [&key, bit](const auto& e) {
+            return not KeyBit(key(e), bit);
+          });
+      if(KeyBit(target, bit))
+        return VisitSortedClosest(mid, end, target, key, visit, bit + 1)
+            && VisitSortedClosest(begin, mid, target, key, visit, bit + 1);
+      return VisitSortedClosest(begin, mid, target, key, visit, bit + 1)
+          && VisitSortedClosest(mid, end, target, key, visit, bit + 1);
+    }
+  }  // namespace dht
+}  // namespace llarp
+
+#endif
@@ -6,8 +6,10 @@
 #include <util/time.hpp>
 #include <util/status.hpp>
 
+#include <algorithm>
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 namespace llarp
 {
@@ -16,7 +18,8 @@ namespace llarp
     template < typename K, typename V, typename K_Hash >
     struct TXHolder
     {
-      using TXPtr = std::unique_ptr< TX< K, V > >;
+      /// shared by every peer a tx asks at once
+      using TXPtr = std::shared_ptr< TX< K, V > >;
       // tx who are waiting for a reply for each key
       std::unordered_multimap< K, TXOwner, K_Hash > waiting;
       // tx timesouts by key
@@ -73,6 +76,12 @@ namespace llarp
       NewTX(const TXOwner& askpeer, const TXOwner& whoasked, const K& k,
             TX< K, V >* t, llarp_time_t requestTimeoutMS = 15s);
 
+      /// ask all of askpeers for k at once, the first valid value found
+      /// finishes t and it only comes up empty once every one of them did
+      void
+      NewTX(const std::vector< TXOwner >& askpeers, const TXOwner& whoasked,
+            const K& k, TX< K, V >* t, llarp_time_t requestTimeoutMS = 15s);
+
       /// mark tx as not fond
       void
       NotFound(const TXOwner& from, const std::unique_ptr< Key_t >& next);
@@ -90,6 +99,15 @@ namespace llarp
 
       void
       Expire(llarp_time_t now);
+
+     private:
+      /// true if the tx of from still waits on other peers for key
+      bool
+      AwaitsOthers(const TXOwner& from, const K& key) const;
+
+      /// stop waiting on from for key
+      void
+      Forget(const TXOwner& from, const K& key);
     };
 
     template < typename K, typename V, typename K_Hash >
@@ -111,20 +129,38 @@ namespace llarp
                                     const TXOwner& whoasked, const K& k,
                                     TX< K, V >* t,
                                     llarp_time_t requestTimeoutMS)
+    {
+      NewTX(std::vector< TXOwner >{askpeer}, whoasked, k, t, requestTimeoutMS);
+    }
+
+    template < typename K, typename V, typename K_Hash >
+    void
+    TXHolder< K, V, K_Hash >::NewTX(const std::vector< TXOwner >& askpeers,
+                                    const TXOwner& whoasked, const K& k,
+                                    TX< K, V >* t,
+                                    llarp_time_t requestTimeoutMS)
     {
       (void)whoasked;
-      tx.emplace(askpeer, std::unique_ptr< TX< K, V > >(t));
-      auto count = waiting.count(k);
-      waiting.emplace(k, askpeer);
+      const TXPtr ptr(t);
+      const bool pending = waiting.count(k) != 0;
+      for(const auto& askpeer : askpeers)
+      {
+        tx.emplace(askpeer, ptr);
+        waiting.emplace(k, askpeer);
+        // someone already asked for k, wait for their answer instead
+        if(pending)
+          break;
+      }
 
       auto itr = timeouts.find(k);
       if(itr == timeouts.end())
       {
         timeouts.emplace(k, time_now_ms() + requestTimeoutMS);
       }
-      if(count == 0)
+      if(not pending)
       {
-        t->Start(askpeer);
+        for(const auto& askpeer : askpeers)
+          t->Start(askpeer);
       }
     }
 
@@ -147,6 +183,25 @@ namespace llarp
                                      std::vector< V > values, bool sendreply,
                                      bool removeTimeouts)
     {
+      // the tx of from already has the values
+      TXPtr fromTX;
+      if(sendreply && AwaitsOthers(from, key))
+      {
+        fromTX = tx.find(from)->second;
+        for(const auto& value : values)
+        {
+          fromTX->OnFound(from.node, value);
+        }
+        if(fromTX->valuesFound.empty())
+        {
+          // nothing good from this one but others are still out
+          Forget(from, key);
+          return;
+        }
+      }
+
+      // a tx asking several peers waits under each of them but hears once
+      std::vector< TXPtr > informed;
       auto range = waiting.equal_range(key);
       auto itr   = range.first;
       while(itr != range.second)
@@ -154,13 +209,24 @@ namespace llarp
         auto txitr = tx.find(itr->second);
         if(txitr != tx.end())
         {
-          for(const auto& value : values)
+          const TXPtr t = txitr->second;
+          if(std::find(informed.begin(), informed.end(), t) == informed.end())
           {
-            txitr->second->OnFound(from.node, value);
+            informed.emplace_back(t);
+            if(t != fromTX)
+            {
+              for(const auto& value : values)
+              {
+                t->OnFound(from.node, value);
+              }
+            }
+            if(sendreply)
+            {
+              t->SendReply();
+            }
           }
           if(sendreply)
           {
-            txitr->second->SendReply();
             tx.erase(txitr);
           }
         }
@@ -196,6 +262,41 @@ namespace llarp
         }
       }
     }
+
+    template < typename K, typename V, typename K_Hash >
+    bool
+    TXHolder< K, V, K_Hash >::AwaitsOthers(const TXOwner& from,
+                                           const K& key) const
+    {
+      const auto fromitr = tx.find(from);
+      if(fromitr == tx.end())
+      {
+        return false;
+      }
+      const auto range = waiting.equal_range(key);
+      return std::any_of(range.first, range.second, [&](const auto& item) {
+        if(item.second == from)
+          return false;
+        const auto itr = tx.find(item.second);
+        return itr != tx.end() && itr->second == fromitr->second;
+      });
+    }
+
+    template < typename K, typename V, typename K_Hash >
+    void
+    TXHolder< K, V, K_Hash >::Forget(const TXOwner& from, const K& key)
+    {
+      tx.erase(from);
+      auto range = waiting.equal_range(key);
+      for(auto itr = range.first; itr != range.second; ++itr)
+      {
+        if(itr->second == from)
+        {
+          waiting.erase(itr);
+          return;
+        }
+      }
+    }
   }  // namespace dht
 }  // namespace llarp
 
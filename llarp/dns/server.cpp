@@ -24,6 +24,8 @@ namespace llarp
       m_Server.tick     = nullptr;
       m_Client.recvfrom = &HandleUDPRecv_client;
       m_Server.recvfrom = &HandleUDPRecv_server;
+      m_Client.probemtu = 0;
+      m_Server.probemtu = 0;
     }
 
     void
@@ -76,6 +76,22 @@ llarp_ev_udp_sendto(struct llarp_udp_io *udp, const sockaddr *to,
   return udp->sendto(udp, to, buf.base, buf.sz);
 }
 
+int
+llarp_ev_udp_sendmany(struct llarp_udp_io *udp, const sockaddr *to,
+                      const llarp_udp_pkt *pkts, size_t num)
+{
+  if(udp->sendmany)
+    return udp->sendmany(udp, to, pkts, num);
+  int sent = 0;
+  for(size_t idx = 0; idx < num; ++idx)
+  {
+    if(udp->sendto(udp, to, pkts[idx].base, pkts[idx].sz) == -1)
+      break;
+    ++sent;
+  }
+  return sent;
+}
+
 bool
 llarp_ev_add_tun(struct llarp_ev_loop *loop, struct llarp_tun_io *tun)
 {
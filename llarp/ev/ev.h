@@ -66,11 +66,20 @@ llarp_ev_loop_stop(const llarp_ev_loop_ptr &ev);
 /// forward declared
 struct llarp_pkt_list;
 
+/// a datagram to send as part of a batch
+struct llarp_udp_pkt
+{
+  const byte_t *base;
+  size_t sz;
+};
+
 /// UDP handling configuration
 struct llarp_udp_io
 {
   /// set after added
   int fd;
+  /// set before adding, send with DF set for path mtu probes
+  int probemtu;
   void *user;
   void *impl;
   struct llarp_ev_loop *parent;
@@ -83,6 +92,10 @@ struct llarp_udp_io
   /// set by parent
   int (*sendto)(struct llarp_udp_io *, const struct sockaddr *, const byte_t *,
                 size_t);
+  /// set by parent, send many packets to the same address in one go
+  /// returns the number of packets sent
+  int (*sendmany)(struct llarp_udp_io *, const struct sockaddr *,
+                  const struct llarp_udp_pkt *, size_t);
 };
 
 /// get all packets recvieved last tick
@@ -100,6 +113,13 @@ int
 llarp_ev_udp_sendto(struct llarp_udp_io *udp, const struct sockaddr *to,
                     const llarp_buffer_t &pkt);
 
+/// send many UDP packets to the same address
+/// uses batched io if the event loop supports it
+/// returns the number of packets sent
+int
+llarp_ev_udp_sendmany(struct llarp_udp_io *udp, const struct sockaddr *to,
+                      const struct llarp_udp_pkt *pkts, size_t num);
+
 /// close UDP handler
 int
 llarp_ev_close_udp(struct llarp_udp_io *udp);
@@ -210,6 +230,8 @@ struct llarp_tun_io
   // windows only
   uint32_t dnsaddr;
   int netmask;
+  /// linux only: how many queues to open on the interface, 0 for one
+  int queues;
   char ifname[IFNAMSIZ + 1];
 
   void *user;
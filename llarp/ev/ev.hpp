@@ -5,6 +5,7 @@
 #include <ev/ev.h>
 #include <util/buffer.hpp>
 #include <util/codel.hpp>
+#include <util/packet_pool.hpp>
 #include <util/thread/threading.hpp>
 
 // writev
@@ -840,11 +841,27 @@ struct PacketBuffer
   PacketBuffer&
   operator=(const PacketBuffer&) = delete;
 
+  PacketBuffer&
+  operator=(PacketBuffer&& other)
+  {
+    if(this != &other)
+    {
+      if(_ptr)
+        llarp::util::PacketPool::Free(_ptr);
+      _ptr       = other._ptr;
+      _sz        = other._sz;
+      other._ptr = nullptr;
+      other._sz  = 0;
+    }
+    return *this;
+  }
+
   PacketBuffer() : PacketBuffer(nullptr, 0){};
   explicit PacketBuffer(size_t sz) : _sz{sz}
   {
-    _ptr = new char[sz];
+    _ptr = llarp::util::PacketPool::Alloc(sz);
   }
+  /// take ownership of buf, which must come from PacketPool::Alloc
   PacketBuffer(char* buf, size_t sz)
   {
     _ptr = buf;
@@ -853,7 +870,7 @@ struct PacketBuffer
   ~PacketBuffer()
   {
     if(_ptr)
-      delete[] _ptr;
+      llarp::util::PacketPool::Free(_ptr);
   }
   byte_t*
   data()
@@ -872,10 +889,12 @@ struct PacketBuffer
   void
   reserve(size_t sz)
   {
-    if(_ptr)
-      delete[] _ptr;
-    _ptr = new char[sz];
-    _sz  = sz;
+    if(llarp::util::PacketPool::Capacity(_ptr) < sz)
+    {
+      llarp::util::PacketPool::Free(_ptr);
+      _ptr = llarp::util::PacketPool::Alloc(sz);
+    }
+    _sz = sz;
   }
 
  private:
@@ -1,9 +1,22 @@
 #include <ev/ev_libuv.hpp>
+#include <ev/udp_batch.hpp>
+#include <ev/vnet.hpp>
 #include <net/net_addr.hpp>
 #include <util/thread/logic.hpp>
 #include <util/thread/queue.hpp>
+#include <util/thread/spsc_ring.hpp>
+#include <util/thread/threading.hpp>
 
 #include <cstring>
+#include <thread>
+
+#ifdef LLARP_TUN_VNET
+#include <sys/ioctl.h>
+#include <sys/uio.h>
+#endif
+#ifndef _WIN32
+#include <netinet/in.h>
+#endif
 
 namespace libuv
 {
@@ -397,27 +410,48 @@ namespace libuv
 
   struct udp_glue : public glue
   {
+#ifdef LLARP_UDP_MMSG
+    /// our own socket, polled so we can drain it with recvmmsg. libuv only
+    /// ever watches it through this one handle
+    uv_poll_t m_Handle;
+    int m_FD = -1;
+    llarp::UDPBatchIO m_Batch;
+#else
     uv_udp_t m_Handle;
+#endif
     uv_check_t m_Ticker;
+    uv_loop_t* const m_Loop;
     llarp_udp_io* const m_UDP;
     llarp::Addr m_Addr;
     llarp_pkt_list m_LastPackets;
     std::array< char, 1500 > m_Buffer;
+    /// handles still closing before we can go away
+    size_t m_Closing = 0;
 
     udp_glue(uv_loop_t* loop, llarp_udp_io* udp, const sockaddr* src)
-        : m_UDP(udp), m_Addr(*src)
+        : m_Loop(loop), m_UDP(udp), m_Addr(*src)
     {
       m_Handle.data = this;
       m_Ticker.data = this;
+#ifndef LLARP_UDP_MMSG
       uv_udp_init(loop, &m_Handle);
+#endif
       uv_check_init(loop, &m_Ticker);
     }
 
+#ifdef LLARP_UDP_MMSG
+    ~udp_glue() override
+    {
+      if(m_FD != -1)
+        ::close(m_FD);
+    }
+#endif
+
     static void
     Alloc(uv_handle_t*, size_t suggested_size, uv_buf_t* buf)
     {
       const size_t sz = std::min(suggested_size, size_t{1500});
-      buf->base       = new char[sz];
+      buf->base       = llarp::util::PacketPool::Alloc(sz);
       buf->len        = sz;
     }
 
@@ -430,8 +464,39 @@ namespace libuv
         glue->RecvFrom(nread, buf, addr);
       if(nread <= 0 || glue->m_UDP == nullptr
          || glue->m_UDP->recvfrom != nullptr)
-        delete[] buf->base;
+        llarp::util::PacketPool::Free(buf->base);
+    }
+
+#ifdef LLARP_UDP_MMSG
+    static void
+    OnPoll(uv_poll_t* handle, int status, int events)
+    {
+      if(status == 0 && (events & UV_READABLE))
+        static_cast< udp_glue* >(handle->data)->RecvBatch();
+    }
+
+    /// drain up to one batch of datagrams per wakeup
+    void
+    RecvBatch()
+    {
+      if(m_UDP == nullptr)
+        return;
+      if(m_UDP->recvfrom == nullptr)
+      {
+        if(m_Batch.RecvMany(m_UDP->fd, m_LastPackets) == -1)
+          llarp::LogWarn("recvmmsg failed on ", m_Addr, ": ", strerror(errno));
+        return;
+      }
+      llarp_pkt_list pkts;
+      if(m_Batch.RecvMany(m_UDP->fd, pkts) == -1)
+        llarp::LogWarn("recvmmsg failed on ", m_Addr, ": ", strerror(errno));
+      for(auto& pkt : pkts)
+      {
+        const llarp_buffer_t buf(pkt.pkt.data(), pkt.pkt.size());
+        m_UDP->recvfrom(m_UDP, pkt.remote, ManagedBuffer{buf});
+      }
     }
+#endif
 
     bool
     RecvMany(llarp_pkt_list* pkts)
@@ -480,36 +545,110 @@ namespace libuv
       auto* self = static_cast< udp_glue* >(udp->impl);
       if(self == nullptr)
         return -1;
+#ifdef LLARP_UDP_MMSG
+      const llarp_udp_pkt pkt{ptr, sz};
+      return llarp::UDPBatchIO::SendMany(udp->fd, to, &pkt, 1) == 1 ? sz : -1;
+#else
       uv_buf_t buf = uv_buf_init((char*)ptr, sz);
       return uv_udp_try_send(&self->m_Handle, &buf, 1, to);
+#endif
+    }
+
+    static int
+    SendMany(llarp_udp_io* udp, const sockaddr* to, const llarp_udp_pkt* pkts,
+             size_t num)
+    {
+      auto* self = static_cast< udp_glue* >(udp->impl);
+      if(self == nullptr)
+        return -1;
+#ifdef LLARP_UDP_MMSG
+      return llarp::UDPBatchIO::SendMany(udp->fd, to, pkts, num);
+#else
+      int sent = 0;
+      for(size_t idx = 0; idx < num; ++idx)
+      {
+        uv_buf_t buf = uv_buf_init((char*)pkts[idx].base, pkts[idx].sz);
+        if(uv_udp_try_send(&self->m_Handle, &buf, 1, to) < 0)
+          break;
+        ++sent;
+      }
+      return sent;
+#endif
+    }
+
+#ifdef LLARP_UDP_MMSG
+    /// bind a nonblocking socket of our own and poll it
+    int
+    BindSocket()
+    {
+      m_FD = socket(m_Addr.af(), SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+      if(m_FD == -1)
+        return uv_translate_sys_error(errno);
+      if(bind(m_FD, m_Addr, m_Addr.SockLen()) == -1)
+        return uv_translate_sys_error(errno);
+      return uv_poll_init(m_Loop, &m_Handle, m_FD);
+    }
+#endif
+
+    /// send everything with DF set and never fragment locally, so path mtu
+    /// probes that are too big for the path get lost instead of split up
+    void
+    SetProbeMTU()
+    {
+#if defined(IP_MTU_DISCOVER) && defined(IP_PMTUDISC_PROBE)
+      const bool v6   = m_Addr.af() == AF_INET6;
+      const int level = v6 ? IPPROTO_IPV6 : IPPROTO_IP;
+      const int opt   = v6 ? IPV6_MTU_DISCOVER : IP_MTU_DISCOVER;
+      const int val   = v6 ? IPV6_PMTUDISC_PROBE : IP_PMTUDISC_PROBE;
+      if(setsockopt(m_UDP->fd, level, opt, &val, sizeof(val)) == -1)
+        llarp::LogWarn("cannot probe path mtu via ", m_Addr, ": ",
+                       strerror(errno));
+#endif
     }
 
     bool
     Bind()
     {
-      auto ret = uv_udp_bind(&m_Handle, m_Addr, 0);
+#ifdef LLARP_UDP_MMSG
+      // libuv reads one datagram per callback, so we poll a socket of our
+      // own and drain it in batches instead of going through a uv_udp_t
+      const auto ret = BindSocket();
+#else
+      const auto ret = uv_udp_bind(&m_Handle, m_Addr, 0);
+#endif
       if(ret)
       {
         llarp::LogError("failed to bind to ", m_Addr, " ", uv_strerror(ret));
         return false;
       }
+#if defined(_WIN32) || defined(_WIN64)
+#else
+      if(uv_fileno((const uv_handle_t*)&m_Handle, &m_UDP->fd))
+        return false;
+#endif
+      if(m_UDP->probemtu)
+        SetProbeMTU();
+#ifdef LLARP_UDP_MMSG
+      if(uv_poll_start(&m_Handle, UV_READABLE, &OnPoll))
+      {
+        llarp::LogError("failed to start polling packets via ", m_Addr);
+        return false;
+      }
+#else
       if(uv_udp_recv_start(&m_Handle, &Alloc, &OnRecv))
       {
         llarp::LogError("failed to start recving packets via ", m_Addr);
         return false;
       }
+#endif
       if(uv_check_start(&m_Ticker, &OnTick))
       {
         llarp::LogError("failed to start ticker");
         return false;
       }
-#if defined(_WIN32) || defined(_WIN64)
-#else
-      if(uv_fileno((const uv_handle_t*)&m_Handle, &m_UDP->fd))
-        return false;
-#endif
-      m_UDP->sendto = &SendTo;
-      m_UDP->impl   = this;
+      m_UDP->sendto   = &SendTo;
+      m_UDP->sendmany = &SendMany;
+      m_UDP->impl     = this;
       return true;
     }
 
@@ -517,18 +656,21 @@ namespace libuv
     OnClosed(uv_handle_t* h)
     {
       auto* glue = static_cast< udp_glue* >(h->data);
-      if(glue)
-      {
-        h->data = nullptr;
+      if(glue && --glue->m_Closing == 0)
         delete glue;
-      }
     }
 
     void
     Close() override
     {
+      if(uv_is_closing((const uv_handle_t*)&m_Handle))
+        return;
       m_UDP->impl = nullptr;
       uv_check_stop(&m_Ticker);
+      // libuv does not finish closes in the order we ask for them, so the
+      // last handle to close deletes us
+      m_Closing = 2;
+      uv_close((uv_handle_t*)&m_Ticker, &OnClosed);
       uv_close((uv_handle_t*)&m_Handle, &OnClosed);
     }
   };
@@ -608,22 +750,229 @@ namespace libuv
 #else
   struct tun_glue : public glue
   {
-    uv_poll_t m_Handle;
+    /// one tun queue and its read buffers. the first queue is polled on the
+    /// event loop. any others get a loop and thread of their own, read and
+    /// cut up gso packets there and hand the packets over to the event loop
+    struct Queue
+    {
+      /// a packet read on a queue thread, in a packet pool block the event
+      /// loop frees once it is done with it
+      struct Packet
+      {
+        char* block   = nullptr;
+        size_t offset = 0;
+        size_t sz     = 0;
+      };
+
+      /// most packets a queue thread keeps waiting for the event loop
+      static constexpr size_t RingSize = 1024;
+      /// most reads a queue thread does per wakeup
+      static constexpr size_t MaxReads = 64;
+
+      tun_glue* const parent;
+      const int fd;
+      uv_poll_t handle;
+      std::vector< byte_t > buffer;
+#ifdef LLARP_TUN_VNET
+      std::vector< byte_t > segment;
+#endif
+      /// set for queues read on a thread of their own
+      bool threaded = false;
+      uv_loop_t loop;
+      uv_async_t stop;
+      std::thread thread;
+      /// block the next read on our thread goes to
+      char* block = nullptr;
+      /// packets from our thread to the event loop
+      llarp::thread::SPSCRing< Packet > ring{RingSize};
+
+      Queue(tun_glue* p, int f, size_t bufsz)
+          : parent(p), fd(f), buffer(bufsz)
+      {
+      }
+
+      ~Queue()
+      {
+        Stop();
+        while(auto pkt = ring.tryPopFront())
+          llarp::util::PacketPool::Free(pkt->block);
+        if(block)
+          llarp::util::PacketPool::Free(block);
+      }
+
+      /// start polling on a new loop run by a thread of our own
+      bool
+      Start(const std::string& name)
+      {
+        if(uv_loop_init(&loop) != 0)
+          return false;
+        threaded    = true;
+        stop.data   = this;
+        handle.data = this;
+        if(uv_async_init(&loop, &stop, &OnStop) != 0
+           || uv_poll_init(&loop, &handle, fd) != 0
+           || uv_poll_start(&handle, UV_READABLE, &OnPoll) != 0)
+          return false;
+        thread = std::thread([this, name]() {
+          llarp::util::SetThreadName(name);
+          uv_run(&loop, UV_RUN_DEFAULT);
+        });
+        return true;
+      }
+
+      /// close our loop and wait for our thread to finish
+      void
+      Stop()
+      {
+        if(not threaded)
+          return;
+        threaded = false;
+        if(thread.joinable())
+        {
+          uv_async_send(&stop);
+          thread.join();
+        }
+        else
+        {
+          // never got going, close what we set up by hand
+          CloseAll(&loop);
+          uv_run(&loop, UV_RUN_DEFAULT);
+        }
+        uv_loop_close(&loop);
+      }
+
+      static void
+      CloseAll(uv_loop_t* l)
+      {
+        uv_walk(
+            l,
+            [](uv_handle_t* h, void*) {
+              if(not uv_is_closing(h))
+                uv_close(h, nullptr);
+            },
+            nullptr);
+      }
+
+      static void
+      OnStop(uv_async_t* h)
+      {
+        CloseAll(h->loop);
+      }
+
+      static void
+      OnPoll(uv_poll_t* h, int, int events)
+      {
+        if(events & UV_READABLE)
+          static_cast< Queue* >(h->data)->ReadPending();
+      }
+
+      /// read everything waiting, for the event loop to pick up
+      void
+      ReadPending()
+      {
+        bool handed = false;
+        for(size_t reads = 0; reads < MaxReads; ++reads)
+        {
+          if(not ReadOnce(handed))
+            break;
+        }
+        if(handed)
+          uv_async_send(&parent->m_Wake);
+      }
+
+      /// give pkt in block to the event loop, dropped if it is behind
+      void
+      Hand(Packet pkt, bool& handed)
+      {
+        if(ring.tryPushBack(std::move(pkt)))
+          handed = true;
+        else
+          llarp::util::PacketPool::Free(pkt.block);
+      }
+
+      /// do one read on our thread. returns false if there was nothing
+      bool
+      ReadOnce(bool& handed)
+      {
+#ifdef LLARP_TUN_VNET
+        // the biggest pooled block, reads that fit are handed over in it as
+        // they are. only gso super packets spill into buffer to be cut up
+        static const size_t BlockSize = llarp::util::PacketPool::ClassSize(
+            llarp::util::PacketPool::NumClasses - 1);
+        if(block == nullptr)
+          block = llarp::util::PacketPool::Alloc(BlockSize);
+        iovec iov[2] = {{block, BlockSize},
+                        {buffer.data() + BlockSize, buffer.size() - BlockSize}};
+        const auto sz = ::readv(fd, iov, 2);
+        if(sz <= 0)
+          return false;
+        byte_t* pkt = reinterpret_cast< byte_t* >(block);
+        if(size_t(sz) > BlockSize)
+        {
+          std::copy_n(pkt, BlockSize, buffer.data());
+          pkt = buffer.data();
+        }
+        llarp::vnet::Header hdr;
+        if(not hdr.Decode(pkt, sz, parent->m_VnetLE))
+          return true;
+        const bool inBlock = pkt != buffer.data();
+        auto visit         = [&](const llarp_buffer_t& seg) {
+          if(inBlock && seg.base >= pkt && seg.base < pkt + sz)
+          {
+            Hand(Packet{block, size_t(seg.base - pkt), seg.sz}, handed);
+            block = nullptr;
+            return;
+          }
+          // a segment cut out of a super packet
+          char* copy = llarp::util::PacketPool::Alloc(seg.sz);
+          std::copy_n(seg.base, seg.sz, copy);
+          Hand(Packet{copy, 0, seg.sz}, handed);
+        };
+        if(not llarp::vnet::Segment(hdr, pkt + hdr.SIZE, sz - hdr.SIZE,
+                                    segment, visit))
+          llarp::LogWarn("dropped bad offload packet on ",
+                         parent->m_Tun->ifname, " gso=", int(hdr.gsoType));
+        return true;
+#else
+        // only vnet tuns have more than one queue
+        (void)handed;
+        return false;
+#endif
+      }
+    };
+
     uv_check_t m_Ticker;
+    /// woken by queue threads when they have packets for us
+    uv_async_t m_Wake;
     llarp_tun_io* const m_Tun;
     device* const m_Device;
-    byte_t m_Buffer[1500];
-    bool readpkt;
+    /// queue 0 is the device fd, owned by m_Device
+    std::vector< std::unique_ptr< Queue > > m_Queues;
+    /// true if our queues carry vnet headers
+    bool m_Vnet = false;
+    /// true if the kernel puts little endian vnet headers on our queues
+    bool m_VnetLE = false;
+#ifdef LLARP_TUN_VNET
+    std::vector< int > m_VnetFds;
+#endif
+    /// handles still closing before we can go away
+    size_t m_Closing = 0;
 
     tun_glue(llarp_tun_io* tun) : m_Tun(tun), m_Device(tuntap_init())
     {
-      m_Handle.data = this;
       m_Ticker.data = this;
-      readpkt = false;
+      m_Wake.data   = this;
     }
 
     ~tun_glue() override
     {
+      // queue threads read from fds we are about to close
+      m_Queues.clear();
+#ifdef LLARP_TUN_VNET
+      // the first queue is closed with the device
+      for(size_t idx = 1; idx < m_VnetFds.size(); ++idx)
+        ::close(m_VnetFds[idx]);
+#endif
       tuntap_destroy(m_Device);
     }
 
@@ -639,21 +988,73 @@ namespace libuv
     {
       if(events & UV_READABLE)
       {
-        static_cast< tun_glue* >(h->data)->Read();
+        auto* self = static_cast< tun_glue* >(h->data);
+        self->Read(*self->m_Queues[0], [self](const llarp_buffer_t& pkt) {
+          self->m_Tun->recvpkt(self->m_Tun, pkt);
+        });
       }
     }
 
+    static void
+    OnWake(uv_async_t* h)
+    {
+      static_cast< tun_glue* >(h->data)->TakePending();
+    }
+
+    /// hand what the queue threads read to recvpkt
     void
-    Read()
+    TakePending()
     {
-      auto sz = tuntap_read(m_Device, m_Buffer, sizeof(m_Buffer));
-      if(sz > 0)
+      if(m_Tun->recvpkt == nullptr)
+        return;
+      for(size_t idx = 1; idx < m_Queues.size(); ++idx)
       {
+        auto& ring = m_Queues[idx]->ring;
+        // no more than a ring's worth, so a busy queue cannot keep us here
+        for(size_t num = ring.capacity(); num > 0; --num)
+        {
+          auto pkt = ring.tryPopFront();
+          if(not pkt.has_value())
+            break;
+          m_Tun->recvpkt(m_Tun,
+                         llarp_buffer_t(pkt->block + pkt->offset, pkt->sz));
+          llarp::util::PacketPool::Free(pkt->block);
+        }
+        if(ring.size())
+          uv_async_send(&m_Wake);
+      }
+    }
+
+    /// do one read on queue and visit every packet in it. returns false if
+    /// there was nothing to read
+    bool
+    Read(Queue& queue, const llarp::vnet::Visit_t& visit)
+    {
+      if(m_Tun == nullptr || m_Tun->recvpkt == nullptr)
+        return false;
+#ifdef LLARP_TUN_VNET
+      if(m_Vnet)
+      {
+        auto& buf     = queue.buffer;
+        const auto sz = ::read(queue.fd, buf.data(), buf.size());
+        llarp::vnet::Header hdr;
+        if(sz <= 0 || not hdr.Decode(buf.data(), sz, m_VnetLE))
+          return sz > 0;
         llarp::LogDebug("tun read ", sz);
-        const llarp_buffer_t pkt(m_Buffer, sz);
-        if(m_Tun && m_Tun->recvpkt)
-          m_Tun->recvpkt(m_Tun, pkt);
+        // one read can carry a whole gso super packet
+        if(not llarp::vnet::Segment(hdr, buf.data() + hdr.SIZE, sz - hdr.SIZE,
+                                    queue.segment, visit))
+          llarp::LogWarn("dropped bad offload packet on ", m_Tun->ifname,
+                         " gso=", int(hdr.gsoType));
+        return true;
       }
+#endif
+      auto sz = tuntap_read(m_Device, queue.buffer.data(), queue.buffer.size());
+      if(sz <= 0)
+        return false;
+      llarp::LogDebug("tun read ", sz);
+      visit(llarp_buffer_t(queue.buffer.data(), sz));
+      return true;
     }
 
     void
@@ -669,11 +1070,8 @@ namespace libuv
     OnClosed(uv_handle_t* h)
     {
       auto* self = static_cast< tun_glue* >(h->data);
-      if(self)
-      {
-        h->data = nullptr;
+      if(self && --self->m_Closing == 0)
         delete self;
-      }
     }
 
     void
@@ -682,16 +1080,28 @@ namespace libuv
       if(m_Tun->impl == nullptr)
         return;
       m_Tun->impl = nullptr;
+      // no queue thread may wake us once m_Wake is closed
+      for(size_t idx = 1; idx < m_Queues.size(); ++idx)
+        m_Queues[idx]->Stop();
       uv_check_stop(&m_Ticker);
-      uv_close((uv_handle_t*)&m_Ticker, [](uv_handle_t* h) {
-        tun_glue* glue = static_cast< tun_glue* >(h->data);
-        uv_close((uv_handle_t*)&glue->m_Handle, &OnClosed);
-      });
+      m_Closing = 3;
+      uv_close((uv_handle_t*)&m_Ticker, &OnClosed);
+      uv_close((uv_handle_t*)&m_Wake, &OnClosed);
+      uv_close((uv_handle_t*)&m_Queues[0]->handle, &OnClosed);
     }
 
     bool
     Write(const byte_t* pkt, size_t sz)
     {
+#ifdef LLARP_TUN_VNET
+      if(m_Vnet)
+      {
+        // packets of one flow stay on one queue and so stay in order
+        const int fd =
+            m_VnetFds[llarp::vnet::FlowHash(pkt, sz) % m_VnetFds.size()];
+        return llarp::vnet::Write(fd, pkt, sz, m_VnetLE);
+      }
+#endif
       return tuntap_write(m_Device, (void*)pkt, sz) != -1;
     }
 
@@ -702,11 +1112,51 @@ namespace libuv
       return glue && glue->Write(pkt, sz);
     }
 
+#ifdef LLARP_TUN_VNET
+    /// libtuntap hook that opens our queues in place of its own fd
+    static int
+    OpenVnetQueues(device* dev)
+    {
+      auto* self = static_cast< tun_glue* >(dev->user);
+      const size_t num = std::max(self->m_Tun->queues, 1);
+      if(not llarp::vnet::OpenQueues(dev->if_name, num, self->m_VnetFds,
+                                     self->m_VnetLE))
+        return -1;
+      // libtuntap skips reading these for a handed in fd
+      ifreq ifr;
+      std::memset(&ifr, 0, sizeof(ifr));
+      std::memcpy(ifr.ifr_name, dev->if_name, sizeof(dev->if_name));
+      if(ioctl(dev->ctrl_sock, SIOCGIFFLAGS, &ifr) != -1)
+        dev->flags = ifr.ifr_flags;
+      return self->m_VnetFds[0];
+    }
+#endif
+
     bool
-    Init(uv_loop_t* loop)
+    Start()
     {
       memcpy(m_Device->if_name, m_Tun->ifname, sizeof(m_Device->if_name));
-      if(tuntap_start(m_Device, TUNTAP_MODE_TUNNEL, 0) == -1)
+#ifdef LLARP_TUN_VNET
+      m_Device->user      = this;
+      m_Device->obtain_fd = &OpenVnetQueues;
+      if(tuntap_start(m_Device, TUNTAP_MODE_TUNNEL, 0) != -1)
+      {
+        m_Vnet = true;
+        return true;
+      }
+      llarp::LogWarn("no multi queue vnet tun for ", m_Tun->ifname,
+                     ", falling back to a plain tun");
+      m_Device->obtain_fd = nullptr;
+      m_VnetFds.clear();
+      memcpy(m_Device->if_name, m_Tun->ifname, sizeof(m_Device->if_name));
+#endif
+      return tuntap_start(m_Device, TUNTAP_MODE_TUNNEL, 0) != -1;
+    }
+
+    bool
+    Init(uv_loop_t* loop)
+    {
+      if(not Start())
       {
         llarp::LogError("failed to start up ", m_Tun->ifname);
         return false;
@@ -731,16 +1181,36 @@ namespace libuv
 
       tuntap_set_nonblocking(m_Device, 1);
 
-      if(uv_poll_init(loop, &m_Handle, m_Device->tun_fd) == -1)
+      std::vector< int > fds{m_Device->tun_fd};
+      size_t bufsz = 1500;
+#ifdef LLARP_TUN_VNET
+      if(m_Vnet)
       {
-        llarp::LogError("failed to start polling on ", m_Tun->ifname);
-        return false;
+        fds   = m_VnetFds;
+        bufsz = llarp::vnet::MaxReadSize;
       }
-      if(uv_poll_start(&m_Handle, UV_READABLE, &OnPoll))
+#endif
+      for(const int fd : fds)
+        m_Queues.emplace_back(new Queue(this, fd, bufsz));
+      m_Queues[0]->handle.data = this;
+      if(uv_poll_init(loop, &m_Queues[0]->handle, fds[0]) == -1
+         || uv_poll_start(&m_Queues[0]->handle, UV_READABLE, &OnPoll)
+         || uv_async_init(loop, &m_Wake, &OnWake) != 0)
       {
         llarp::LogError("failed to start polling on ", m_Tun->ifname);
         return false;
       }
+      for(size_t idx = 1; idx < m_Queues.size(); ++idx)
+      {
+        const std::string name = std::string(m_Tun->ifname) + "-q"
+            + std::to_string(idx);
+        if(not m_Queues[idx]->Start(name))
+        {
+          llarp::LogError("failed to start reading queue ", idx, " of ",
+                          m_Tun->ifname);
+          return false;
+        }
+      }
       if(uv_check_init(loop, &m_Ticker) != 0
          || uv_check_start(&m_Ticker, &OnTick) != 0)
       {
@@ -748,8 +1218,10 @@ namespace libuv
                         m_Tun->ifname);
         return false;
       }
+      llarp::LogInfo(m_Tun->ifname, " up with ", m_Queues.size(), " queues",
+                     m_Vnet ? " and gso offload" : "");
       m_Tun->writepkt = &WritePkt;
-      m_Tun->impl = this;
+      m_Tun->impl     = this;
       return true;
     }
   };
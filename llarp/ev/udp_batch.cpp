@@ -0,0 +1,138 @@
+#include <ev/udp_batch.hpp>
+
+#include <cerrno>
+#include <cstring>
+
+namespace llarp
+{
+  UDPBatchIO::UDPBatchIO()
+  {
+    for(auto& slot : m_Slots)
+      slot = util::PacketPool::Alloc(MaxPacketSize);
+  }
+
+  UDPBatchIO::~UDPBatchIO()
+  {
+    for(auto& slot : m_Slots)
+      util::PacketPool::Free(slot);
+  }
+
+#ifdef LLARP_UDP_MMSG
+  ssize_t
+  UDPBatchIO::RecvMany(int fd, llarp_pkt_list& pkts)
+  {
+    for(size_t idx = 0; idx < BatchSize; ++idx)
+    {
+      m_IOV[idx].iov_base = m_Slots[idx];
+      m_IOV[idx].iov_len  = MaxPacketSize;
+      auto& hdr           = m_Headers[idx].msg_hdr;
+      std::memset(&hdr, 0, sizeof(hdr));
+      hdr.msg_name          = &m_Addrs[idx];
+      hdr.msg_namelen       = sizeof(sockaddr_storage);
+      hdr.msg_iov           = &m_IOV[idx];
+      hdr.msg_iovlen        = 1;
+      m_Headers[idx].msg_len = 0;
+    }
+    const int got = recvmmsg(fd, m_Headers.data(), BatchSize, MSG_DONTWAIT,
+                             nullptr);
+    if(got <= 0)
+      return (got == 0 || errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+    for(int idx = 0; idx < got; ++idx)
+    {
+      const size_t sz = m_Headers[idx].msg_len;
+      if(sz == 0 || (m_Headers[idx].msg_hdr.msg_flags & MSG_TRUNC))
+        continue;
+      const sockaddr* from =
+          reinterpret_cast< const sockaddr* >(&m_Addrs[idx]);
+      // hand off the filled slot and put a fresh one in its place
+      pkts.emplace_back(PacketEvent{*from, PacketBuffer(m_Slots[idx], sz)});
+      m_Slots[idx] = util::PacketPool::Alloc(MaxPacketSize);
+    }
+    return got;
+  }
+
+  ssize_t
+  UDPBatchIO::SendMany(int fd, const sockaddr* to, const llarp_udp_pkt* bufs,
+                       size_t num)
+  {
+    const socklen_t tolen = to->sa_family == AF_INET6 ? sizeof(sockaddr_in6)
+                                                      : sizeof(sockaddr_in);
+    std::array< mmsghdr, BatchSize > hdrs;
+    std::array< iovec, BatchSize > iov;
+    size_t sent = 0;
+    while(sent < num)
+    {
+      const size_t chunk = std::min(num - sent, BatchSize);
+      for(size_t idx = 0; idx < chunk; ++idx)
+      {
+        iov[idx].iov_base = const_cast< byte_t* >(bufs[sent + idx].base);
+        iov[idx].iov_len  = bufs[sent + idx].sz;
+        auto& hdr         = hdrs[idx].msg_hdr;
+        std::memset(&hdr, 0, sizeof(hdr));
+        hdr.msg_name    = const_cast< sockaddr* >(to);
+        hdr.msg_namelen = tolen;
+        hdr.msg_iov     = &iov[idx];
+        hdr.msg_iovlen  = 1;
+      }
+      const int n = sendmmsg(fd, hdrs.data(), chunk, MSG_DONTWAIT);
+      if(n <= 0)
+      {
+        if(sent == 0 && errno != EAGAIN && errno != EWOULDBLOCK)
+          return -1;
+        break;
+      }
+      sent += n;
+    }
+    return sent;
+  }
+#else
+#ifdef MSG_DONTWAIT
+  static constexpr int NoWait = MSG_DONTWAIT;
+#else
+  // the caller's socket must be nonblocking here
+  static constexpr int NoWait = 0;
+#endif
+
+  ssize_t
+  UDPBatchIO::RecvMany(int fd, llarp_pkt_list& pkts)
+  {
+    ssize_t got = 0;
+    while(got < ssize_t(BatchSize))
+    {
+      sockaddr_storage from;
+      socklen_t fromlen = sizeof(from);
+      const auto sz = ::recvfrom(fd, m_Slots[got], MaxPacketSize, NoWait,
+                                 reinterpret_cast< sockaddr* >(&from),
+                                 &fromlen);
+      if(sz < 0 && got == 0 && errno != EAGAIN && errno != EWOULDBLOCK)
+        return -1;
+      if(sz <= 0)
+        break;
+      pkts.emplace_back(
+          PacketEvent{*reinterpret_cast< const sockaddr* >(&from),
+                      PacketBuffer(m_Slots[got], sz)});
+      m_Slots[got] = util::PacketPool::Alloc(MaxPacketSize);
+      ++got;
+    }
+    return got;
+  }
+
+  ssize_t
+  UDPBatchIO::SendMany(int fd, const sockaddr* to, const llarp_udp_pkt* bufs,
+                       size_t num)
+  {
+    const socklen_t tolen = to->sa_family == AF_INET6 ? sizeof(sockaddr_in6)
+                                                      : sizeof(sockaddr_in);
+    size_t sent = 0;
+    while(sent < num)
+    {
+      if(::sendto(fd, (const char*)bufs[sent].base, bufs[sent].sz, NoWait, to,
+                  tolen)
+         < 0)
+        break;
+      ++sent;
+    }
+    return sent;
+  }
+#endif
+}  // namespace llarp
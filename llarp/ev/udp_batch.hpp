@@ -0,0 +1,73 @@
+#ifndef LLARP_EV_UDP_BATCH_HPP
+#define LLARP_EV_UDP_BATCH_HPP
+
+#include <ev/ev.hpp>
+
+#include <array>
+
+#ifndef EV_UDP_BATCH_SIZE
+#define EV_UDP_BATCH_SIZE (32UL)
+#endif
+
+#ifndef EV_UDP_MAX_PKT_SIZE
+#define EV_UDP_MAX_PKT_SIZE (1500UL)
+#endif
+
+#if defined(__linux__)
+#define LLARP_UDP_MMSG 1
+#include <sys/socket.h>
+#endif
+
+namespace llarp
+{
+  /// batched datagram io on a bound udp socket
+  /// uses recvmmsg/sendmmsg on linux and falls back to one syscall per
+  /// datagram everywhere else
+  struct UDPBatchIO
+  {
+    static constexpr size_t BatchSize     = EV_UDP_BATCH_SIZE;
+    static constexpr size_t MaxPacketSize = EV_UDP_MAX_PKT_SIZE;
+
+    UDPBatchIO();
+    ~UDPBatchIO();
+
+    UDPBatchIO(const UDPBatchIO&) = delete;
+
+    UDPBatchIO&
+    operator=(const UDPBatchIO&) = delete;
+
+    /// drain up to BatchSize datagrams from fd and append them to pkts
+    /// without ever blocking, even on a blocking fd where the platform lets
+    /// us. returns the number of datagrams read or -1 on error
+    ssize_t
+    RecvMany(int fd, llarp_pkt_list& pkts);
+
+    /// send num datagrams in bufs to one remote address
+    /// returns the number of datagrams sent or -1 on error
+    static ssize_t
+    SendMany(int fd, const sockaddr* to, const llarp_udp_pkt* bufs,
+             size_t num);
+
+    /// returns true if this platform does batched syscalls
+    static constexpr bool
+    Batched()
+    {
+#ifdef LLARP_UDP_MMSG
+      return true;
+#else
+      return false;
+#endif
+    }
+
+   private:
+    /// receive buffers handed off to the packet list when filled
+    std::array< char*, BatchSize > m_Slots;
+#ifdef LLARP_UDP_MMSG
+    std::array< mmsghdr, BatchSize > m_Headers;
+    std::array< iovec, BatchSize > m_IOV;
+    std::array< sockaddr_storage, BatchSize > m_Addrs;
+#endif
+  };
+}  // namespace llarp
+
+#endif
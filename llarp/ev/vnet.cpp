@@ -0,0 +1,312 @@
+#include <ev/vnet.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef LLARP_TUN_VNET
+#include <fcntl.h>
+#include <linux/if.h>
+#include <linux/if_tun.h>
+#include <sys/ioctl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace llarp
+{
+  namespace vnet
+  {
+    namespace
+    {
+      constexpr uint8_t IPProtoTCP = 6;
+      constexpr uint8_t IPProtoUDP = 17;
+      constexpr size_t IPv4MinHeader = 20;
+      constexpr size_t IPv6Header    = 40;
+      constexpr size_t TCPMinHeader  = 20;
+      /// where the checksum sits in a udp header
+      constexpr uint16_t UDPChecksumOffset = 6;
+
+      constexpr uint8_t TCPFin = 0x01;
+      constexpr uint8_t TCPPsh = 0x08;
+      constexpr uint8_t TCPCwr = 0x80;
+
+      uint16_t
+      Get16(const byte_t* ptr)
+      {
+        return (uint16_t(ptr[0]) << 8) | ptr[1];
+      }
+
+      void
+      Put16(byte_t* ptr, uint16_t val)
+      {
+        ptr[0] = val >> 8;
+        ptr[1] = val;
+      }
+
+      uint32_t
+      Get32(const byte_t* ptr)
+      {
+        return (uint32_t(Get16(ptr)) << 16) | Get16(ptr + 2);
+      }
+
+      void
+      Put32(byte_t* ptr, uint32_t val)
+      {
+        Put16(ptr, val >> 16);
+        Put16(ptr + 2, val);
+      }
+
+      /// ones complement sum of big endian words, not folded
+      uint32_t
+      Sum(const byte_t* buf, size_t sz, uint32_t sum = 0)
+      {
+        for(; sz > 1; sz -= 2, buf += 2)
+          sum += Get16(buf);
+        if(sz)
+          sum += uint32_t(*buf) << 8;
+        return sum;
+      }
+
+      uint16_t
+      Fold(uint32_t sum)
+      {
+        while(sum >> 16)
+          sum = (sum & 0xFFff) + (sum >> 16);
+        return sum;
+      }
+
+      /// a header field in the byte order the kernel uses for it
+      uint16_t
+      GetField(const byte_t* ptr, bool littleEndian)
+      {
+        if(littleEndian)
+          return uint16_t(ptr[0]) | (uint16_t(ptr[1]) << 8);
+        uint16_t val;
+        std::memcpy(&val, ptr, sizeof(val));
+        return val;
+      }
+
+      void
+      PutField(byte_t* ptr, uint16_t val, bool littleEndian)
+      {
+        if(littleEndian)
+        {
+          ptr[0] = val;
+          ptr[1] = val >> 8;
+        }
+        else
+          std::memcpy(ptr, &val, sizeof(val));
+      }
+
+      bool
+      FinishChecksum(const Header& hdr, byte_t* pkt, size_t sz)
+      {
+        if(hdr.csumStart + size_t{hdr.csumOffset} + 2 > sz)
+          return false;
+        // the kernel left the pseudo header sum in the checksum field
+        uint16_t csum = ~Fold(Sum(pkt + hdr.csumStart, sz - hdr.csumStart));
+        if(csum == 0 && hdr.csumOffset == UDPChecksumOffset)
+          csum = 0xFFff;
+        Put16(pkt + hdr.csumStart + hdr.csumOffset, csum);
+        return true;
+      }
+
+      bool
+      SegmentTCP(const Header& hdr, const byte_t* pkt, size_t sz,
+                 std::vector< byte_t >& scratch, const Visit_t& visit)
+      {
+        const bool v4 = (hdr.gsoType & ~Header::GSOECN) == Header::GSOTCPv4;
+        if(sz < IPv4MinHeader || (pkt[0] >> 4) != (v4 ? 4 : 6))
+          return false;
+        size_t l3len;
+        if(v4)
+        {
+          l3len = size_t(pkt[0] & 0x0f) * 4;
+          if(l3len < IPv4MinHeader || pkt[9] != IPProtoTCP)
+            return false;
+        }
+        else
+        {
+          // no extension headers, the kernel does not gso those either
+          l3len = IPv6Header;
+          if(sz < IPv6Header || pkt[6] != IPProtoTCP)
+            return false;
+        }
+        if(sz < l3len + TCPMinHeader)
+          return false;
+        const size_t hdrs = l3len + size_t(pkt[l3len + 12] >> 4) * 4;
+        if(hdrs < l3len + TCPMinHeader || hdrs >= sz || hdr.gsoSize == 0)
+          return false;
+
+        const size_t payload = sz - hdrs;
+        const uint32_t seq   = Get32(pkt + l3len + 4);
+        const uint16_t ipid  = v4 ? Get16(pkt + 4) : 0;
+        scratch.resize(hdrs + hdr.gsoSize);
+        byte_t* seg = scratch.data();
+        std::copy_n(pkt, hdrs, seg);
+        byte_t* tcp = seg + l3len;
+        size_t num  = 0;
+        for(size_t off = 0; off < payload; off += hdr.gsoSize, ++num)
+        {
+          const size_t len   = std::min(size_t{hdr.gsoSize}, payload - off);
+          const size_t segsz = hdrs + len;
+          std::copy_n(pkt + hdrs + off, len, seg + hdrs);
+
+          const uint16_t tcplen = segsz - l3len;
+          uint32_t pseudo       = IPProtoTCP + tcplen;
+          if(v4)
+          {
+            Put16(seg + 2, segsz);
+            Put16(seg + 4, ipid + num);
+            Put16(seg + 10, 0);
+            Put16(seg + 10, ~Fold(Sum(seg, l3len)));
+            pseudo = Sum(seg + 12, 8, pseudo);
+          }
+          else
+          {
+            Put16(seg + 4, tcplen);
+            pseudo = Sum(seg + 8, 32, pseudo);
+          }
+
+          Put32(tcp + 4, seq + off);
+          tcp[13] = pkt[l3len + 13];
+          if(off + len < payload)
+            tcp[13] &= ~(TCPFin | TCPPsh);
+          if(num > 0)
+            tcp[13] &= ~TCPCwr;
+          Put16(tcp + 16, 0);
+          Put16(tcp + 16, ~Fold(Sum(tcp, tcplen, pseudo)));
+
+          visit(llarp_buffer_t(seg, segsz));
+        }
+        return true;
+      }
+    }  // namespace
+
+    bool
+    Header::Decode(const byte_t* buf, size_t sz, bool littleEndian)
+    {
+      if(sz < SIZE)
+        return false;
+      flags      = buf[0];
+      gsoType    = buf[1];
+      hdrLen     = GetField(buf + 2, littleEndian);
+      gsoSize    = GetField(buf + 4, littleEndian);
+      csumStart  = GetField(buf + 6, littleEndian);
+      csumOffset = GetField(buf + 8, littleEndian);
+      return true;
+    }
+
+    void
+    Header::Encode(byte_t* buf, bool littleEndian) const
+    {
+      buf[0] = flags;
+      buf[1] = gsoType;
+      PutField(buf + 2, hdrLen, littleEndian);
+      PutField(buf + 4, gsoSize, littleEndian);
+      PutField(buf + 6, csumStart, littleEndian);
+      PutField(buf + 8, csumOffset, littleEndian);
+    }
+
+    bool
+    Segment(const Header& hdr, byte_t* pkt, size_t sz,
+            std::vector< byte_t >& scratch, const Visit_t& visit)
+    {
+      switch(hdr.gsoType & ~Header::GSOECN)
+      {
+        case Header::GSONone:
+          if((hdr.flags & Header::NeedsChecksum)
+             && not FinishChecksum(hdr, pkt, sz))
+            return false;
+          visit(llarp_buffer_t(pkt, sz));
+          return true;
+        case Header::GSOTCPv4:
+        case Header::GSOTCPv6:
+          return SegmentTCP(hdr, pkt, sz, scratch, visit);
+        default:
+          return false;
+      }
+    }
+
+    uint32_t
+    FlowHash(const byte_t* pkt, size_t sz)
+    {
+      // fnv-1a over the bytes that tell flows apart
+      uint32_t hash = 2166136261u;
+      auto mix      = [&hash](const byte_t* buf, size_t len) {
+        for(size_t idx = 0; idx < len; ++idx)
+          hash = (hash ^ buf[idx]) * 16777619u;
+      };
+      size_t l4     = 0;
+      uint8_t proto = 0;
+      if(sz >= IPv4MinHeader && (pkt[0] >> 4) == 4)
+      {
+        proto = pkt[9];
+        mix(pkt + 9, 1);
+        mix(pkt + 12, 8);
+        // later fragments carry no ports
+        if((Get16(pkt + 6) & 0x1FFf) == 0)
+          l4 = size_t{pkt[0] & 0x0F} * 4;
+      }
+      else if(sz >= IPv6Header && (pkt[0] >> 4) == 6)
+      {
+        proto = pkt[6];
+        mix(pkt + 6, 1);
+        mix(pkt + 8, 32);
+        l4 = IPv6Header;
+      }
+      if(l4 && (proto == IPProtoTCP || proto == IPProtoUDP) && l4 + 4 <= sz)
+        mix(pkt + l4, 4);
+      return hash;
+    }
+
+#ifdef LLARP_TUN_VNET
+    bool
+    OpenQueues(char* ifname, size_t num, std::vector< int >& fds,
+               bool& littleEndian)
+    {
+      ifreq ifr;
+      std::memset(&ifr, 0, sizeof(ifr));
+      ifr.ifr_flags = IFF_TUN | IFF_NO_PI | IFF_VNET_HDR | IFF_MULTI_QUEUE;
+      std::strncpy(ifr.ifr_name, ifname, IFNAMSIZ - 1);
+      const unsigned long offloads =
+          TUN_F_CSUM | TUN_F_TSO4 | TUN_F_TSO6 | TUN_F_TSO_ECN;
+      const size_t start = fds.size();
+      for(size_t idx = 0; idx < std::max(num, size_t{1}); ++idx)
+      {
+        const int fd = open("/dev/net/tun", O_RDWR | O_NONBLOCK | O_CLOEXEC);
+        // the first queue fills in the name the others attach to
+        if(fd == -1 || ioctl(fd, TUNSETIFF, &ifr) == -1
+           || ioctl(fd, TUNSETOFFLOAD, offloads) == -1)
+        {
+          if(fd != -1)
+            close(fd);
+          for(size_t opened = start; opened < fds.size(); ++opened)
+            close(fds[opened]);
+          fds.resize(start);
+          return false;
+        }
+        fds.emplace_back(fd);
+      }
+      std::memcpy(ifname, ifr.ifr_name, IFNAMSIZ);
+      // the order belongs to the device, so asking on one queue is enough
+      int little   = 1;
+      littleEndian = ioctl(fds[start], TUNSETVNETLE, &little) != -1;
+      return true;
+    }
+
+    bool
+    Write(int fd, const byte_t* pkt, size_t sz, bool littleEndian)
+    {
+      byte_t none[Header::SIZE];
+      Header{}.Encode(none, littleEndian);
+      iovec iov[2];
+      iov[0].iov_base = none;
+      iov[0].iov_len  = Header::SIZE;
+      iov[1].iov_base = const_cast< byte_t* >(pkt);
+      iov[1].iov_len  = sz;
+      return writev(fd, iov, 2) == ssize_t(Header::SIZE + sz);
+    }
+#endif
+  }  // namespace vnet
+}  // namespace llarp
@@ -0,0 +1,89 @@
+#ifndef LLARP_EV_VNET_HPP
+#define LLARP_EV_VNET_HPP
+
+#include <util/buffer.hpp>
+#include <util/types.hpp>
+
+#include <functional>
+#include <vector>
+
+#if defined(__linux__) && !defined(ANDROID)
+#define LLARP_TUN_VNET 1
+#endif
+
+namespace llarp
+{
+  namespace vnet
+  {
+    /// the virtio_net_hdr a tun opened with IFF_VNET_HDR puts in front of
+    /// every packet. the fields are kept in host byte order here and are
+    /// little endian or host order on the wire, see OpenQueues
+    struct Header
+    {
+      static constexpr size_t SIZE = 10;
+
+      /// csumStart and csumOffset are set, the checksum still needs finishing
+      static constexpr uint8_t NeedsChecksum = 1;
+
+      static constexpr uint8_t GSONone  = 0;
+      static constexpr uint8_t GSOTCPv4 = 1;
+      static constexpr uint8_t GSOTCPv6 = 4;
+      /// or'd into gsoType when the super packet has CWR set
+      static constexpr uint8_t GSOECN = 0x80;
+
+      uint8_t flags       = 0;
+      uint8_t gsoType     = GSONone;
+      uint16_t hdrLen     = 0;
+      uint16_t gsoSize    = 0;
+      uint16_t csumStart  = 0;
+      uint16_t csumOffset = 0;
+
+      bool
+      Decode(const byte_t* buf, size_t sz, bool littleEndian);
+
+      void
+      Encode(byte_t* buf, bool littleEndian) const;
+    };
+
+    /// most queues the kernel lets one tun have
+    static constexpr size_t MaxQueues = 256;
+
+    /// biggest read a vnet tun hands us, header and one gso super packet
+    static constexpr size_t MaxReadSize = Header::SIZE + 65535;
+
+    using Visit_t = std::function< void(const llarp_buffer_t&) >;
+
+    /// hand every ip packet in pkt to visit
+    ///
+    /// gso super packets are cut into segments of at most gsoSize bytes of
+    /// tcp payload with their own headers and checksums, built one at a time
+    /// in scratch. a partial checksum on anything else is finished in place.
+    /// returns false if pkt is malformed or uses an offload we never enable
+    bool
+    Segment(const Header& hdr, byte_t* pkt, size_t sz,
+            std::vector< byte_t >& scratch, const Visit_t& visit);
+
+    /// hash of the addresses, protocol and ports of ip packet pkt, the same
+    /// for every packet of a flow. used to keep a flow on one tun queue
+    uint32_t
+    FlowHash(const byte_t* pkt, size_t sz);
+
+#ifdef LLARP_TUN_VNET
+    /// open num nonblocking queues on tun ifname with vnet headers and
+    /// checksum and tso offload. ifname is IFNAMSIZ bytes; if it is empty the
+    /// kernel picks a name and we write it back. littleEndian is set if the
+    /// kernel took our ask for little endian headers, kernels that predate
+    /// it use host order. on failure every queue we opened is closed again
+    /// and false is returned
+    bool
+    OpenQueues(char* ifname, size_t num, std::vector< int >& fds,
+               bool& littleEndian);
+
+    /// write one ip packet without offloads to a vnet tun queue
+    bool
+    Write(int fd, const byte_t* pkt, size_t sz, bool littleEndian);
+#endif
+  }  // namespace vnet
+}  // namespace llarp
+
+#endif
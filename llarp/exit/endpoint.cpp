@@ -136,7 +136,7 @@ namespace llarp
       {
         return false;
       }
-      m_UpstreamQueue.emplace(pkt, counter);
+      m_UpstreamQueue.emplace(std::move(pkt), counter);
       m_TxRate += buf.underlying.sz;
       m_LastActive = m_Parent->Now();
       return true;
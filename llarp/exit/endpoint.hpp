@@ -121,8 +121,8 @@ namespace llarp
 
       struct UpstreamBuffer
       {
-        UpstreamBuffer(const llarp::net::IPPacket& p, uint64_t c)
-            : pkt(p), counter(c)
+        UpstreamBuffer(llarp::net::IPPacket p, uint64_t c)
+            : pkt(std::move(p)), counter(c)
         {
         }
 
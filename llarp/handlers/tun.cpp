@@ -10,6 +10,7 @@
 
 #include <dns/dns.hpp>
 #include <ev/ev.hpp>
+#include <ev/vnet.hpp>
 #include <router/abstractrouter.hpp>
 #include <service/context.hpp>
 #include <util/meta/memfn.hpp>
@@ -282,6 +283,17 @@ namespace llarp
         llarp::LogInfo(Name() + " setting ifname to ", tunif->ifname);
         return true;
       }
+      if(k == "tun-queues" && tunif)
+      {
+        const int num = std::atoi(v.c_str());
+        if(num < 1 || size_t(num) > vnet::MaxQueues)
+        {
+          llarp::LogError(Name() + " bad tun-queues value: ", v);
+          return false;
+        }
+        tunif->queues = num;
+        return true;
+      }
       if(k == "ifaddr" && tunif)
       {
         std::string addr;
@@ -734,7 +746,7 @@ namespace llarp
           if(impl->reader.queue.full())
             return true;
           // queue to reader
-          impl->reader.queue.pushBack(pkt);
+          impl->reader.queue.pushBack(std::move(pkt));
           return false;
         };
         // event loop ticker
@@ -750,7 +762,7 @@ namespace llarp
               // queue it to be sent over lokinet
               auto pkt = impl->writer.queue.popFront();
               if(running)
-                ep->m_UserToNetworkPktQueue.Emplace(pkt);
+                ep->m_UserToNetworkPktQueue.Emplace(std::move(pkt));
             }
           }
 
@@ -912,14 +924,12 @@ namespace llarp
             if(pkt.IsV4() && !llarp::IsIPv4Bogon(pkt.dstv4()))
             {
               pkt.UpdateIPv4Address({0}, xhtonl(pkt.dstv4()));
-              exit->QueueUpstreamTraffic(std::move(pkt),
-                                         llarp::routing::ExitPadSize);
+              exit->QueueUpstreamTraffic(pkt, llarp::routing::ExitPadSize);
             }
             else if(pkt.IsV6())
             {
               pkt.UpdateIPv6Address({0}, pkt.dstv6());
-              exit->QueueUpstreamTraffic(std::move(pkt),
-                                         llarp::routing::ExitPadSize);
+              exit->QueueUpstreamTraffic(pkt, llarp::routing::ExitPadSize);
             }
           }
           return;
@@ -942,7 +952,7 @@ namespace llarp
         else
           pkt.UpdateIPv6Address({0}, {0});
 
-        if(sendFunc && sendFunc(pkt.Buffer()))
+        if(sendFunc && sendFunc(pkt.ConstBuffer()))
         {
           MarkIPActive(dst);
           return;
@@ -1102,7 +1112,7 @@ namespace llarp
           self->m_UserToNetworkPktQueue.Emplace(pkt);
         }
         self->FlushToUser([self, tun](net::IPPacket &pkt) -> bool {
-          if(!llarp_ev_tun_async_write(tun, pkt.Buffer()))
+          if(!llarp_ev_tun_async_write(tun, pkt.ConstBuffer()))
           {
             llarp::LogWarn(self->Name(), " packet dropped");
             return true;
@@ -1120,7 +1130,7 @@ namespace llarp
       net::IPPacket pkt;
       if(not pkt.Load(b))
         return;
-      self->m_TunPkts.emplace_back(pkt);
+      self->m_TunPkts.emplace_back(std::move(pkt));
     }
 
     TunEndpoint::~TunEndpoint() = default;
@@ -0,0 +1,326 @@
+#include <iwp/congestion.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace llarp
+{
+  namespace iwp
+  {
+    namespace
+    {
+      /// how much pacing credit an idle sender may build up
+      constexpr uint64_t PacingBurstMicros = 10000;
+
+      uint64_t
+      Micros(llarp_time_t t)
+      {
+        return uint64_t(t.count()) * 1000;
+      }
+    }  // namespace
+
+    constexpr size_t CongestionControl::SegmentSize;
+    constexpr size_t CongestionControl::InitialWindow;
+    constexpr size_t CongestionControl::MinWindow;
+    constexpr llarp_time_t CongestionControl::InitialRTO;
+    constexpr llarp_time_t CongestionControl::MinRTO;
+    constexpr llarp_time_t CongestionControl::MaxRTO;
+    constexpr llarp_time_t CongestionControl::MinRTTWindow;
+
+    bool
+    CongestionControl::CanSend(size_t sz, llarp_time_t now) const
+    {
+      // always allow one message out so a tiny window cannot stall us
+      if(m_InFlight > 0 && m_InFlight + sz > Window())
+        return false;
+      return m_NextSendAt <= Micros(now);
+    }
+
+    void
+    CongestionControl::OnSend(SendState& st, size_t sz, llarp_time_t now)
+    {
+      st.sentAt        = now;
+      st.delivered     = m_Delivered;
+      st.deliveredAt   = m_LastAckAt == 0s ? now : m_LastAckAt;
+      st.firstSentAt   = m_LastAckAt == 0s ? now : m_LastAckedSentAt;
+      st.retransmitted = false;
+      m_InFlight += sz;
+      const auto rate = PacingRate();
+      if(rate == 0)
+        return;
+      const uint64_t nowUs = Micros(now);
+      const uint64_t base  = std::max(
+          m_NextSendAt,
+          nowUs > PacingBurstMicros ? nowUs - PacingBurstMicros : 0);
+      m_NextSendAt = base + (sz * 1000000) / rate;
+    }
+
+    void
+    CongestionControl::OnAck(const SendState& st, size_t sz, llarp_time_t now)
+    {
+      m_InFlight -= std::min(sz, m_InFlight);
+      m_Delivered += sz;
+      m_LastAckAt       = now;
+      m_LastAckedSentAt = st.sentAt;
+
+      // karn: a resent message does not tell us which send got acked
+      llarp_time_t rtt = 0s;
+      if(not st.retransmitted)
+      {
+        rtt = std::max(now - st.sentAt, llarp_time_t{1});
+        if(m_SRTT == 0s)
+        {
+          m_SRTT   = rtt;
+          m_RTTVar = rtt / 2;
+        }
+        else
+        {
+          const auto delta = m_SRTT > rtt ? m_SRTT - rtt : rtt - m_SRTT;
+          m_RTTVar         = (m_RTTVar * 3 + delta) / 4;
+          m_SRTT           = (m_SRTT * 7 + rtt) / 8;
+        }
+        if(m_MinRTT == 0s || rtt <= m_MinRTT
+           || now - m_MinRTTAt > MinRTTWindow)
+        {
+          m_MinRTT   = rtt;
+          m_MinRTTAt = now;
+        }
+      }
+
+      // the slower of the send and ack rates over the interval, so acks
+      // bunched up on the way back cannot overstate what the path carries
+      const auto interval =
+          std::max(now - st.deliveredAt, st.sentAt - st.firstSentAt);
+      uint64_t rate = 0;
+      if(interval > 0s)
+        rate = ((m_Delivered - st.delivered) * 1000) / interval.count();
+      HandleAck(st, sz, rtt, rate, now);
+    }
+
+    void
+    CongestionControl::OnRetransmit(SendState& st, size_t lost,
+                                    llarp_time_t now)
+    {
+      st.retransmitted = true;
+      HandleLoss(lost, now);
+    }
+
+    void
+    CongestionControl::OnDrop(size_t sz, llarp_time_t now)
+    {
+      m_InFlight -= std::min(sz, m_InFlight);
+      HandleLoss(sz, now);
+    }
+
+    llarp_time_t
+    CongestionControl::RTO() const
+    {
+      if(m_SRTT == 0s)
+        return InitialRTO;
+      const auto rto = m_SRTT + std::max(m_RTTVar * 4, llarp_time_t{10});
+      return std::min(std::max(rto, MinRTO), MaxRTO);
+    }
+
+    size_t
+    CongestionControl::BDP(uint64_t rate) const
+    {
+      return (rate * uint64_t(m_MinRTT.count())) / 1000;
+    }
+
+    util::StatusObject
+    CongestionControl::ExtractStatus() const
+    {
+      return util::StatusObject{{"algorithm", Name()},
+                                {"window", Window()},
+                                {"pacingRate", PacingRate()},
+                                {"inFlight", m_InFlight},
+                                {"delivered", m_Delivered},
+                                {"srtt", to_json(m_SRTT)},
+                                {"minRTT", to_json(m_MinRTT)},
+                                {"rto", to_json(RTO())}};
+    }
+
+    std::unique_ptr< CongestionControl >
+    CongestionControl::Create(string_view name)
+    {
+      if(name == "cubic")
+        return std::make_unique< CubicCongestion >();
+      if(name == "bbr")
+        return std::make_unique< BBRCongestion >();
+      return nullptr;
+    }
+
+    uint64_t
+    CubicCongestion::PacingRate() const
+    {
+      const auto srtt = SmoothedRTT();
+      if(srtt == 0s)
+        return 0;
+      const double gain = m_Window < m_SSThresh ? 2.0 : 1.2;
+      return uint64_t(gain * m_Window * 1000) / uint64_t(srtt.count());
+    }
+
+    void
+    CubicCongestion::HandleAck(const SendState&, size_t sz, llarp_time_t,
+                               uint64_t, llarp_time_t now)
+    {
+      if(m_Window < m_SSThresh)
+      {
+        m_Window += sz;
+        return;
+      }
+      const double cwnd = double(m_Window) / SegmentSize;
+      if(m_EpochStart == 0s)
+      {
+        m_EpochStart = now;
+        if(cwnd < m_WindowMax)
+          m_K = std::cbrt((m_WindowMax - cwnd) / C);
+        else
+        {
+          m_K         = 0;
+          m_WindowMax = cwnd;
+        }
+      }
+      const double t =
+          double((now - m_EpochStart + SmoothedRTT()).count()) / 1000.0;
+      const double target = C * std::pow(t - m_K, 3) + m_WindowMax;
+      if(target > cwnd)
+        m_Window += size_t(((target - cwnd) / cwnd) * sz);
+      else
+        m_Window += std::max(size_t(1), sz / (100 * size_t(cwnd)));
+    }
+
+    void
+    CubicCongestion::HandleLoss(size_t, llarp_time_t now)
+    {
+      // one reduction per round trip
+      if(now < m_RecoveryUntil)
+        return;
+      const double cwnd = double(m_Window) / SegmentSize;
+      // fast convergence, give up share faster when the path shrinks
+      if(cwnd < m_WindowMax)
+        m_WindowMax = cwnd * (1.0 + Beta) / 2.0;
+      else
+        m_WindowMax = cwnd;
+      m_Window        = std::max(size_t(m_Window * Beta), MinWindow);
+      m_SSThresh      = m_Window;
+      m_EpochStart    = 0s;
+      m_RecoveryUntil = now + std::max(SmoothedRTT(), MinRTO);
+    }
+
+    constexpr llarp_time_t BBRCongestion::ProbeRTTDuration;
+
+    namespace
+    {
+      constexpr double ProbeGains[8] = {1.25, 0.75, 1, 1, 1, 1, 1, 1};
+    }
+
+    uint64_t
+    BBRCongestion::MaxBandwidth() const
+    {
+      return m_Bandwidth.empty() ? 0 : m_Bandwidth.front().second;
+    }
+
+    double
+    BBRCongestion::PacingGain() const
+    {
+      switch(m_Mode)
+      {
+        case Mode::Startup:
+          return HighGain;
+        case Mode::Drain:
+          return 1.0 / HighGain;
+        case Mode::ProbeRTT:
+          return 1.0;
+        default:
+          return ProbeGains[m_CycleIndex];
+      }
+    }
+
+    size_t
+    BBRCongestion::Window() const
+    {
+      const auto bw = MaxBandwidth();
+      if(bw == 0 || MinRTT() == 0s)
+        return InitialWindow;
+      if(m_Mode == Mode::ProbeRTT)
+        return 4 * SegmentSize;
+      const double gain = m_Mode == Mode::Startup ? HighGain : 2.0;
+      return std::max(size_t(BDP(bw) * gain), 4 * SegmentSize);
+    }
+
+    uint64_t
+    BBRCongestion::PacingRate() const
+    {
+      return uint64_t(MaxBandwidth() * PacingGain());
+    }
+
+    void
+    BBRCongestion::HandleAck(const SendState& st, size_t, llarp_time_t,
+                             uint64_t rate, llarp_time_t now)
+    {
+      bool roundStart = false;
+      if(st.delivered >= m_NextRoundDelivered)
+      {
+        m_NextRoundDelivered = Delivered();
+        m_Round++;
+        roundStart = true;
+      }
+      // windowed max filter over the last BandwidthWindow rounds
+      if(rate > 0)
+      {
+        while(not m_Bandwidth.empty() && m_Bandwidth.back().second <= rate)
+          m_Bandwidth.pop_back();
+        m_Bandwidth.emplace_back(m_Round, rate);
+      }
+      while(m_Bandwidth.size() > 1
+            && m_Bandwidth.front().first + BandwidthWindow < m_Round)
+        m_Bandwidth.pop_front();
+
+      const auto bw = MaxBandwidth();
+      if(m_Mode == Mode::Startup && roundStart)
+      {
+        if(bw >= m_FullBandwidth + m_FullBandwidth / 4)
+        {
+          m_FullBandwidth      = bw;
+          m_FullBandwidthCount = 0;
+        }
+        else if(++m_FullBandwidthCount >= 3)
+          m_Mode = Mode::Drain;
+      }
+      if(m_Mode == Mode::Drain && BytesInFlight() <= BDP(bw))
+      {
+        m_Mode       = Mode::ProbeBW;
+        m_CycleIndex = 2;
+        m_CycleStart = now;
+      }
+      if(m_Mode == Mode::ProbeBW
+         && now - m_CycleStart > std::max(MinRTT(), llarp_time_t{1}))
+      {
+        m_CycleIndex = (m_CycleIndex + 1) % 8;
+        m_CycleStart = now;
+      }
+      // every so often drain the queue we built so min rtt can't creep up
+      if(m_ProbeRTTAt == 0s)
+        m_ProbeRTTAt = now;
+      if(m_Mode == Mode::ProbeBW && now - m_ProbeRTTAt > MinRTTWindow)
+      {
+        m_Mode       = Mode::ProbeRTT;
+        m_ProbeRTTAt = now;
+      }
+      else if(m_Mode == Mode::ProbeRTT
+              && now - m_ProbeRTTAt > std::max(ProbeRTTDuration, MinRTT()))
+      {
+        m_Mode       = Mode::ProbeBW;
+        m_ProbeRTTAt = now;
+        m_CycleStart = now;
+      }
+    }
+
+    void
+    BBRCongestion::HandleLoss(size_t, llarp_time_t)
+    {
+      // the model only listens to rate and delay
+    }
+  }  // namespace iwp
+}  // namespace llarp
@@ -0,0 +1,252 @@
+#ifndef LLARP_IWP_CONGESTION_HPP
+#define LLARP_IWP_CONGESTION_HPP
+
+#include <util/status.hpp>
+#include <util/string_view.hpp>
+#include <util/time.hpp>
+#include <util/types.hpp>
+
+#include <deque>
+#include <memory>
+#include <string>
+
+namespace llarp
+{
+  namespace iwp
+  {
+    /// congestion control for one iwp session
+    ///
+    /// the session tells it when messages go out, get acked, get resent or
+    /// are given up on. the base keeps the rtt estimate, the retransmit
+    /// timeout, bytes in flight and delivery rate samples; implementations
+    /// turn those into a send window and a pacing rate.
+    struct CongestionControl
+    {
+      /// segment size the window math is done in
+      static constexpr size_t SegmentSize = 1024;
+      /// window before we know anything about the path
+      static constexpr size_t InitialWindow = 10 * SegmentSize;
+      /// smallest window we ever shrink to
+      static constexpr size_t MinWindow = 2 * SegmentSize;
+      /// rto before the first rtt sample
+      static constexpr llarp_time_t InitialRTO = 400ms;
+      static constexpr llarp_time_t MinRTO     = 100ms;
+      /// past this the message is close to timing out anyways
+      static constexpr llarp_time_t MaxRTO = 400ms;
+      /// how long a min rtt sample stays valid
+      static constexpr llarp_time_t MinRTTWindow = 10s;
+
+      /// what we knew when a message went out, kept with the message
+      struct SendState
+      {
+        llarp_time_t sentAt      = 0s;
+        uint64_t delivered       = 0;
+        llarp_time_t deliveredAt = 0s;
+        /// send time of the last acked message when this one went out
+        llarp_time_t firstSentAt = 0s;
+        bool retransmitted       = false;
+      };
+
+      virtual ~CongestionControl() = default;
+
+      virtual const char*
+      Name() const = 0;
+
+      /// bytes we may have in flight
+      virtual size_t
+      Window() const = 0;
+
+      /// bytes per second we pace sends at, 0 for unpaced
+      virtual uint64_t
+      PacingRate() const = 0;
+
+      /// return true if sz more bytes may go out right now
+      bool
+      CanSend(size_t sz, llarp_time_t now) const;
+
+      /// a message of sz bytes went out for the first time
+      void
+      OnSend(SendState& st, size_t sz, llarp_time_t now);
+
+      /// a message sent with st of sz bytes got acked
+      void
+      OnAck(const SendState& st, size_t sz, llarp_time_t now);
+
+      /// lost bytes of a message in flight were resent after the rto fired
+      void
+      OnRetransmit(SendState& st, size_t lost, llarp_time_t now);
+
+      /// a message of sz bytes in flight was given up on
+      void
+      OnDrop(size_t sz, llarp_time_t now);
+
+      llarp_time_t
+      SmoothedRTT() const
+      {
+        return m_SRTT;
+      }
+
+      llarp_time_t
+      MinRTT() const
+      {
+        return m_MinRTT;
+      }
+
+      llarp_time_t
+      RTO() const;
+
+      size_t
+      BytesInFlight() const
+      {
+        return m_InFlight;
+      }
+
+      /// total bytes acked
+      uint64_t
+      Delivered() const
+      {
+        return m_Delivered;
+      }
+
+      util::StatusObject
+      ExtractStatus() const;
+
+      /// make a controller by name, nullptr if there is no such algorithm
+      static std::unique_ptr< CongestionControl >
+      Create(string_view name);
+
+      /// algorithm links use unless told otherwise
+      static constexpr const char* DefaultAlgorithm = "bbr";
+
+     protected:
+      /// new ack with an rtt sample (0 if unusable) and a delivery rate in
+      /// bytes per second (0 if unusable)
+      virtual void
+      HandleAck(const SendState& st, size_t sz, llarp_time_t rtt,
+                uint64_t rate, llarp_time_t now) = 0;
+
+      /// sz bytes were lost
+      virtual void
+      HandleLoss(size_t sz, llarp_time_t now) = 0;
+
+      /// bandwidth delay product for a rate in bytes per second
+      size_t
+      BDP(uint64_t rate) const;
+
+     private:
+      llarp_time_t m_SRTT            = 0s;
+      llarp_time_t m_RTTVar          = 0s;
+      llarp_time_t m_MinRTT          = 0s;
+      llarp_time_t m_MinRTTAt        = 0s;
+      size_t m_InFlight              = 0;
+      uint64_t m_Delivered           = 0;
+      llarp_time_t m_LastAckAt       = 0s;
+      llarp_time_t m_LastAckedSentAt = 0s;
+      /// earliest time the pacer lets the next send out, in microseconds
+      uint64_t m_NextSendAt = 0;
+    };
+
+    /// loss based cubic window growth (RFC 8312 without the tcp friendly
+    /// region), paced a little above cwnd / srtt
+    struct CubicCongestion final : public CongestionControl
+    {
+      static constexpr double Beta = 0.7;
+      static constexpr double C    = 0.4;
+
+      const char*
+      Name() const override
+      {
+        return "cubic";
+      }
+
+      size_t
+      Window() const override
+      {
+        return m_Window;
+      }
+
+      uint64_t
+      PacingRate() const override;
+
+     protected:
+      void
+      HandleAck(const SendState& st, size_t sz, llarp_time_t rtt,
+                uint64_t rate, llarp_time_t now) override;
+
+      void
+      HandleLoss(size_t sz, llarp_time_t now) override;
+
+     private:
+      size_t m_Window           = InitialWindow;
+      size_t m_SSThresh         = ~size_t{0};
+      double m_WindowMax        = 0;
+      double m_K                = 0;
+      llarp_time_t m_EpochStart = 0s;
+      /// losses before this are part of the reduction we already did
+      llarp_time_t m_RecoveryUntil = 0s;
+    };
+
+    /// delay based model of the path after bbr v1: paces at the max
+    /// delivery rate seen and keeps about two bdp in flight, ignoring loss
+    struct BBRCongestion final : public CongestionControl
+    {
+      static constexpr double HighGain = 2.885;
+      /// rounds the max bandwidth filter spans
+      static constexpr uint64_t BandwidthWindow = 10;
+      /// how long we drain the queue to get a fresh min rtt sample
+      static constexpr llarp_time_t ProbeRTTDuration = 200ms;
+
+      const char*
+      Name() const override
+      {
+        return "bbr";
+      }
+
+      size_t
+      Window() const override;
+
+      uint64_t
+      PacingRate() const override;
+
+     protected:
+      void
+      HandleAck(const SendState& st, size_t sz, llarp_time_t rtt,
+                uint64_t rate, llarp_time_t now) override;
+
+      void
+      HandleLoss(size_t sz, llarp_time_t now) override;
+
+     private:
+      enum class Mode
+      {
+        Startup,
+        Drain,
+        ProbeBW,
+        ProbeRTT
+      };
+
+      uint64_t
+      MaxBandwidth() const;
+
+      double
+      PacingGain() const;
+
+      Mode m_Mode = Mode::Startup;
+      /// round trips counted in delivered bytes
+      uint64_t m_Round              = 0;
+      uint64_t m_NextRoundDelivered = 0;
+      /// (round, rate) samples for the windowed max filter
+      std::deque< std::pair< uint64_t, uint64_t > > m_Bandwidth;
+      /// startup exits once bandwidth stops growing for 3 rounds
+      uint64_t m_FullBandwidth      = 0;
+      uint64_t m_FullBandwidthCount = 0;
+      /// probe bw gain cycle
+      size_t m_CycleIndex       = 0;
+      llarp_time_t m_CycleStart = 0s;
+      /// when we last went into or came out of probe rtt
+      llarp_time_t m_ProbeRTTAt = 0s;
+    };
+  }  // namespace iwp
+}  // namespace llarp
+
+#endif
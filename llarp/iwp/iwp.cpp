@@ -12,11 +12,12 @@ namespace llarp
                    LinkMessageHandler h, SignBufferFunc sign,
                    SessionEstablishedHandler est,
                    SessionRenegotiateHandler reneg, TimeoutHandler timeout,
-                   SessionClosedHandler closed, PumpDoneHandler pumpDone)
+                   SessionClosedHandler closed, PumpDoneHandler pumpDone,
+                   std::string congestion)
     {
       return std::make_shared< LinkLayer >(keyManager, getrc, h, sign, est,
                                            reneg, timeout, closed, pumpDone,
-                                           true);
+                                           std::move(congestion), true);
     }
 
     LinkLayer_ptr
@@ -24,11 +25,12 @@ namespace llarp
                     LinkMessageHandler h, SignBufferFunc sign,
                     SessionEstablishedHandler est,
                     SessionRenegotiateHandler reneg, TimeoutHandler timeout,
-                    SessionClosedHandler closed, PumpDoneHandler pumpDone)
+                    SessionClosedHandler closed, PumpDoneHandler pumpDone,
+                    std::string congestion)
     {
       return std::make_shared< LinkLayer >(keyManager, getrc, h, sign, est,
                                            reneg, timeout, closed, pumpDone,
-                                           false);
+                                           std::move(congestion), false);
     }
   }  // namespace iwp
 }  // namespace llarp
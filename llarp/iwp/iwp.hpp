@@ -4,6 +4,7 @@
 #include <link/server.hpp>
 #include <iwp/linklayer.hpp>
 #include <memory>
+#include <string>
 #include <config/key_manager.hpp>
 
 namespace llarp
@@ -15,13 +16,15 @@ namespace llarp
                    LinkMessageHandler h, SignBufferFunc sign,
                    SessionEstablishedHandler est,
                    SessionRenegotiateHandler reneg, TimeoutHandler timeout,
-                   SessionClosedHandler closed, PumpDoneHandler pumpDone);
+                   SessionClosedHandler closed, PumpDoneHandler pumpDone,
+                   std::string congestion);
     LinkLayer_ptr
     NewOutboundLink(std::shared_ptr< KeyManager > keyManager, GetRCFunc getrc,
                     LinkMessageHandler h, SignBufferFunc sign,
                     SessionEstablishedHandler est,
                     SessionRenegotiateHandler reneg, TimeoutHandler timeout,
-                    SessionClosedHandler closed, PumpDoneHandler pumpDone);
+                    SessionClosedHandler closed, PumpDoneHandler pumpDone,
+                    std::string congestion);
 
   }  // namespace iwp
 }  // namespace llarp
@@ -13,10 +13,15 @@ namespace llarp
                          SignBufferFunc sign, SessionEstablishedHandler est,
                          SessionRenegotiateHandler reneg,
                          TimeoutHandler timeout, SessionClosedHandler closed,
-                         PumpDoneHandler pumpDone, bool allowInbound)
+                         PumpDoneHandler pumpDone, std::string congestion,
+                         bool allowInbound)
         : ILinkLayer(keyManager, getrc, h, sign, est, reneg, timeout, closed,
                      pumpDone)
         , permitInbound{allowInbound}
+        , m_CongestionControl{std::move(congestion)}
+        , m_Plaintext{PlaintextQueueSize, [](PlaintextBatch batch) {
+          batch.session->HandlePlaintext(batch.pkts);
+        }}
     {
     }
 
@@ -40,6 +45,22 @@ namespace llarp
       m_Worker->addJob(func);
     }
 
+    void
+    LinkLayer::QueuePlaintext(std::shared_ptr< Session > session,
+                              std::vector< ILinkSession::Packet_t > pkts)
+    {
+      m_Plaintext.Push(logic(),
+                       PlaintextBatch{std::move(session), std::move(pkts)});
+    }
+
+    util::StatusObject
+    LinkLayer::ExtractStatus() const
+    {
+      auto status              = ILinkLayer::ExtractStatus();
+      status["plaintextQueue"] = m_Plaintext.ExtractStatus();
+      return status;
+    }
+
     void
     LinkLayer::RecvFrom(const Addr& from, ILinkSession::Packet_t pkt)
     {
@@ -54,7 +75,9 @@ namespace llarp
           if(not permitInbound)
             return;
           isNewSession = true;
-          m_Pending.insert({from, std::make_shared< Session >(this, from)});
+          auto cc      = CongestionControl::Create(m_CongestionControl);
+          m_Pending.insert(
+              {from, std::make_shared< Session >(this, from, std::move(cc))});
         }
         session = m_Pending.find(from)->second;
       }
@@ -95,7 +118,8 @@ namespace llarp
     LinkLayer::NewOutboundSession(const RouterContact& rc,
                                   const AddressInfo& ai)
     {
-      return std::make_shared< Session >(this, rc, ai);
+      return std::make_shared< Session >(
+          this, rc, ai, CongestionControl::Create(m_CongestionControl));
     }
   }  // namespace iwp
 }  // namespace llarp
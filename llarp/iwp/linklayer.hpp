@@ -6,22 +6,37 @@
 #include <crypto/encrypted.hpp>
 #include <crypto/types.hpp>
 #include <link/server.hpp>
+#include <util/thread/logic_queue.hpp>
 #include <util/thread/thread_pool.hpp>
 #include <config/key_manager.hpp>
 
 #include <memory>
+#include <string>
 
 namespace llarp
 {
   namespace iwp
   {
+    struct Session;
+
+    /// packets of one session a crypto worker decrypted
+    struct PlaintextBatch
+    {
+      std::shared_ptr< Session > session;
+      std::vector< ILinkSession::Packet_t > pkts;
+    };
+
+    /// most decrypted batches waiting for the logic thread
+    static constexpr size_t PlaintextQueueSize = 1024;
+
     struct LinkLayer final : public ILinkLayer
     {
       LinkLayer(std::shared_ptr< KeyManager > keyManager, GetRCFunc getrc,
                 LinkMessageHandler h, SignBufferFunc sign,
                 SessionEstablishedHandler est, SessionRenegotiateHandler reneg,
                 TimeoutHandler timeout, SessionClosedHandler closed,
-                PumpDoneHandler pumpDone, bool permitInbound);
+                PumpDoneHandler pumpDone, std::string congestion,
+                bool permitInbound);
 
       ~LinkLayer() override;
 
@@ -47,9 +62,20 @@ namespace llarp
       void
       QueueWork(std::function< void(void) > work);
 
+      /// hand decrypted packets from a crypto worker to the logic thread
+      void
+      QueuePlaintext(std::shared_ptr< Session > session,
+                     std::vector< ILinkSession::Packet_t > pkts);
+
+      util::StatusObject
+      ExtractStatus() const override;
+
      private:
       std::unordered_map< Addr, RouterID, Addr::Hash > m_AuthedAddrs;
       const bool permitInbound;
+      /// congestion control algorithm our sessions use
+      const std::string m_CongestionControl;
+      LogicQueue< PlaintextBatch > m_Plaintext;
     };
 
     using LinkLayer_ptr = std::shared_ptr< LinkLayer >;
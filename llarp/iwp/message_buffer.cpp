@@ -22,7 +22,8 @@ namespace llarp
     ILinkSession::Packet_t
     OutboundMessage::XMIT() const
     {
-      size_t extra = std::min(m_Data.size(), FragmentSize);
+      // the first fragment also tells the remote our fragment size
+      size_t extra = std::min(m_Data.size(), m_FragSize);
       auto xmit    = CreatePacket(Command::eXMIT, 10 + 32 + extra, 0, 0);
       htobe16buf(xmit.data() + CommandOverhead + PacketOverhead, m_Data.size());
       htobe64buf(xmit.data() + 2 + CommandOverhead + PacketOverhead, m_MsgID);
@@ -33,6 +34,26 @@ namespace llarp
       return xmit;
     }
 
+    void
+    OutboundMessage::Start(SendPacket_t sendpkt, llarp_time_t now,
+                           bool firstInXMIT)
+    {
+      sendpkt(XMIT());
+      size_t idx = 0;
+      if(firstInXMIT)
+      {
+        m_FragSentAt[0] = now;
+        m_FragSeq[0]    = ++m_NextSeq;
+        idx             = 1;
+      }
+      const auto numFrags = NumFragments();
+      for(; idx < numFrags; ++idx)
+      {
+        if(not m_Acks.test(idx))
+          SendFragment(sendpkt, idx, now);
+      }
+    }
+
     void
     OutboundMessage::Completed()
     {
@@ -43,51 +64,141 @@ namespace llarp
       m_Completed = nullptr;
     }
 
-    bool
-    OutboundMessage::ShouldFlush(llarp_time_t now) const
+    size_t
+    OutboundMessage::NumFragments() const
     {
-      return now - m_LastFlush >= TXFlushInterval;
+      return (m_Data.size() + m_FragSize - 1) / m_FragSize;
     }
 
     void
     OutboundMessage::Ack(byte_t bitmask)
     {
-      m_Acks = std::bitset< 8 >(bitmask);
+      OnAcked(FragmentBits_t(bitmask));
+    }
+
+    bool
+    OutboundMessage::AckRanges(const llarp_buffer_t &buf)
+    {
+      if(buf.sz < 1)
+        return false;
+      const size_t numRanges = buf.base[0];
+      if(numRanges > MaxSACKRanges || buf.sz < 1 + (numRanges * 4))
+        return false;
+      FragmentBits_t acked;
+      const byte_t *ptr = buf.base + 1;
+      for(size_t range = 0; range < numRanges; ++range)
+      {
+        const size_t begin = bufbe16toh(ptr);
+        const size_t count = bufbe16toh(ptr + 2);
+        if(begin + count > MaxFragments)
+          return false;
+        for(size_t idx = begin; idx < begin + count; ++idx)
+          acked.set(idx);
+        ptr += 4;
+      }
+      OnAcked(acked);
+      return true;
     }
 
     void
-    OutboundMessage::FlushUnAcked(
-        std::function< void(ILinkSession::Packet_t) > sendpkt, llarp_time_t now)
+    OutboundMessage::OnAcked(const FragmentBits_t &acked)
+    {
+      const auto numFrags = NumFragments();
+      for(size_t idx = 0; idx < numFrags; ++idx)
+      {
+        if(m_Acks.test(idx) || not acked.test(idx))
+          continue;
+        m_Acks.set(idx);
+        m_HighestAckedSeq = std::max(m_HighestAckedSeq, m_FragSeq[idx]);
+      }
+    }
+
+    size_t
+    OutboundMessage::SendFragment(const SendPacket_t &sendpkt, size_t idx,
+                                  llarp_time_t now)
     {
       /// overhead for a data packet in plaintext
       static constexpr size_t Overhead = 10;
-      uint16_t idx                     = 0;
-      const auto datasz                = m_Data.size();
-      while(idx < datasz)
+      const size_t offset = idx * m_FragSize;
+      const size_t fragsz = std::min(m_FragSize, m_Data.size() - offset);
+      auto frag = CreatePacket(Command::eDATA, fragsz + Overhead, 0, 0);
+      htobe16buf(frag.data() + 2 + PacketOverhead, offset);
+      htobe64buf(frag.data() + 4 + PacketOverhead, m_MsgID);
+      std::copy_n(m_Data.begin() + offset, fragsz,
+                  frag.data() + PacketOverhead + Overhead + 2);
+      sendpkt(std::move(frag));
+      m_FragSentAt[idx] = now;
+      m_FragSeq[idx]    = ++m_NextSeq;
+      return fragsz;
+    }
+
+    size_t
+    OutboundMessage::FlushUnAcked(SendPacket_t sendpkt, llarp_time_t now)
+    {
+      size_t sent         = 0;
+      const auto numFrags = NumFragments();
+      for(size_t idx = 0; idx < numFrags; ++idx)
       {
-        if(not m_Acks[idx / FragmentSize])
-        {
-          const size_t fragsz =
-              idx + FragmentSize < datasz ? FragmentSize : datasz - idx;
-          auto frag = CreatePacket(Command::eDATA, fragsz + Overhead, 0, 0);
-          htobe16buf(frag.data() + 2 + PacketOverhead, idx);
-          htobe64buf(frag.data() + 4 + PacketOverhead, m_MsgID);
-          std::copy(m_Data.begin() + idx, m_Data.begin() + idx + fragsz,
-                    frag.data() + PacketOverhead + Overhead + 2);
-          sendpkt(std::move(frag));
-        }
-        idx += FragmentSize;
+        if(not m_Acks.test(idx))
+          sent += SendFragment(sendpkt, idx, now);
       }
-      m_LastFlush = now;
+      return sent;
+    }
+
+    bool
+    OutboundMessage::ShouldFlush(llarp_time_t now, llarp_time_t rto) const
+    {
+      if(not m_Sending)
+        return false;
+      const auto numFrags = NumFragments();
+      for(size_t idx = 0; idx < numFrags; ++idx)
+      {
+        if(not m_Acks.test(idx) && now - m_FragSentAt[idx] >= rto)
+          return true;
+      }
+      return false;
+    }
+
+    size_t
+    OutboundMessage::ResendExpired(SendPacket_t sendpkt, llarp_time_t now,
+                                   llarp_time_t rto)
+    {
+      size_t sent         = 0;
+      const auto numFrags = NumFragments();
+      for(size_t idx = 0; idx < numFrags; ++idx)
+      {
+        if(not m_Acks.test(idx) && now - m_FragSentAt[idx] >= rto)
+          sent += SendFragment(sendpkt, idx, now);
+      }
+      return sent;
+    }
+
+    size_t
+    OutboundMessage::ResendLost(SendPacket_t sendpkt, llarp_time_t now,
+                                llarp_time_t reorder)
+    {
+      size_t sent         = 0;
+      const auto numFrags = NumFragments();
+      for(size_t idx = 0; idx < numFrags; ++idx)
+      {
+        // a fragment sent after this one made it, so this one most likely
+        // did not, unless it is still within the reorder window
+        if(m_Acks.test(idx) || m_FragSeq[idx] == 0
+           || m_FragSeq[idx] >= m_HighestAckedSeq
+           || now - m_FragSentAt[idx] < reorder)
+          continue;
+        sent += SendFragment(sendpkt, idx, now);
+      }
+      return sent;
     }
 
     bool
     OutboundMessage::IsTransmitted() const
     {
-      const auto sz = m_Data.size();
-      for(uint16_t idx = 0; idx < sz; idx += FragmentSize)
+      const auto numFrags = NumFragments();
+      for(size_t idx = 0; idx < numFrags; ++idx)
       {
-        if(not m_Acks.test(idx / FragmentSize))
+        if(not m_Acks.test(idx))
           return false;
       }
       return true;
@@ -111,11 +222,12 @@ namespace llarp
     }
 
     InboundMessage::InboundMessage(uint64_t msgid, uint16_t sz, ShortHash h,
-                                   llarp_time_t now)
+                                   llarp_time_t now, size_t fragsz)
         : m_Data(size_t{sz})
         , m_Digset{std::move(h)}
         , m_MsgID(msgid)
         , m_LastActiveAt{now}
+        , m_FragSize{fragsz}
     {
     }
 
@@ -130,8 +242,14 @@ namespace llarp
       }
       byte_t *dst = m_Data.data() + idx;
       std::copy_n(buf.base, buf.sz, dst);
-      m_Acks.set(idx / FragmentSize);
-      LogDebug("got fragment ", idx / FragmentSize);
+      const size_t frag = idx / m_FragSize;
+      for(size_t below = 0; below < frag; ++below)
+      {
+        if(not m_Acks.test(below))
+          m_SACKDue = true;
+      }
+      m_Acks.set(frag);
+      LogDebug("got fragment ", frag);
       m_LastActiveAt = now;
     }
 
@@ -140,23 +258,50 @@ namespace llarp
     {
       auto acks = CreatePacket(Command::eACKS, 9);
       htobe64buf(acks.data() + CommandOverhead + PacketOverhead, m_MsgID);
-      acks[PacketOverhead + 10] = AcksBitmask();
+      acks[PacketOverhead + 10] = byte_t{(byte_t)m_Acks.to_ulong()};
       return acks;
     }
 
-    byte_t
-    InboundMessage::AcksBitmask() const
+    ILinkSession::Packet_t
+    InboundMessage::SACKS() const
     {
-      return byte_t{(byte_t)m_Acks.to_ulong()};
+      const size_t numFrags = (m_Data.size() + m_FragSize - 1) / m_FragSize;
+      std::array< std::pair< uint16_t, uint16_t >, MaxSACKRanges > ranges;
+      size_t numRanges = 0;
+      size_t idx       = 0;
+      while(idx < numFrags)
+      {
+        if(not m_Acks.test(idx))
+        {
+          ++idx;
+          continue;
+        }
+        const size_t begin = idx;
+        while(idx < numFrags && m_Acks.test(idx))
+          ++idx;
+        ranges[numRanges++] = {begin, idx - begin};
+      }
+      auto sacks = CreatePacket(Command::eSACK, 9 + (numRanges * 4));
+      byte_t *ptr = sacks.data() + CommandOverhead + PacketOverhead;
+      htobe64buf(ptr, m_MsgID);
+      ptr += sizeof(uint64_t);
+      *ptr++ = numRanges;
+      for(size_t range = 0; range < numRanges; ++range)
+      {
+        htobe16buf(ptr, ranges[range].first);
+        htobe16buf(ptr + 2, ranges[range].second);
+        ptr += 4;
+      }
+      return sacks;
     }
 
     bool
     InboundMessage::IsCompleted() const
     {
       const auto sz = m_Data.size();
-      for(size_t idx = 0; idx < sz; idx += FragmentSize)
+      for(size_t idx = 0; idx < sz; idx += m_FragSize)
       {
-        if(not m_Acks.test(idx / FragmentSize))
+        if(not m_Acks.test(idx / m_FragSize))
           return false;
       }
       return true;
@@ -165,7 +310,7 @@ namespace llarp
     bool
     InboundMessage::ShouldSendACKS(llarp_time_t now) const
     {
-      return now > m_LastACKSent + ACKResendInterval;
+      return m_SACKDue || now > m_LastACKSent + ACKResendInterval;
     }
 
     bool
@@ -176,10 +321,12 @@ namespace llarp
 
     void
     InboundMessage::SendACKS(
-        std::function< void(ILinkSession::Packet_t) > sendpkt, llarp_time_t now)
+        std::function< void(ILinkSession::Packet_t) > sendpkt, llarp_time_t now,
+        bool sack)
     {
-      sendpkt(ACKS());
+      sendpkt(sack ? SACKS() : ACKS());
       m_LastACKSent = now;
+      m_SACKDue     = false;
     }
 
     bool
@@ -1,7 +1,9 @@
 #ifndef LLARP_IWP_MESSAGE_BUFFER_HPP
 #define LLARP_IWP_MESSAGE_BUFFER_HPP
+#include <array>
 #include <vector>
 #include <constants/link_layer.hpp>
+#include <iwp/congestion.hpp>
 #include <link/session.hpp>
 #include <util/aligned.hpp>
 #include <util/buffer.hpp>
@@ -19,20 +21,43 @@ namespace llarp
       eXMIT = 1,
       /// fragment data
       eDATA = 2,
-      /// acknolege fragments
+      /// acknolege fragments, one bitmask byte
       eACKS = 3,
       /// negative ack
       eNACK = 4,
       /// multiack
       eMACK = 5,
+      /// selective ack of fragment ranges
+      eSACK = 6,
+      /// padded path mtu probe
+      eMTUP = 7,
+      /// path mtu probe ack
+      eMTUA = 8,
       /// close session
       eCLOS = 0xff,
     };
 
-    /// max size of data fragments
+    /// what a session takes beyond the baseline protocol, sent as the one
+    /// byte body of a ping, older peers pad their pings and ignore the body
+    enum Capability : byte_t
+    {
+      /// takes eSACK acks and the first fragment of a message from its xmit
+      eCapSACK = 1 << 0,
+      /// answers eMTUP path mtu probes with eMTUA
+      eCapMTUP = 1 << 1,
+    };
+
+    /// size of data fragments every peer takes, path mtu discovery may let
+    /// a session use bigger ones
     static constexpr size_t FragmentSize = 1024;
     /// plaintext header overhead size
     static constexpr size_t CommandOverhead = 2;
+    /// most fragments a message can have, at the smallest fragment size
+    static constexpr size_t MaxFragments = MAX_LINK_MSG_SIZE / FragmentSize;
+    /// most ranges a selective ack can carry, every other fragment missing
+    static constexpr size_t MaxSACKRanges = (MaxFragments + 1) / 2;
+
+    using FragmentBits_t = std::bitset< MaxFragments >;
 
     struct OutboundMessage
     {
@@ -41,26 +66,62 @@ namespace llarp
                       llarp_time_t now,
                       ILinkSession::CompletionHandler handler);
 
+      using SendPacket_t = std::function< void(ILinkSession::Packet_t) >;
+
       ILinkSession::Message_t m_Data;
       uint64_t m_MsgID = 0;
-      std::bitset< MAX_LINK_MSG_SIZE / FragmentSize > m_Acks;
+      /// fixed once the message starts sending
+      size_t m_FragSize = FragmentSize;
+      FragmentBits_t m_Acks;
       ILinkSession::CompletionHandler m_Completed;
-      llarp_time_t m_LastFlush = 0s;
       ShortHash m_Digest;
       llarp_time_t m_StartedAt = 0s;
+      /// true once the congestion window let the first xmit out
+      bool m_Sending = false;
+      CongestionControl::SendState m_SendState;
+      /// when each fragment last went out
+      std::array< llarp_time_t, MaxFragments > m_FragSentAt{};
+      /// order each fragment last went out in, 0 for never
+      std::array< uint32_t, MaxFragments > m_FragSeq{};
+      uint32_t m_NextSeq = 0;
+      /// highest send order of any acked fragment
+      uint32_t m_HighestAckedSeq = 0;
 
       ILinkSession::Packet_t
       XMIT() const;
 
+      /// send the xmit and every data fragment, the first one only rides in
+      /// the xmit if the remote takes it from there
       void
-      Ack(byte_t bitmask);
+      Start(SendPacket_t sendpkt, llarp_time_t now, bool firstInXMIT);
 
+      /// apply a legacy one byte ack bitmask
       void
-      FlushUnAcked(std::function< void(ILinkSession::Packet_t) > sendpkt,
-                   llarp_time_t now);
+      Ack(byte_t bitmask);
 
+      /// apply the ranges of a selective ack
+      /// return false if they are malformed
       bool
-      ShouldFlush(llarp_time_t now) const;
+      AckRanges(const llarp_buffer_t& buf);
+
+      /// send every fragment not acked yet, returns bytes sent
+      size_t
+      FlushUnAcked(SendPacket_t sendpkt, llarp_time_t now);
+
+      /// return true if an unacked fragment went out more than rto ago
+      bool
+      ShouldFlush(llarp_time_t now, llarp_time_t rto) const;
+
+      /// resend unacked fragments that went out more than rto ago, returns
+      /// bytes sent
+      size_t
+      ResendExpired(SendPacket_t sendpkt, llarp_time_t now, llarp_time_t rto);
+
+      /// resend unacked fragments that went out before an acked one and at
+      /// least reorder ago, returns bytes sent
+      size_t
+      ResendLost(SendPacket_t sendpkt, llarp_time_t now,
+                 llarp_time_t reorder);
 
       void
       Completed();
@@ -68,25 +129,47 @@ namespace llarp
       bool
       IsTransmitted() const;
 
+      /// return true if any of our datagrams are bigger than every peer takes
+      bool
+      UsesBigFragments() const
+      {
+        return m_FragSize > FragmentSize && m_Data.size() > FragmentSize;
+      }
+
       bool
       IsTimedOut(llarp_time_t now) const;
 
       void
       InformTimeout();
+
+     private:
+      size_t
+      NumFragments() const;
+
+      /// send fragment idx, returns its size
+      size_t
+      SendFragment(const SendPacket_t& sendpkt, size_t idx, llarp_time_t now);
+
+      void
+      OnAcked(const FragmentBits_t& acked);
     };
 
     struct InboundMessage
     {
       InboundMessage() = default;
       InboundMessage(uint64_t msgid, uint16_t sz, ShortHash h,
-                     llarp_time_t now);
+                     llarp_time_t now, size_t fragsz = FragmentSize);
 
       ILinkSession::Message_t m_Data;
       ShortHash m_Digset;
       uint64_t m_MsgID            = 0;
       llarp_time_t m_LastACKSent  = 0s;
       llarp_time_t m_LastActiveAt = 0s;
-      std::bitset< MAX_LINK_MSG_SIZE / FragmentSize > m_Acks;
+      /// fragment size the sender uses, from its xmit
+      size_t m_FragSize = FragmentSize;
+      FragmentBits_t m_Acks;
+      /// a fragment showed up past a hole, tell the sender right away
+      bool m_SACKDue = false;
 
       void
       HandleData(uint16_t idx, const llarp_buffer_t& buf, llarp_time_t now);
@@ -100,18 +183,21 @@ namespace llarp
       bool
       Verify() const;
 
-      byte_t
-      AcksBitmask() const;
-
       bool
       ShouldSendACKS(llarp_time_t now) const;
 
+      /// send a selective ack if the remote takes them, a legacy one if not
       void
       SendACKS(std::function< void(ILinkSession::Packet_t) > sendpkt,
-               llarp_time_t now);
+               llarp_time_t now, bool sack);
 
+      /// legacy ack of the first 8 fragments as a one byte bitmask
       ILinkSession::Packet_t
       ACKS() const;
+
+      /// selective ack of the fragment ranges we have
+      ILinkSession::Packet_t
+      SACKS() const;
     };
 
   }  // namespace iwp
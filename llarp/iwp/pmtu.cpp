@@ -0,0 +1,98 @@
+#include <iwp/pmtu.hpp>
+
+namespace llarp
+{
+  namespace iwp
+  {
+    constexpr std::array< uint16_t, 4 > PathMTU::ProbeSizes;
+    constexpr llarp_time_t PathMTU::ProbeTimeout;
+    constexpr llarp_time_t PathMTU::RaiseInterval;
+    constexpr llarp_time_t PathMTU::BlackHoleBackoff;
+
+    size_t
+    PathMTU::NextIndex() const
+    {
+      size_t idx = 0;
+      while(idx < ProbeSizes.size() && ProbeSizes[idx] <= m_Size)
+        ++idx;
+      return idx;
+    }
+
+    void
+    PathMTU::Settle(llarp_time_t at)
+    {
+      m_Searching  = false;
+      m_SearchAt   = at;
+      m_ProbeCount = 0;
+    }
+
+    size_t
+    PathMTU::NextProbe(llarp_time_t now)
+    {
+      if(not m_Searching)
+      {
+        if(now < m_SearchAt)
+          return 0;
+        m_Searching  = true;
+        m_ProbeIdx   = NextIndex();
+        m_ProbeCount = 0;
+      }
+      if(m_ProbeIdx >= ProbeSizes.size())
+      {
+        Settle(now + RaiseInterval);
+        return 0;
+      }
+      if(m_ProbeCount > 0 && now - m_ProbeSentAt < ProbeTimeout)
+        return 0;
+      if(m_ProbeCount >= MaxProbes)
+      {
+        // anything bigger is not going to fit either
+        Settle(now + RaiseInterval);
+        return 0;
+      }
+      m_ProbeCount++;
+      m_ProbeSentAt = now;
+      return ProbeSizes[m_ProbeIdx];
+    }
+
+    void
+    PathMTU::OnProbeAck(size_t sz, llarp_time_t)
+    {
+      if(sz <= m_Size || sz > MaxSize)
+        return;
+      m_Size  = sz;
+      m_Drops = 0;
+      if(m_Searching)
+      {
+        m_ProbeIdx   = NextIndex();
+        m_ProbeCount = 0;
+      }
+    }
+
+    void
+    PathMTU::OnMessageDelivered()
+    {
+      m_Drops = 0;
+    }
+
+    void
+    PathMTU::OnMessageDropped(llarp_time_t now)
+    {
+      if(m_Size == m_BaseSize)
+        return;
+      if(++m_Drops < MaxBlackHoleDrops)
+        return;
+      m_Size  = m_BaseSize;
+      m_Drops = 0;
+      Settle(now + BlackHoleBackoff);
+    }
+
+    util::StatusObject
+    PathMTU::ExtractStatus() const
+    {
+      return util::StatusObject{{"size", m_Size},
+                                {"searching", m_Searching},
+                                {"drops", m_Drops}};
+    }
+  }  // namespace iwp
+}  // namespace llarp
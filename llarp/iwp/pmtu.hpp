@@ -0,0 +1,90 @@
+#ifndef LLARP_IWP_PMTU_HPP
+#define LLARP_IWP_PMTU_HPP
+
+#include <util/status.hpp>
+#include <util/time.hpp>
+#include <util/types.hpp>
+
+#include <array>
+
+namespace llarp
+{
+  namespace iwp
+  {
+    /// path mtu discovery for one session, after RFC 8899
+    ///
+    /// we start at a base datagram size every iwp link carries and probe
+    /// upwards with padded probes the remote acks. a remote that does not
+    /// know about probes never acks them and we stay at the base size.
+    /// if messages keep dying at a probed size we fall back to the base.
+    struct PathMTU
+    {
+      /// datagram sizes we try in order, all fit a 1500 byte receive buffer
+      static constexpr std::array< uint16_t, 4 > ProbeSizes = {
+          {1280, 1400, 1452, 1472}};
+      /// biggest datagram we ever send
+      static constexpr size_t MaxSize = 1472;
+      /// probes of one size before we take it as too big
+      static constexpr size_t MaxProbes = 3;
+      /// how long we wait for a probe ack
+      static constexpr llarp_time_t ProbeTimeout = 1s;
+      /// how long a finished search holds before we look for more room
+      static constexpr llarp_time_t RaiseInterval = 10min;
+      /// dropped messages in a row that make us give up a probed size
+      static constexpr size_t MaxBlackHoleDrops = 2;
+      /// how long we stay at the base size after a black hole
+      static constexpr llarp_time_t BlackHoleBackoff = 1min;
+
+      explicit PathMTU(size_t baseSize) : m_BaseSize(baseSize), m_Size(baseSize)
+      {
+      }
+
+      /// largest datagram we know gets through
+      size_t
+      Size() const
+      {
+        return m_Size;
+      }
+
+      /// return the size of the probe to send now or 0 for none
+      size_t
+      NextProbe(llarp_time_t now);
+
+      /// the remote got our probe of sz bytes
+      void
+      OnProbeAck(size_t sz, llarp_time_t now);
+
+      /// a message we sent at Size() was acked
+      void
+      OnMessageDelivered();
+
+      /// a message we sent at Size() timed out
+      void
+      OnMessageDropped(llarp_time_t now);
+
+      util::StatusObject
+      ExtractStatus() const;
+
+     private:
+      /// stop probing until at
+      void
+      Settle(llarp_time_t at);
+
+      /// next probe size index past the size we have
+      size_t
+      NextIndex() const;
+
+      const size_t m_BaseSize;
+      size_t m_Size;
+      bool m_Searching = true;
+      /// when a settled search starts again
+      llarp_time_t m_SearchAt    = 0s;
+      size_t m_ProbeIdx          = 0;
+      size_t m_ProbeCount        = 0;
+      llarp_time_t m_ProbeSentAt = 0s;
+      size_t m_Drops             = 0;
+    };
+  }  // namespace iwp
+}  // namespace llarp
+
+#endif
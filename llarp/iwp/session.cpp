@@ -29,7 +29,8 @@ namespace llarp
     }
 
     Session::Session(LinkLayer* p, const RouterContact& rc,
-                     const AddressInfo& ai)
+                     const AddressInfo& ai,
+                     std::unique_ptr< CongestionControl > cc)
         : m_State{State::Initial}
         , m_Inbound{false}
         , m_Parent(p)
@@ -37,6 +38,7 @@ namespace llarp
         , m_RemoteAddr(ai)
         , m_ChosenAI(ai)
         , m_RemoteRC(rc)
+        , m_CC{std::move(cc)}
     {
       token.Zero();
       GotLIM = util::memFn(&Session::GotOutboundLIM, this);
@@ -44,12 +46,14 @@ namespace llarp
                                            llarp_buffer_t(rc.pubkey));
     }
 
-    Session::Session(LinkLayer* p, const Addr& from)
+    Session::Session(LinkLayer* p, const Addr& from,
+                     std::unique_ptr< CongestionControl > cc)
         : m_State{State::Initial}
         , m_Inbound{true}
         , m_Parent(p)
         , m_CreatedAt{p->Now()}
         , m_RemoteAddr(from)
+        , m_CC{std::move(cc)}
     {
       token.Randomize();
       GotLIM          = util::memFn(&Session::GotInboundLIM, this);
@@ -67,6 +71,16 @@ namespace llarp
       m_TXRate += sz;
     }
 
+    void
+    Session::SendMany_LL(const llarp_udp_pkt* pkts, size_t num)
+    {
+      LogDebug("send ", num, " packets to ", m_RemoteAddr);
+      m_Parent->SendManyTo_LL(m_RemoteAddr, pkts, num);
+      m_LastTX = time_now_ms();
+      for(size_t idx = 0; idx < num; ++idx)
+        m_TXRate += pkts[idx].sz;
+    }
+
     bool
     Session::GotInboundLIM(const LinkIntroMessage* msg)
     {
@@ -80,6 +94,8 @@ namespace llarp
       GotLIM     = util::memFn(&Session::GotRenegLIM, this);
       m_RemoteRC = msg->rc;
       m_Parent->MapAddr(m_RemoteRC.pubkey, this);
+      // tell the remote what we take beyond the baseline protocol
+      SendKeepAlive();
       return m_Parent->SessionEstablished(this);
     }
 
@@ -98,6 +114,7 @@ namespace llarp
         if(st == ILinkSession::DeliveryStatus::eDeliverySuccess)
         {
           self->m_State = State::Ready;
+          self->SendKeepAlive();
           self->m_Parent->MapAddr(self->m_RemoteRC.pubkey, self.get());
           self->m_Parent->SessionEstablished(self.get());
         }
@@ -147,22 +164,33 @@ namespace llarp
     Session::EncryptWorker(CryptoQueue_ptr msgs)
     {
       LogDebug("encrypt worker ", msgs->size(), " messages");
-      auto itr = msgs->begin();
-      while(itr != msgs->end())
+      // encrypt the whole batch then mac the whole batch so the crypto
+      // backend can work on several packets at once
+      std::vector< CryptoBatchItem > items;
+      items.reserve(msgs->size());
+      for(auto& pkt : *msgs)
+      {
+        items.emplace_back(CryptoBatchItem{pkt.data() + PacketOverhead,
+                                           pkt.size() - PacketOverhead,
+                                           pkt.data() + HMACSIZE, nullptr});
+      }
+      CryptoManager::instance()->xchacha20_batch(items.data(), items.size(),
+                                                 m_SessionKey);
+      std::vector< llarp_udp_pkt > sendq;
+      sendq.reserve(msgs->size());
+      for(size_t idx = 0; idx < items.size(); ++idx)
       {
-        Packet_t pkt = std::move(*itr);
-        llarp_buffer_t pktbuf(pkt);
-        const TunnelNonce nonce_ptr{pkt.data() + HMACSIZE};
-        pktbuf.base += PacketOverhead;
-        pktbuf.cur = pktbuf.base;
-        pktbuf.sz -= PacketOverhead;
-        CryptoManager::instance()->xchacha20(pktbuf, m_SessionKey, nonce_ptr);
-        pktbuf.base = pkt.data() + HMACSIZE;
-        pktbuf.sz   = pkt.size() - HMACSIZE;
-        CryptoManager::instance()->hmac(pkt.data(), pktbuf, m_SessionKey);
-        Send_LL(pkt.data(), pkt.size());
-        ++itr;
+        auto& pkt  = (*msgs)[idx];
+        items[idx] = CryptoBatchItem{pkt.data() + HMACSIZE,
+                                     pkt.size() - HMACSIZE, nullptr,
+                                     pkt.data()};
+        sendq.emplace_back(llarp_udp_pkt{pkt.data(), pkt.size()});
       }
+      CryptoManager::instance()->hmac_batch(items.data(), items.size(),
+                                            m_SessionKey);
+      // flush the whole batch at once so the event loop can use sendmmsg
+      if(not sendq.empty())
+        SendMany_LL(sendq.data(), sendq.size());
     }
 
     void
@@ -182,50 +210,82 @@ namespace llarp
     Session::SendMessageBuffer(ILinkSession::Message_t buf,
                                ILinkSession::CompletionHandler completed)
     {
-      if(m_TXMsgs.size() >= MaxSendQueueSize)
+      if(m_TXMsgs.Size() >= MaxSendQueueSize)
         return false;
-      const auto now   = m_Parent->Now();
-      const auto msgid = m_TXID++;
-      auto& msg =
-          m_TXMsgs
-              .emplace(msgid,
-                       OutboundMessage{msgid, std::move(buf), now, completed})
-              .first->second;
-      EncryptAndSend(msg.XMIT());
-      if(buf.size() > FragmentSize)
+      if(buf.size() > MaxFragments * FragmentSize)
       {
-        msg.FlushUnAcked(util::memFn(&Session::EncryptAndSend, this), now);
+        LogError("message of ", buf.size(), " bytes too big for ",
+                 m_RemoteAddr);
+        return false;
       }
+      const auto now   = m_Parent->Now();
+      const auto msgid = m_TXID;
+      auto* msg        = m_TXMsgs.Emplace(
+          msgid, OutboundMessage{msgid, std::move(buf), now, completed});
+      // the oldest message in flight is holding our slot
+      if(msg == nullptr)
+        return false;
+      m_TXID++;
+      m_TXPending.push_back(msgid);
+      SendPending(now);
       m_Stats.totalInFlightTX++;
       LogDebug("send message ", msgid);
       return true;
     }
 
+    void
+    Session::SendPending(llarp_time_t now)
+    {
+      while(not m_TXPending.empty())
+      {
+        auto* msg = m_TXMsgs.Find(m_TXPending.front());
+        if(msg == nullptr)
+        {
+          // timed out while it waited
+          m_TXPending.pop_front();
+          continue;
+        }
+        const auto sz = msg->m_Data.size();
+        if(not m_CC->CanSend(sz, now))
+          return;
+        m_TXPending.pop_front();
+        m_CC->OnSend(msg->m_SendState, sz, now);
+        msg->m_Sending  = true;
+        msg->m_FragSize = m_PathMTU.Size() - XMITOverhead;
+        msg->Start(util::memFn(&Session::EncryptAndSend, this), now,
+                   RemoteTakesSACK());
+      }
+    }
+
     void
     Session::SendMACK()
     {
       // send multi acks
-      while(m_SendMACKs.size() > 0)
+      std::sort(m_SendMACKs.begin(), m_SendMACKs.end());
+      m_SendMACKs.erase(std::unique(m_SendMACKs.begin(), m_SendMACKs.end()),
+                        m_SendMACKs.end());
+      auto itr = m_SendMACKs.begin();
+      while(itr != m_SendMACKs.end())
       {
-        const auto sz  = m_SendMACKs.size();
-        const auto max = Session::MaxACKSInMACK;
-        auto numAcks   = std::min(sz, max);
+        const size_t sz  = std::distance(itr, m_SendMACKs.end());
+        const auto max   = Session::MaxACKSInMACK;
+        auto numAcks     = std::min(sz, max);
         auto mack =
             CreatePacket(Command::eMACK, 1 + (numAcks * sizeof(uint64_t)));
         mack[PacketOverhead + CommandOverhead] =
             byte_t{static_cast< byte_t >(numAcks)};
         byte_t* ptr = mack.data() + 3 + PacketOverhead;
         LogDebug("send ", numAcks, " macks to ", m_RemoteAddr);
-        auto itr = m_SendMACKs.begin();
         while(numAcks > 0)
         {
           htobe64buf(ptr, *itr);
-          itr = m_SendMACKs.erase(itr);
+          ++itr;
           numAcks--;
           ptr += sizeof(uint64_t);
         }
         EncryptAndSend(std::move(mack));
       }
+      m_SendMACKs.clear();
     }
 
     void
@@ -236,22 +296,29 @@ namespace llarp
       {
         if(ShouldPing())
           SendKeepAlive();
-        for(auto& item : m_RXMsgs)
+        // a remote without the capability would drop our probes
+        if(m_State == State::Ready && RemoteTakesMTUProbes())
         {
-          if(item.second.ShouldSendACKS(now))
+          if(const auto sz = m_PathMTU.NextProbe(now))
+            SendMTUProbe(sz);
+        }
+        m_RXMsgs.ForEach([&](uint64_t, InboundMessage& msg) {
+          if(msg.ShouldSendACKS(now))
           {
-            item.second.SendACKS(util::memFn(&Session::EncryptAndSend, this),
-                                 now);
+            msg.SendACKS(util::memFn(&Session::EncryptAndSend, this), now,
+                         RemoteTakesSACK());
           }
-        }
-        for(auto& item : m_TXMsgs)
-        {
-          if(item.second.ShouldFlush(now))
+        });
+        const auto rto = m_CC->RTO();
+        m_TXMsgs.ForEach([&](uint64_t, OutboundMessage& msg) {
+          if(msg.ShouldFlush(now, rto))
           {
-            item.second.FlushUnAcked(
-                util::memFn(&Session::EncryptAndSend, this), now);
+            const auto resent = msg.ResendExpired(
+                util::memFn(&Session::EncryptAndSend, this), now, rto);
+            m_CC->OnRetransmit(msg.m_SendState, resent, now);
           }
-        }
+        });
+        SendPending(now);
       }
       auto self = shared_from_this();
       if(m_EncryptNext && !m_EncryptNext->empty())
@@ -315,9 +382,12 @@ namespace llarp
 
               {"state", StateToString(m_State)},
               {"inbound", m_Inbound},
-              {"replayFilter", m_ReplayFilter.size()},
-              {"txMsgQueueSize", m_TXMsgs.size()},
-              {"rxMsgQueueSize", m_RXMsgs.size()},
+              {"replayFilter", m_ReplayFilter.Count()},
+              {"txMsgQueueSize", m_TXMsgs.Size()},
+              {"rxMsgQueueSize", m_RXMsgs.Size()},
+              {"txMsgPending", m_TXPending.size()},
+              {"congestion", m_CC->ExtractStatus()},
+              {"pathMTU", m_PathMTU.ExtractStatus()},
               {"remoteAddr", m_RemoteAddr.ToString()},
               {"remoteRC", m_RemoteRC.ExtractStatus()},
               {"created", to_json(m_CreatedAt)},
@@ -359,49 +429,26 @@ namespace llarp
       }
       // remove pending outbound messsages that timed out
       // inform waiters
-      {
-        auto itr = m_TXMsgs.begin();
-        while(itr != m_TXMsgs.end())
-        {
-          if(itr->second.IsTimedOut(now))
-          {
-            m_Stats.totalDroppedTX++;
-            m_Stats.totalInFlightTX--;
-            LogWarn("Dropped unacked packet to ", m_RemoteAddr);
-            itr->second.InformTimeout();
-            itr = m_TXMsgs.erase(itr);
-          }
-          else
-            ++itr;
-        }
-      }
-      {
-        // remove pending inbound messages that timed out
-        auto itr = m_RXMsgs.begin();
-        while(itr != m_RXMsgs.end())
-        {
-          if(itr->second.IsTimedOut(now))
-          {
-            m_ReplayFilter.emplace(itr->first, now);
-            itr = m_RXMsgs.erase(itr);
-          }
-          else
-            ++itr;
-        }
-      }
-      {
-        // decay replay window
-        auto itr = m_ReplayFilter.begin();
-        while(itr != m_ReplayFilter.end())
-        {
-          if(itr->second + ReplayWindow <= now)
-          {
-            itr = m_ReplayFilter.erase(itr);
-          }
-          else
-            ++itr;
-        }
-      }
+      m_TXMsgs.EraseIf([&](uint64_t, OutboundMessage& msg) -> bool {
+        if(not msg.IsTimedOut(now))
+          return false;
+        m_Stats.totalDroppedTX++;
+        m_Stats.totalInFlightTX--;
+        if(msg.m_Sending)
+          m_CC->OnDrop(msg.m_Data.size(), now);
+        if(msg.UsesBigFragments())
+          m_PathMTU.OnMessageDropped(now);
+        LogWarn("Dropped unacked packet to ", m_RemoteAddr);
+        msg.InformTimeout();
+        return true;
+      });
+      // remove pending inbound messages that timed out
+      m_RXMsgs.EraseIf([&](uint64_t rxid, InboundMessage& msg) -> bool {
+        if(not msg.IsTimedOut(now))
+          return false;
+        m_ReplayFilter.Insert(rxid);
+        return true;
+      });
     }
 
     using Introduction = AlignedBuffer< PubKey::SIZE + PubKey::SIZE
@@ -594,32 +641,83 @@ namespace llarp
     void
     Session::DecryptWorker(CryptoQueue_ptr msgs)
     {
-      CryptoQueue_ptr recvMsgs = std::make_shared< CryptoQueue_t >();
-      for(auto& pkt : *msgs)
+      auto& pkts = *msgs;
+      // check every mac in one batch then decrypt the packets that passed
+      std::vector< ShortHash > macs(pkts.size());
+      std::vector< CryptoBatchItem > items;
+      items.reserve(pkts.size());
+      for(size_t idx = 0; idx < pkts.size(); ++idx)
+      {
+        auto& pkt = pkts[idx];
+        // too small packets get a dummy entry and are dropped below
+        const size_t sz =
+            pkt.size() > PacketOverhead ? pkt.size() - HMACSIZE : 0;
+        items.emplace_back(CryptoBatchItem{pkt.data() + HMACSIZE, sz, nullptr,
+                                           macs[idx].data()});
+      }
+      if(not CryptoManager::instance()->hmac_batch(items.data(), items.size(),
+                                                   m_SessionKey))
       {
-        if(not DecryptMessageInPlace(pkt))
+        LogError("failed to caclulate keyed hash for ", m_RemoteAddr);
+        return;
+      }
+      // drop what fails in place so the batch itself goes on to the logic
+      // thread without a copy
+      size_t authed = 0;
+      items.clear();
+      for(size_t idx = 0; idx < pkts.size(); ++idx)
+      {
+        auto& pkt = pkts[idx];
+        if(pkt.size() <= PacketOverhead)
         {
-          LogError("failed to decrypt session data from ", m_RemoteAddr);
+          LogError("packet too small from ", m_RemoteAddr);
           continue;
         }
+        const ShortHash expected{pkt.data()};
+        if(macs[idx] != expected)
+        {
+          LogError("keyed hash missmatch ", macs[idx], " != ", expected,
+                   " from ", m_RemoteAddr, " state=", int(m_State),
+                   " size=", pkt.size());
+          continue;
+        }
+        items.emplace_back(CryptoBatchItem{pkt.data() + PacketOverhead,
+                                           pkt.size() - PacketOverhead,
+                                           pkt.data() + HMACSIZE, nullptr});
+        if(authed != idx)
+          pkts[authed] = std::move(pkt);
+        ++authed;
+      }
+      pkts.erase(pkts.begin() + authed, pkts.end());
+      if(not CryptoManager::instance()->xchacha20_batch(
+             items.data(), items.size(), m_SessionKey))
+      {
+        LogError("failed to decrypt session data from ", m_RemoteAddr);
+        return;
+      }
+      size_t kept = 0;
+      for(size_t idx = 0; idx < pkts.size(); ++idx)
+      {
+        auto& pkt = pkts[idx];
         if(pkt[PacketOverhead] != LLARP_PROTO_VERSION)
         {
           LogError("protocol version missmatch ", int(pkt[PacketOverhead]),
                    " != ", LLARP_PROTO_VERSION);
           continue;
         }
-        recvMsgs->emplace_back(std::move(pkt));
+        if(kept != idx)
+          pkts[kept] = std::move(pkt);
+        ++kept;
       }
-      LogDebug("decrypted ", recvMsgs->size(), " packets from ", m_RemoteAddr);
-      LogicCall(
-          m_Parent->logic(),
-          std::bind(&Session::HandlePlaintext, shared_from_this(), recvMsgs));
+      pkts.erase(pkts.begin() + kept, pkts.end());
+      LogDebug("decrypted ", pkts.size(), " packets from ", m_RemoteAddr);
+      m_Parent->QueuePlaintext(shared_from_this(), std::move(pkts));
     }
 
     void
-    Session::HandlePlaintext(CryptoQueue_ptr msgs)
+    Session::HandlePlaintext(CryptoQueue_t& msgs)
     {
-      for(auto& result : *msgs)
+      for(auto& result : msgs)
       {
         LogDebug("Command ", int(result[PacketOverhead + 1]));
         switch(result[PacketOverhead + 1])
@@ -645,6 +743,15 @@ namespace llarp
           case Command::eMACK:
             HandleMACK(std::move(result));
             break;
+          case Command::eSACK:
+            HandleSACK(std::move(result));
+            break;
+          case Command::eMTUP:
+            HandleMTUProbe(std::move(result));
+            break;
+          case Command::eMTUA:
+            HandleMTUProbeAck(std::move(result));
+            break;
           default:
             LogError("invalid command ", int(result[PacketOverhead + 1]),
                      " from ", m_RemoteAddr);
@@ -671,18 +778,23 @@ namespace llarp
         return;
       }
       LogDebug("got ", int(numAcks), " mack from ", m_RemoteAddr);
+      const auto now = m_Parent->Now();
       byte_t* ptr = data.data() + CommandOverhead + PacketOverhead + 1;
       while(numAcks > 0)
       {
         uint64_t acked = bufbe64toh(ptr);
         LogDebug("mack containing txid=", acked, " from ", m_RemoteAddr);
-        auto itr = m_TXMsgs.find(acked);
-        if(itr != m_TXMsgs.end())
+        auto* msg = m_TXMsgs.Find(acked);
+        if(msg)
         {
           m_Stats.totalAckedTX++;
           m_Stats.totalInFlightTX--;
-          itr->second.Completed();
-          m_TXMsgs.erase(itr);
+          if(msg->m_Sending)
+            m_CC->OnAck(msg->m_SendState, msg->m_Data.size(), now);
+          if(msg->UsesBigFragments())
+            m_PathMTU.OnMessageDelivered();
+          msg->Completed();
+          m_TXMsgs.Erase(acked);
         }
         else
         {
@@ -704,10 +816,10 @@ namespace llarp
       uint64_t txid =
           bufbe64toh(data.data() + CommandOverhead + PacketOverhead);
       LogDebug("got nack on ", txid, " from ", m_RemoteAddr);
-      auto itr = m_TXMsgs.find(txid);
-      if(itr != m_TXMsgs.end())
+      auto* msg = m_TXMsgs.Find(txid);
+      if(msg)
       {
-        EncryptAndSend(itr->second.XMIT());
+        EncryptAndSend(msg->XMIT());
       }
       m_LastRX = m_Parent->Now();
     }
@@ -715,8 +827,7 @@ namespace llarp
     void
     Session::HandleXMIT(Packet_t data)
     {
-      if(data.size() < (CommandOverhead + PacketOverhead + sizeof(uint16_t)
-                        + sizeof(uint64_t) + ShortHash::SIZE))
+      if(data.size() < XMITOverhead)
       {
         LogError("short XMIT from ", m_RemoteAddr);
         return;
@@ -727,54 +838,62 @@ namespace llarp
       ShortHash h{data.data() + CommandOverhead + sizeof(uint16_t)
                   + sizeof(uint64_t) + PacketOverhead};
       LogDebug("rxid=", rxid, " sz=", sz, " h=", h.ToHex());
+      if(sz > MaxFragments * FragmentSize)
+      {
+        LogError("XMIT of ", sz, " bytes is too big from ", m_RemoteAddr);
+        return;
+      }
+      // the xmit carries a first fragment, which tells us the fragment size
+      // the remote cut this message into
+      const size_t extra  = data.size() - XMITOverhead;
+      const size_t fragsz = extra < sz ? extra : std::max(extra, FragmentSize);
+      if(fragsz < FragmentSize || fragsz > MaxFragmentSize)
+      {
+        LogError("XMIT with fragment size ", fragsz, " from ", m_RemoteAddr);
+        return;
+      }
       m_LastRX = m_Parent->Now();
       {
         // check for replay
-        auto itr = m_ReplayFilter.find(rxid);
-        if(itr != m_ReplayFilter.end())
+        if(m_ReplayFilter.Contains(rxid))
         {
-          m_SendMACKs.emplace(rxid);
+          m_SendMACKs.emplace_back(rxid);
           LogDebug("duplicate rxid=", rxid, " from ", m_RemoteAddr);
           return;
         }
       }
       {
         const auto now = m_Parent->Now();
-        auto itr       = m_RXMsgs.find(rxid);
-        if(itr == m_RXMsgs.end())
+        auto* msg      = m_RXMsgs.Find(rxid);
+        if(msg == nullptr)
         {
-          itr = m_RXMsgs
-                    .emplace(
-                        rxid,
-                        InboundMessage{rxid, sz, std::move(h), m_Parent->Now()})
-                    .first;
-
-          auto _sizeDelta = data.size()
-              - (CommandOverhead + sizeof(uint16_t) + sizeof(uint64_t)
-                 + PacketOverhead + 32);
-          if(_sizeDelta == 0)
+          InboundMessage fresh{rxid, sz, std::move(h), m_Parent->Now(),
+                               fragsz};
+          msg = m_RXMsgs.Emplace(rxid, std::move(fresh));
+          if(msg == nullptr)
           {
-            sz = std::min(sz, uint16_t{FragmentSize});
-            {
-              const llarp_buffer_t buf(data.data() + (data.size() - sz), sz);
-              itr->second.HandleData(0, buf, now);
-              if(not itr->second.IsCompleted())
-              {
-                return;
-              }
-              if(not itr->second.Verify())
-              {
-                LogError("bad short xmit hash from ", m_RemoteAddr);
-                return;
-              }
-            }
-            auto msg = std::move(itr->second);
-            const llarp_buffer_t buf(msg.m_Data);
-            m_Parent->HandleMessage(this, buf);
-            if(m_ReplayFilter.emplace(rxid, m_Parent->Now()).second)
-              m_SendMACKs.emplace(rxid);
-            m_RXMsgs.erase(rxid);
+            // the remote moved on from whatever is still sitting in our way
+            m_RXMsgs.EvictFor(rxid);
+            msg = m_RXMsgs.Emplace(rxid, std::move(fresh));
           }
+
+          // the first fragment rides in the xmit
+          const llarp_buffer_t buf(data.data() + XMITOverhead,
+                                   std::min(extra, size_t{sz}));
+          msg->HandleData(0, buf, now);
+          if(not msg->IsCompleted())
+            return;
+          if(not msg->Verify())
+          {
+            LogError("bad short xmit hash from ", m_RemoteAddr);
+            return;
+          }
+          auto completed = std::move(*msg);
+          m_RXMsgs.Erase(rxid);
+          const llarp_buffer_t msgbuf(completed.m_Data);
+          m_Parent->HandleMessage(this, msgbuf);
+          if(m_ReplayFilter.Insert(rxid))
+            m_SendMACKs.emplace_back(rxid);
         }
         else
           LogDebug("got duplicate xmit on ", rxid, " from ", m_RemoteAddr);
@@ -794,10 +913,10 @@ namespace llarp
       uint16_t sz = bufbe16toh(data.data() + CommandOverhead + PacketOverhead);
       uint64_t rxid = bufbe64toh(data.data() + CommandOverhead
                                  + sizeof(uint16_t) + PacketOverhead);
-      auto itr      = m_RXMsgs.find(rxid);
-      if(itr == m_RXMsgs.end())
+      auto* msg     = m_RXMsgs.Find(rxid);
+      if(msg == nullptr)
       {
-        if(m_ReplayFilter.find(rxid) == m_ReplayFilter.end())
+        if(not m_ReplayFilter.Contains(rxid))
         {
           LogDebug("no rxid=", rxid, " for ", m_RemoteAddr);
           auto nack = CreatePacket(Command::eNACK, 8);
@@ -807,7 +926,7 @@ namespace llarp
         else
         {
           LogDebug("replay hit for rxid=", rxid, " for ", m_RemoteAddr);
-          m_SendMACKs.emplace(rxid);
+          m_SendMACKs.emplace_back(rxid);
         }
         return;
       }
@@ -815,24 +934,24 @@ namespace llarp
       {
         const llarp_buffer_t buf(data.data() + PacketOverhead + 12,
                                  data.size() - (PacketOverhead + 12));
-        itr->second.HandleData(sz, buf, m_Parent->Now());
+        msg->HandleData(sz, buf, m_Parent->Now());
       }
 
-      if(itr->second.IsCompleted())
+      if(msg->IsCompleted())
       {
-        if(itr->second.Verify())
+        auto completed = std::move(*msg);
+        m_RXMsgs.Erase(rxid);
+        if(completed.Verify())
         {
-          auto msg = std::move(itr->second);
-          const llarp_buffer_t buf(msg.m_Data);
+          const llarp_buffer_t buf(completed.m_Data);
           m_Parent->HandleMessage(this, buf);
-          if(m_ReplayFilter.emplace(itr->first, m_Parent->Now()).second)
-            m_SendMACKs.emplace(itr->first);
+          if(m_ReplayFilter.Insert(rxid))
+            m_SendMACKs.emplace_back(rxid);
         }
         else
         {
-          LogError("hash missmatch for message ", itr->first);
+          LogError("hash missmatch for message ", rxid);
         }
-        m_RXMsgs.erase(itr);
       }
     }
 
@@ -847,25 +966,120 @@ namespace llarp
       const auto now = m_Parent->Now();
       m_LastRX       = now;
       uint64_t txid  = bufbe64toh(data.data() + 2 + PacketOverhead);
-      auto itr       = m_TXMsgs.find(txid);
-      if(itr == m_TXMsgs.end())
+      auto* msg      = m_TXMsgs.Find(txid);
+      if(msg == nullptr)
       {
         LogDebug("no txid=", txid, " for ", m_RemoteAddr);
         return;
       }
-      itr->second.Ack(data[10 + PacketOverhead]);
+      msg->Ack(data[10 + PacketOverhead]);
+      HandleFragmentsAcked(txid, *msg, now);
+    }
 
-      if(itr->second.IsTransmitted())
+    void
+    Session::HandleSACK(Packet_t data)
+    {
+      if(data.size()
+         < (CommandOverhead + sizeof(uint64_t) + 1 + PacketOverhead))
+      {
+        LogError("short SACK from ", m_RemoteAddr);
+        return;
+      }
+      const auto now = m_Parent->Now();
+      m_LastRX       = now;
+      // only a remote that got our capabilities sends these
+      m_RemoteCaps |= eCapSACK;
+      const byte_t* ptr = data.data() + CommandOverhead + PacketOverhead;
+      uint64_t txid     = bufbe64toh(ptr);
+      auto* msg         = m_TXMsgs.Find(txid);
+      if(msg == nullptr)
       {
-        LogDebug("sent message ", itr->first);
-        itr->second.Completed();
-        itr = m_TXMsgs.erase(itr);
+        LogDebug("no txid=", txid, " for ", m_RemoteAddr);
+        return;
       }
-      else
+      ptr += sizeof(uint64_t);
+      const llarp_buffer_t ranges(ptr, data.size() - (ptr - data.data()));
+      if(not msg->AckRanges(ranges))
       {
-        itr->second.FlushUnAcked(util::memFn(&Session::EncryptAndSend, this),
-                                 now);
+        LogError("bad SACK ranges from ", m_RemoteAddr);
+        return;
       }
+      HandleFragmentsAcked(txid, *msg, now);
+    }
+
+    void
+    Session::HandleFragmentsAcked(uint64_t txid, OutboundMessage& msg,
+                                  llarp_time_t now)
+    {
+      if(msg.IsTransmitted())
+      {
+        LogDebug("sent message ", txid);
+        if(msg.m_Sending)
+          m_CC->OnAck(msg.m_SendState, msg.m_Data.size(), now);
+        if(msg.UsesBigFragments())
+          m_PathMTU.OnMessageDelivered();
+        msg.Completed();
+        m_TXMsgs.Erase(txid);
+        return;
+      }
+      // only resend what the acks show as lost, the rto covers the rest
+      const auto reorder = std::max(m_CC->MinRTT() / 4, llarp_time_t{1});
+      const auto resent  = msg.ResendLost(
+          util::memFn(&Session::EncryptAndSend, this), now, reorder);
+      if(resent > 0)
+        m_CC->OnRetransmit(msg.m_SendState, resent, now);
+    }
+
+    void
+    Session::SendMTUProbe(size_t sz)
+    {
+      auto probe =
+          CreatePacket(Command::eMTUP, sz - (PacketOverhead + CommandOverhead),
+                       0, 0);
+      htobe16buf(probe.data() + PacketOverhead + CommandOverhead, sz);
+      LogDebug("probe path mtu of ", sz, " to ", m_RemoteAddr);
+      EncryptAndSend(std::move(probe));
+    }
+
+    void
+    Session::HandleMTUProbe(Packet_t data)
+    {
+      if(data.size() < (CommandOverhead + sizeof(uint16_t) + PacketOverhead))
+      {
+        LogError("short MTUP from ", m_RemoteAddr);
+        return;
+      }
+      m_LastRX = m_Parent->Now();
+      // a remote that probes us answers our probes too
+      m_RemoteCaps |= eCapMTUP;
+      const uint16_t sz =
+          bufbe16toh(data.data() + PacketOverhead + CommandOverhead);
+      // only ack what really made it through in one piece
+      if(sz != data.size())
+      {
+        LogError("MTUP of ", data.size(), " bytes claims ", sz, " from ",
+                 m_RemoteAddr);
+        return;
+      }
+      auto ack = CreatePacket(Command::eMTUA, sizeof(uint16_t));
+      htobe16buf(ack.data() + PacketOverhead + CommandOverhead, sz);
+      EncryptAndSend(std::move(ack));
+    }
+
+    void
+    Session::HandleMTUProbeAck(Packet_t data)
+    {
+      if(data.size() < (CommandOverhead + sizeof(uint16_t) + PacketOverhead))
+      {
+        LogError("short MTUA from ", m_RemoteAddr);
+        return;
+      }
+      const auto now = m_Parent->Now();
+      m_LastRX       = now;
+      const uint16_t sz =
+          bufbe16toh(data.data() + PacketOverhead + CommandOverhead);
+      LogDebug("path mtu of ", sz, " to ", m_RemoteAddr, " works");
+      m_PathMTU.OnProbeAck(sz, now);
     }
 
     void Session::HandleCLOS(Packet_t)
@@ -874,9 +1088,19 @@ namespace llarp
       Close();
     }
 
-    void Session::HandlePING(Packet_t)
+    void
+    Session::HandlePING(Packet_t data)
     {
       m_LastRX = m_Parent->Now();
+      // older peers pad their pings with at least 16 bytes, ours carry only
+      // our capabilities
+      if(data.size() != PacketOverhead + CommandOverhead + 1)
+        return;
+      const bool fresh = m_RemoteCaps == 0;
+      m_RemoteCaps |= data[PacketOverhead + CommandOverhead];
+      // our first ping may have been lost, answer so they learn ours too
+      if(fresh)
+        SendKeepAlive();
     }
 
     bool
@@ -884,7 +1108,9 @@ namespace llarp
     {
       if(m_State == State::Ready)
       {
-        EncryptAndSend(CreatePacket(Command::ePING, 0));
+        auto ping = CreatePacket(Command::ePING, 1, 0, 0);
+        ping[PacketOverhead + CommandOverhead] = eCapSACK | eCapMTUP;
+        EncryptAndSend(std::move(ping));
         return true;
       }
       return false;
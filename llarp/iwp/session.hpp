@@ -2,9 +2,11 @@
 #define LLARP_IWP_SESSION_HPP
 
 #include <link/session.hpp>
+#include <iwp/congestion.hpp>
 #include <iwp/linklayer.hpp>
 #include <iwp/message_buffer.hpp>
-#include <unordered_set>
+#include <iwp/pmtu.hpp>
+#include <iwp/window.hpp>
 #include <deque>
 
 namespace llarp
@@ -13,6 +15,11 @@ namespace llarp
   {
     /// packet crypto overhead size
     static constexpr size_t PacketOverhead = HMACSIZE + TUNNONCESIZE;
+    /// xmit size less its first fragment, the biggest datagram per fragment
+    static constexpr size_t XMITOverhead = PacketOverhead + CommandOverhead
+        + sizeof(uint16_t) + sizeof(uint64_t) + ShortHash::SIZE;
+    /// biggest fragment that still fits the biggest datagram we send
+    static constexpr size_t MaxFragmentSize = PathMTU::MaxSize - XMITOverhead;
     /// creates a packet with plaintext size + wire overhead + random pad
     ILinkSession::Packet_t
     CreatePacket(Command cmd, size_t plainsize, size_t min_pad = 16,
@@ -21,12 +28,12 @@ namespace llarp
     static constexpr std::chrono::milliseconds DeliveryTimeout = 500ms;
     /// Time how long we wait to recieve a message
     static constexpr auto ReceivalTimeout = (DeliveryTimeout * 8) / 5;
-    /// How long to keep a replay window for
-    static constexpr auto ReplayWindow = (ReceivalTimeout * 3) / 2;
+    /// max messages in flight in either direction on a session
+    static constexpr size_t MaxMessagesInFlight = MaxSendQueueSize;
+    /// how many of the most recent rx msgids we detect replays of
+    static constexpr size_t ReplayWindowSize = MaxMessagesInFlight * 4;
     /// How often to acks RX messages
     static constexpr auto ACKResendInterval = DeliveryTimeout / 2;
-    /// How often to retransmit TX fragments
-    static constexpr auto TXFlushInterval = (DeliveryTimeout / 5) * 4;
     /// How often we send a keepalive
     static constexpr std::chrono::milliseconds PingInterval = 5s;
     /// How long we wait for a session to die with no tx from them
@@ -42,9 +49,10 @@ namespace llarp
 
       /// outbound session
       Session(LinkLayer* parent, const RouterContact& rc,
-              const AddressInfo& ai);
+              const AddressInfo& ai, std::unique_ptr< CongestionControl > cc);
       /// inbound session
-      Session(LinkLayer* parent, const Addr& from);
+      Session(LinkLayer* parent, const Addr& from,
+              std::unique_ptr< CongestionControl > cc);
 
       ~Session() = default;
 
@@ -67,6 +75,10 @@ namespace llarp
       void
       Send_LL(const byte_t* buf, size_t sz);
 
+      /// send many encrypted packets to our remote in one batch
+      void
+      SendMany_LL(const llarp_udp_pkt* pkts, size_t num);
+
       void EncryptAndSend(ILinkSession::Packet_t);
 
       void
@@ -107,7 +119,7 @@ namespace llarp
       size_t
       SendQueueBacklog() const override
       {
-        return m_TXMsgs.size();
+        return m_TXMsgs.Size();
       }
 
       ILinkLayer*
@@ -131,6 +143,12 @@ namespace llarp
         return m_Inbound;
       }
 
+      using CryptoQueue_t = std::vector< Packet_t >;
+
+      /// handle packets a crypto worker decrypted, on the logic thread
+      void
+      HandlePlaintext(CryptoQueue_t& msgs);
+
      private:
       enum class State
       {
@@ -198,15 +216,35 @@ namespace llarp
       void
       ResetRates();
 
-      std::unordered_map< uint64_t, InboundMessage > m_RXMsgs;
-      std::unordered_map< uint64_t, OutboundMessage > m_TXMsgs;
+      MessageWindow< InboundMessage, MaxMessagesInFlight > m_RXMsgs;
+      MessageWindow< OutboundMessage, MaxMessagesInFlight > m_TXMsgs;
+      /// txids queued until the congestion window lets them out, in order
+      std::deque< uint64_t > m_TXPending;
+      /// paces and windows our tx, picks the resend timeout
+      std::unique_ptr< CongestionControl > m_CC;
+      /// picks the fragment size of new tx messages
+      PathMTU m_PathMTU{FragmentSize + XMITOverhead};
+      /// Capability bits the remote told us about in its pings, none until
+      /// then as it might run the baseline protocol
+      byte_t m_RemoteCaps = 0;
+
+      bool
+      RemoteTakesSACK() const
+      {
+        return m_RemoteCaps & eCapSACK;
+      }
+
+      bool
+      RemoteTakesMTUProbes() const
+      {
+        return m_RemoteCaps & eCapMTUP;
+      }
 
-      /// maps rxid to time recieved
-      std::unordered_map< uint64_t, llarp_time_t > m_ReplayFilter;
-      /// set of rx messages to send in next round of multiacks
-      std::unordered_set< uint64_t > m_SendMACKs;
+      /// rxids we are done with
+      ReplayBitmap< ReplayWindowSize > m_ReplayFilter;
+      /// rx messages to send in next round of multiacks, may have dupes
+      std::vector< uint64_t > m_SendMACKs;
 
-      using CryptoQueue_t   = std::vector< Packet_t >;
       using CryptoQueue_ptr = std::shared_ptr< CryptoQueue_t >;
       CryptoQueue_ptr m_EncryptNext;
       CryptoQueue_ptr m_DecryptNext;
@@ -217,9 +255,6 @@ namespace llarp
       void
       DecryptWorker(CryptoQueue_ptr msgs);
 
-      void
-      HandlePlaintext(CryptoQueue_ptr msgs);
-
       void
       HandleGotIntro(Packet_t pkt);
 
@@ -241,6 +276,10 @@ namespace llarp
       void
       SendMACK();
 
+      /// send the xmits of queued messages the congestion window allows
+      void
+      SendPending(llarp_time_t now);
+
       void
       GenerateAndSendIntro();
 
@@ -265,6 +304,14 @@ namespace llarp
       void
       HandleACKS(Packet_t msg);
 
+      void
+      HandleSACK(Packet_t msg);
+
+      /// complete msg if every fragment is acked or resend the lost ones
+      void
+      HandleFragmentsAcked(uint64_t txid, OutboundMessage& msg,
+                           llarp_time_t now);
+
       void
       HandleNACK(Packet_t msg);
 
@@ -276,6 +323,16 @@ namespace llarp
 
       void
       HandleMACK(Packet_t msg);
+
+      /// send a path mtu probe padded to sz bytes on the wire
+      void
+      SendMTUProbe(size_t sz);
+
+      void
+      HandleMTUProbe(Packet_t msg);
+
+      void
+      HandleMTUProbeAck(Packet_t msg);
     };
   }  // namespace iwp
 }  // namespace llarp
@@ -0,0 +1,221 @@
+#ifndef LLARP_IWP_WINDOW_HPP
+#define LLARP_IWP_WINDOW_HPP
+
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace llarp
+{
+  namespace iwp
+  {
+    /// sliding window of in flight messages keyed by msgid
+    ///
+    /// a message lives in slot msgid mod capacity. msgids are handed out in
+    /// order so the live ones sit in a narrow range and rarely collide.
+    /// when they do the window doubles, up to MaxSize slots, after which
+    /// Emplace fails. freed slots keep their storage so a session that has
+    /// warmed up does no allocations for bookkeeping.
+    template < typename T, size_t MaxSize >
+    struct MessageWindow
+    {
+      static_assert((MaxSize & (MaxSize - 1)) == 0,
+                    "MaxSize must be a power of 2");
+
+      static constexpr size_t InitialSize = MaxSize < 16 ? MaxSize : 16;
+
+      /// get the message with this msgid or nullptr
+      T*
+      Find(uint64_t msgid)
+      {
+        if(m_Slots.empty())
+          return nullptr;
+        auto& slot = SlotFor(msgid);
+        return slot.used && slot.msgid == msgid ? &slot.value : nullptr;
+      }
+
+      /// move a message into the window
+      /// returns nullptr and leaves value alone if msgid is already here or
+      /// no slot can be freed up for it without going over MaxSize
+      T*
+      Emplace(uint64_t msgid, T&& value)
+      {
+        if(m_Slots.empty())
+          m_Slots.resize(InitialSize);
+        while(SlotFor(msgid).used)
+        {
+          if(SlotFor(msgid).msgid == msgid || m_Slots.size() >= MaxSize)
+            return nullptr;
+          Grow();
+        }
+        auto& slot = SlotFor(msgid);
+        slot.used  = true;
+        slot.msgid = msgid;
+        slot.value = std::move(value);
+        ++m_Size;
+        return &slot.value;
+      }
+
+      /// remove the message with this msgid, returns true if it was here
+      bool
+      Erase(uint64_t msgid)
+      {
+        if(Find(msgid) == nullptr)
+          return false;
+        Release(SlotFor(msgid));
+        return true;
+      }
+
+      /// remove whatever message blocks msgid from being put in a full window
+      void
+      EvictFor(uint64_t msgid)
+      {
+        if(m_Slots.empty())
+          return;
+        auto& slot = SlotFor(msgid);
+        if(slot.used)
+          Release(slot);
+      }
+
+      /// call visit(msgid, message) on every message
+      template < typename Visit >
+      void
+      ForEach(Visit visit)
+      {
+        for(auto& slot : m_Slots)
+        {
+          if(slot.used)
+            visit(slot.msgid, slot.value);
+        }
+      }
+
+      /// remove every message for which pred(msgid, message) is true
+      template < typename Pred >
+      void
+      EraseIf(Pred pred)
+      {
+        for(auto& slot : m_Slots)
+        {
+          if(slot.used && pred(slot.msgid, slot.value))
+            Release(slot);
+        }
+      }
+
+      size_t
+      Size() const
+      {
+        return m_Size;
+      }
+
+      bool
+      Empty() const
+      {
+        return m_Size == 0;
+      }
+
+      /// number of slots currently allocated
+      size_t
+      Capacity() const
+      {
+        return m_Slots.size();
+      }
+
+     private:
+      struct Slot
+      {
+        bool used      = false;
+        uint64_t msgid = 0;
+        T value;
+      };
+
+      Slot&
+      SlotFor(uint64_t msgid)
+      {
+        return m_Slots[msgid & (m_Slots.size() - 1)];
+      }
+
+      void
+      Release(Slot& slot)
+      {
+        slot.used  = false;
+        slot.value = T{};
+        --m_Size;
+      }
+
+      /// double the slot count, live messages never collide after this
+      /// because they had distinct slots mod the smaller size
+      void
+      Grow()
+      {
+        std::vector< Slot > slots(m_Slots.size() * 2);
+        std::swap(slots, m_Slots);
+        for(auto& slot : slots)
+        {
+          if(slot.used)
+            SlotFor(slot.msgid) = std::move(slot);
+        }
+      }
+
+      std::vector< Slot > m_Slots;
+      size_t m_Size = 0;
+    };
+
+    /// anti replay bitmap over the last Bits msgids
+    ///
+    /// msgids older than the window are reported as seen, so a replayed
+    /// message can never be delivered twice no matter how late it shows up.
+    template < size_t Bits >
+    struct ReplayBitmap
+    {
+      /// return true if msgid was inserted before or is too old to know
+      bool
+      Contains(uint64_t msgid) const
+      {
+        if(msgid >= m_Next)
+          return false;
+        if(m_Next - msgid > Bits)
+          return true;
+        return m_Seen.test(msgid % Bits);
+      }
+
+      /// mark msgid as seen, returns false if it already was
+      bool
+      Insert(uint64_t msgid)
+      {
+        if(msgid >= m_Next)
+        {
+          if(msgid - m_Next >= Bits)
+            m_Seen.reset();
+          else
+          {
+            for(uint64_t id = m_Next; id < msgid; ++id)
+              m_Seen.reset(id % Bits);
+          }
+          m_Next = msgid + 1;
+          m_Seen.set(msgid % Bits);
+          return true;
+        }
+        if(Contains(msgid))
+          return false;
+        m_Seen.set(msgid % Bits);
+        return true;
+      }
+
+      /// number of msgids marked in the window
+      size_t
+      Count() const
+      {
+        return m_Seen.count();
+      }
+
+     private:
+      std::bitset< Bits > m_Seen;
+      /// one past the highest msgid inserted
+      uint64_t m_Next = 0;
+    };
+  }  // namespace iwp
+}  // namespace llarp
+
+#endif
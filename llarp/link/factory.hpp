@@ -4,6 +4,7 @@
 #include <config/key_manager.hpp>
 #include <functional>
 #include <memory>
+#include <string>
 
 #include <link/server.hpp>
 
@@ -24,7 +25,7 @@ namespace llarp
     using Factory = std::function< LinkLayer_ptr(
         std::shared_ptr< KeyManager >, GetRCFunc, LinkMessageHandler,
         SignBufferFunc, SessionEstablishedHandler, SessionRenegotiateHandler,
-        TimeoutHandler, SessionClosedHandler, PumpDoneHandler) >;
+        TimeoutHandler, SessionClosedHandler, PumpDoneHandler, std::string) >;
 
     /// get link type by name string
     /// if invalid returns eLinkUnspec
@@ -118,6 +118,7 @@ namespace llarp
     m_udp.user     = this;
     m_udp.recvfrom = nullptr;
     m_udp.tick     = &ILinkLayer::udp_tick;
+    m_udp.probemtu = 1;
     if(ifname == "*")
     {
       if(!AllInterfaces(af, m_ourAddr))
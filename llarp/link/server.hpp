@@ -86,6 +86,15 @@ namespace llarp
       llarp_ev_udp_sendto(&m_udp, to, pkt);
     }
 
+    /// send many packets to the same address, batching syscalls where
+    /// the event loop supports it
+    void
+    SendManyTo_LL(const llarp::Addr& to, const llarp_udp_pkt* pkts,
+                  size_t num)
+    {
+      llarp_ev_udp_sendmany(&m_udp, to, pkts, num);
+    }
+
     virtual bool
     Configure(llarp_ev_loop_ptr loop, const std::string& ifname, int af,
               uint16_t port);
@@ -115,7 +124,7 @@ namespace llarp
     virtual const char*
     Name() const = 0;
 
-    util::StatusObject
+    virtual util::StatusObject
     ExtractStatus() const EXCLUDES(m_AuthedLinksMutex);
 
     void
@@ -75,7 +75,7 @@ namespace llarp
       llarp::LogError("got LRCM when not permitting transit");
       return false;
     }
-    return AsyncDecrypt(&router->pathContext());
+    return router->pathContext().HandleRelayCommit(*this);
   }
 
   bool
@@ -462,9 +462,9 @@ namespace llarp
     auto frameDecrypt = std::make_shared< LRCMFrameDecrypt >(
         context, std::move(decrypter), this);
 
-    // decrypt frames async
-    frameDecrypt->decrypter->AsyncDecrypt(
-        context->Worker(), frameDecrypt->frames[0], frameDecrypt);
+    // decrypt frames async, batched up with other LRCM
+    context->QueueCommitDecrypt(frameDecrypt->decrypter->DecryptJob(
+        frameDecrypt->frames[0], frameDecrypt));
     return true;
   }
 }  // namespace llarp
@@ -3,13 +3,17 @@
 #include <util/buffer.hpp>
 #include <util/endian.hpp>
 #include <util/mem.hpp>
+#include <util/packet_pool.hpp>
 
 #ifndef _WIN32
 #include <netinet/in.h>
 #endif
 
 #include <algorithm>
+#include <atomic>
+#include <cstddef>
 #include <map>
+#include <new>
 
 namespace llarp
 {
@@ -27,6 +31,101 @@ namespace llarp
       return (uint32_t *)addr.s6_addr;
     }
 
+    using PacketRefs_t = std::atomic< uint32_t >;
+
+    /// packet bytes start this far into a pool block, after the refcount
+    static constexpr size_t PacketDataOffset = alignof(std::max_align_t);
+    static_assert(sizeof(PacketRefs_t) <= PacketDataOffset,
+                  "refcount does not fit in front of the packet");
+
+    static PacketRefs_t *
+    PacketRefs(byte_t *buf)
+    {
+      return reinterpret_cast< PacketRefs_t * >(buf - PacketDataOffset);
+    }
+
+    static byte_t *
+    AllocPacket()
+    {
+      char *block = util::PacketPool::Alloc(PacketDataOffset + IPPacket::MaxSize);
+      new(block) PacketRefs_t(1);
+      return reinterpret_cast< byte_t * >(block + PacketDataOffset);
+    }
+
+    IPPacket::IPPacket(const IPPacket &other)
+        : timestamp(other.timestamp), sz(other.sz), buf(other.buf)
+    {
+      if(buf)
+        PacketRefs(buf)->fetch_add(1, std::memory_order_relaxed);
+    }
+
+    IPPacket::IPPacket(IPPacket &&other) noexcept
+        : timestamp(other.timestamp), sz(other.sz), buf(other.buf)
+    {
+      other.sz  = 0;
+      other.buf = nullptr;
+    }
+
+    IPPacket::~IPPacket()
+    {
+      Release();
+    }
+
+    IPPacket &
+    IPPacket::operator=(const IPPacket &other)
+    {
+      if(other.buf)
+        PacketRefs(other.buf)->fetch_add(1, std::memory_order_relaxed);
+      Release();
+      timestamp = other.timestamp;
+      sz        = other.sz;
+      buf       = other.buf;
+      return *this;
+    }
+
+    IPPacket &
+    IPPacket::operator=(IPPacket &&other) noexcept
+    {
+      if(this == &other)
+        return *this;
+      Release();
+      timestamp = other.timestamp;
+      sz        = other.sz;
+      buf       = other.buf;
+      other.sz  = 0;
+      other.buf = nullptr;
+      return *this;
+    }
+
+    void
+    IPPacket::Release()
+    {
+      if(buf == nullptr)
+        return;
+      auto refs = PacketRefs(buf);
+      if(refs->fetch_sub(1, std::memory_order_acq_rel) == 1)
+      {
+        refs->~PacketRefs_t();
+        util::PacketPool::Free(reinterpret_cast< char * >(refs));
+      }
+      buf = nullptr;
+    }
+
+    byte_t *
+    IPPacket::Writable()
+    {
+      if(buf == nullptr)
+        buf = AllocPacket();
+      else if(PacketRefs(buf)->load(std::memory_order_acquire) > 1)
+      {
+        byte_t *own = AllocPacket();
+        std::copy_n(buf, sz, own);
+        Release();
+        buf = own;
+      }
+      return buf;
+    }
+
     huint128_t
     IPPacket::In6ToHUInt(in6_addr addr)
     {
@@ -86,8 +185,11 @@ namespace llarp
     bool
     IPPacket::Load(const llarp_buffer_t &pkt)
     {
-      if(pkt.sz > sizeof(buf) or pkt.sz == 0)
+      if(pkt.sz > MaxSize or pkt.sz == 0)
         return false;
+      // nothing of the old packet needs to survive the copy on write
+      sz = 0;
+      Writable();
       sz = pkt.sz;
       std::copy_n(pkt.base, sz, buf);
       return true;
@@ -104,7 +206,7 @@ namespace llarp
     ManagedBuffer
     IPPacket::Buffer()
     {
-      byte_t *ptr = buf;
+      byte_t *ptr = Writable();
       llarp_buffer_t b(ptr, sz);
       return ManagedBuffer(b);
     }
@@ -97,8 +97,26 @@ namespace llarp
   namespace net
   {
     /// an Packet
+    ///
+    /// the bytes live in a refcounted block from util::PacketPool, so copies
+    /// and moves only pass a pointer around. copies share the block until one
+    /// of them writes to it, then the writer gets a block of its own.
     struct IPPacket
     {
+      IPPacket() = default;
+
+      IPPacket(const IPPacket& other);
+
+      IPPacket(IPPacket&& other) noexcept;
+
+      ~IPPacket();
+
+      IPPacket&
+      operator=(const IPPacket& other);
+
+      IPPacket&
+      operator=(IPPacket&& other) noexcept;
+
       static huint128_t
       In6ToHUInt(in6_addr addr);
 
@@ -113,8 +131,8 @@ namespace llarp
 
       static constexpr size_t MaxSize = 1500;
       llarp_time_t timestamp;
-      size_t sz;
-      byte_t buf[MaxSize];
+      size_t sz   = 0;
+      byte_t* buf = nullptr;
 
       ManagedBuffer
       Buffer();
@@ -181,7 +199,7 @@ namespace llarp
       inline ip_header*
       Header()
       {
-        return (ip_header*)&buf[0];
+        return (ip_header*)Writable();
       }
 
       inline const ip_header*
@@ -193,7 +211,7 @@ namespace llarp
       inline ipv6_header*
       HeaderV6()
       {
-        return (ipv6_header*)&buf[0];
+        return (ipv6_header*)Writable();
       }
 
       inline const ipv6_header*
@@ -254,6 +272,15 @@ namespace llarp
 
       void
       UpdateIPv6Address(huint128_t src, huint128_t dst);
+
+     private:
+      /// make buf ours alone before a write
+      byte_t*
+      Writable();
+
+      /// drop our reference to buf
+      void
+      Release();
     };
 
   }  // namespace net
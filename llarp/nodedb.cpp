@@ -10,134 +10,116 @@
 #include <util/mem.hpp>
 #include <util/thread/logic.hpp>
 #include <util/thread/thread_pool.hpp>
-#include <dht/kademlia.hpp>
 
 #include <algorithm>
 #include <fstream>
+#include <memory>
 #include <unordered_map>
 #include <utility>
 
 static const char skiplist_subdirs[] = "0123456789abcdef";
 static const std::string RC_FILE_EXT = ".signed";
 
-llarp_nodedb::NetDBEntry::NetDBEntry(llarp::RouterContact value)
-    : rc(std::move(value)), inserted(llarp::time_now_ms())
+llarp::NodeDBSnapshot::Ptr
+llarp_nodedb::GetSnapshot() const
 {
+  return std::atomic_load(&current);
+}
+
+void
+llarp_nodedb::Publish(const std::vector< llarp::RouterContact > &put,
+                      const std::vector< llarp::RouterID > &drop)
+{
+  if(put.empty() && drop.empty())
+    return;
+  const auto now = llarp::time_now_ms();
+  for(const auto &rc : put)
+    insertedAt[rc.pubkey] = now;
+  for(const auto &pk : drop)
+    insertedAt.erase(pk);
+  std::atomic_store(&current, GetSnapshot()->With(put, drop));
 }
 
 bool
 llarp_nodedb::Remove(const llarp::RouterID &pk)
 {
-  bool removed = false;
-  RemoveIf([&](const llarp::RouterContact &rc) -> bool {
-    if(rc.pubkey == pk)
-    {
-      removed = true;
-      return true;
-    }
+  llarp::util::Lock lock(access);
+  if(not GetSnapshot()->Has(pk))
     return false;
-  });
-  return removed;
+  Publish({}, {pk});
+  dirty.insert(pk);
+  return true;
 }
 
 void
 llarp_nodedb::Clear()
 {
   llarp::util::Lock lock(access);
-  entries.clear();
+  insertedAt.clear();
+  std::atomic_store(&current,
+                    std::make_shared< const llarp::NodeDBSnapshot >());
 }
 
 bool
 llarp_nodedb::Get(const llarp::RouterID &pk, llarp::RouterContact &result)
 {
-  llarp::util::Lock l(access);
-  auto itr = entries.find(pk);
-  if(itr == entries.end())
+  const auto rc = GetSnapshot()->Get(pk);
+  if(rc == nullptr)
     return false;
-  result = itr->second.rc;
+  result = *rc;
   return true;
 }
 
 void
 KillRCJobs(const std::set< std::string > &files)
 {
+  std::error_code ec;
   for(const auto &file : files)
-    fs::remove(file);
+    fs::remove(file, ec);
 }
 
 void
 llarp_nodedb::RemoveIf(
     std::function< bool(const llarp::RouterContact &rc) > filter)
 {
-  std::set< std::string > files;
-  {
-    llarp::util::Lock l(access);
-    auto itr = entries.begin();
-    while(itr != entries.end())
-    {
-      if(filter(itr->second.rc))
-      {
-        files.insert(getRCFilePath(itr->second.rc.pubkey));
-        itr = entries.erase(itr);
-      }
-      else
-        ++itr;
-    }
-  }
-
-  disk->addJob(std::bind(&KillRCJobs, files));
+  llarp::util::Lock l(access);
+  std::vector< llarp::RouterID > drop;
+  GetSnapshot()->Visit([&](const llarp::RouterContact &rc) -> bool {
+    if(filter(rc))
+      drop.emplace_back(rc.pubkey);
+    return true;
+  });
+  Publish({}, drop);
+  dirty.insert(drop.begin(), drop.end());
 }
 
 bool
 llarp_nodedb::Has(const llarp::RouterID &pk)
 {
-  llarp::util::Lock lock(access);
-  return entries.find(pk) != entries.end();
+  return GetSnapshot()->Has(pk);
 }
 
 llarp::RouterContact
 llarp_nodedb::FindClosestTo(const llarp::dht::Key_t &location)
 {
-  llarp::RouterContact rc;
-  const llarp::dht::XorMetric compare(location);
-  visit([&rc, compare](const auto &otherRC) -> bool {
-    if(rc.pubkey.IsZero())
-    {
-      rc = otherRC;
-      return true;
-    }
-    if(compare(llarp::dht::Key_t{otherRC.pubkey.as_array()},
-               llarp::dht::Key_t{rc.pubkey.as_array()}))
-      rc = otherRC;
-    return true;
-  });
-  return rc;
+  const auto found = FindClosestTo(location, 1);
+  return found.empty() ? llarp::RouterContact{} : found.front();
 }
 
 std::vector< llarp::RouterContact >
 llarp_nodedb::FindClosestTo(const llarp::dht::Key_t &location,
                             uint32_t numRouters)
 {
-  llarp::util::Lock lock(access);
-  std::vector< const llarp::RouterContact * > all;
-
-  all.reserve(entries.size());
-  for(auto &entry : entries)
-  {
-    all.push_back(&entry.second.rc);
-  }
-
-  auto it_mid = numRouters < all.size() ? all.begin() + numRouters : all.end();
-  std::partial_sort(all.begin(), it_mid, all.end(),
-                    [compare = llarp::dht::XorMetric{location}](
-                        auto *a, auto *b) { return compare(*a, *b); });
-
-  std::vector< llarp::RouterContact > closest;
-  closest.reserve(numRouters);
-  for(auto it = all.begin(); it != it_mid; ++it)
-    closest.push_back(**it);
-
-  return closest;
+  std::vector< llarp::RouterContact > found;
+  if(numRouters == 0)
+    return found;
+  const auto snapshot = GetSnapshot();
+  found.reserve(std::min(size_t{numRouters}, snapshot->size()));
+  snapshot->VisitClosest(location, [&](const llarp::RouterContact &rc) {
+    found.push_back(rc);
+    return found.size() < numRouters;
+  });
+  return found;
 }
 
 /// skiplist directory is hex encoded first nibble
@@ -166,13 +148,42 @@ llarp_nodedb::InsertAsync(llarp::RouterContact rc,
                           std::shared_ptr< llarp::Logic > logic,
                           std::function< void(void) > completionHandler)
 {
-  disk->addJob([this, rc, logic, completionHandler]() {
-    this->Insert(rc);
-    if(logic && completionHandler)
-    {
-      LogicCall(logic, completionHandler);
-    }
-  });
+  bool queued;
+  {
+    llarp::util::Lock lock(pendingAccess);
+    // a flush is already on its way if anything is pending
+    queued = not pendingInserts.empty();
+    pendingInserts.emplace_back(PendingInsert{
+        std::move(rc), std::move(logic), std::move(completionHandler)});
+  }
+  if(not queued)
+    disk->addJob(std::bind(&llarp_nodedb::FlushInserts, this));
+}
+
+void
+llarp_nodedb::FlushInserts()
+{
+  std::vector< PendingInsert > pending;
+  {
+    llarp::util::Lock lock(pendingAccess);
+    pending.swap(pendingInserts);
+  }
+  std::vector< llarp::RouterContact > put;
+  put.reserve(pending.size());
+  for(const auto &insert : pending)
+    put.emplace_back(insert.rc);
+  {
+    llarp::util::Lock lock(access);
+    Publish(put, {});
+    for(const auto &rc : put)
+      dirty.insert(rc.pubkey);
+  }
+  LogDebug("Added or updated ", put.size(), " RCs in nodedb");
+  for(auto &insert : pending)
+  {
+    if(insert.logic && insert.completionHandler)
+      LogicCall(insert.logic, std::move(insert.completionHandler));
+  }
 }
 
 bool
@@ -180,20 +191,19 @@ llarp_nodedb::UpdateAsyncIfNewer(llarp::RouterContact rc,
                                  std::shared_ptr< llarp::Logic > logic,
                                  std::function< void(void) > completionHandler)
 {
-  llarp::util::Lock lock(access);
-  auto itr = entries.find(rc.pubkey);
-  if(itr == entries.end() || itr->second.rc.OtherIsNewer(rc))
+  const auto existing = GetSnapshot()->Get(rc.pubkey);
+  if(existing == nullptr || existing->OtherIsNewer(rc))
   {
     InsertAsync(rc, logic, completionHandler);
     return true;
   }
-  if(itr != entries.end())
-  {
-    // insertion time is set on...insertion.  But it should be updated here
-    // even if there is no insertion of a new RC, to show that the existing one
-    // is not "stale"
-    itr->second.inserted = llarp::time_now_ms();
-  }
+  // insertion time is set on...insertion.  But it should be updated here
+  // even if there is no insertion of a new RC, to show that the existing one
+  // is not "stale"
+  llarp::util::Lock lock(access);
+  auto itr = insertedAt.find(rc.pubkey);
+  if(itr != insertedAt.end())
+    itr->second = llarp::time_now_ms();
   return false;
 }
 
@@ -202,12 +212,10 @@ bool
 llarp_nodedb::Insert(const llarp::RouterContact &rc)
 {
   llarp::util::Lock lock(access);
-  auto itr = entries.find(rc.pubkey.as_array());
-  if(itr != entries.end())
-    entries.erase(itr);
-  entries.emplace(rc.pubkey.as_array(), rc);
+  Publish({rc}, {});
+  dirty.insert(rc.pubkey);
   LogDebug("Added or updated RC for ", llarp::RouterID(rc.pubkey),
-           " to nodedb.  Current nodedb count is: ", entries.size());
+           " to nodedb.  Current nodedb count is: ", GetSnapshot()->size());
   return true;
 }
 
@@ -237,30 +245,38 @@ llarp_nodedb::Load(const fs::path &path)
   return loaded;
 }
 
-void
+bool
 llarp_nodedb::SaveAll()
 {
-  std::array< byte_t, MAX_RC_SIZE > tmp;
-  llarp::util::Lock lock(access);
-  for(const auto &item : entries)
+  std::vector< llarp::RouterContact > put;
+  std::vector< llarp::RouterID > drop;
   {
-    llarp_buffer_t buf(tmp);
-
-    if(!item.second.rc.BEncode(&buf))
-      continue;
+    llarp::util::Lock lock(access);
+    const auto snapshot = GetSnapshot();
+    for(const auto &pk : dirty)
+    {
+      const auto rc = snapshot->Get(pk);
+      if(rc == nullptr)
+        drop.emplace_back(pk);
+      else
+        put.emplace_back(*rc);
+    }
+    dirty.clear();
+  }
 
-    buf.sz              = buf.cur - buf.base;
-    const auto filepath = getRCFilePath(item.second.rc.pubkey);
-    auto optional_ofs   = llarp::util::OpenFileStream< std::ofstream >(
-        filepath,
-        std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
-    if(!optional_ofs)
-      continue;
-    auto &ofs = optional_ofs.value();
-    ofs.write((char *)buf.base, buf.sz);
-    ofs.flush();
-    ofs.close();
+  llarp::util::Lock lock(storeAccess);
+  if(not store.Append(put, drop))
+  {
+    // try again on the next save
+    llarp::util::Lock l(access);
+    for(const auto &rc : put)
+      dirty.insert(rc.pubkey);
+    dirty.insert(drop.begin(), drop.end());
+    return false;
   }
+  if(store.NeedsCompaction() && not store.Compact())
+    LogWarn("failed to compact ", store.File());
+  return true;
 }
 
 bool
@@ -308,7 +324,11 @@ llarp_nodedb::loadfile(const fs::path &fpath)
   }
   {
     llarp::util::Lock lock(access);
-    entries.emplace(rc.pubkey.as_array(), rc);
+    if(not GetSnapshot()->Has(rc.pubkey))
+    {
+      Publish({rc}, {});
+      dirty.insert(rc.pubkey);
+    }
   }
   return true;
 }
@@ -316,14 +336,7 @@ llarp_nodedb::loadfile(const fs::path &fpath)
 void
 llarp_nodedb::visit(std::function< bool(const llarp::RouterContact &) > visit)
 {
-  llarp::util::Lock lock(access);
-  auto itr = entries.begin();
-  while(itr != entries.end())
-  {
-    if(!visit(itr->second.rc))
-      return;
-    ++itr;
-  }
+  GetSnapshot()->Visit(visit);
 }
 
 void
@@ -332,12 +345,13 @@ llarp_nodedb::VisitInsertedBefore(
     llarp_time_t insertedAfter)
 {
   llarp::util::Lock lock(access);
-  auto itr = entries.begin();
-  while(itr != entries.end())
+  const auto snapshot = GetSnapshot();
+  for(const auto &item : insertedAt)
   {
-    if(itr->second.inserted < insertedAfter)
-      visit(itr->second.rc);
-    ++itr;
+    if(item.second >= insertedAfter)
+      continue;
+    if(const auto rc = snapshot->Get(item.first))
+      visit(*rc);
   }
 }
 
@@ -458,103 +472,127 @@ llarp_nodedb::ensure_dir(const char *dir)
   if(ec)
     return false;
 
-  if(!fs::is_directory(path))
-    return false;
+  return fs::is_directory(path);
+}
 
-  for(const char &ch : skiplist_subdirs)
+ssize_t
+llarp_nodedb::LoadStore(llarp::thread::ThreadPool *verifiers)
+{
+  std::vector< llarp::RouterContact > rcs;
+  std::vector< llarp::RouterID > invalid;
   {
-    // this seems to be a problem on all targets
-    // perhaps cpp17::fs is just as screwed-up
-    // attempting to create a folder with no name
-    if(!ch)
-      return true;
-    std::string p;
-    p += ch;
-    fs::path sub = path / p;
-    fs::create_directory(sub, ec);
-    if(ec)
-      return false;
+    llarp::util::Lock lock(storeAccess);
+    if(not store.Open())
+      return -1;
+    rcs.reserve(store.size());
+    store.ForEach(
+        [&](const llarp::RouterID &pk, const llarp_buffer_t &rcbuf) {
+          llarp::RouterContact rc;
+          llarp_buffer_t buf(rcbuf.base, rcbuf.sz);
+          if(rc.BDecode(&buf) && rc.pubkey == pk)
+            rcs.emplace_back(std::move(rc));
+          else
+            invalid.emplace_back(pk);
+        });
   }
-  return true;
+  const auto valid = llarp::VerifyRCs(rcs, llarp::time_now_ms(), verifiers);
+
+  ssize_t loaded = 0;
+  std::vector< llarp::RouterContact > put;
+  put.reserve(rcs.size());
+  llarp::util::Lock lock(access);
+  const auto snapshot = GetSnapshot();
+  for(size_t idx = 0; idx < rcs.size(); ++idx)
+  {
+    if(not valid[idx])
+    {
+      invalid.emplace_back(rcs[idx].pubkey);
+      continue;
+    }
+    if(not snapshot->Has(rcs[idx].pubkey))
+      put.emplace_back(std::move(rcs[idx]));
+    loaded++;
+  }
+  Publish(put, {});
+  for(const auto &pk : invalid)
+  {
+    // drop it from the store on the next save
+    llarp::LogWarn("store has invalid RC for ", pk);
+    dirty.insert(pk);
+  }
+  return loaded;
 }
 
 ssize_t
-llarp_nodedb::LoadAll()
+llarp_nodedb::LoadAll(llarp::thread::ThreadPool *verifiers)
 {
-  return Load(nodePath.c_str());
+  ssize_t loaded = LoadStore(verifiers);
+  if(loaded < 0)
+    return loaded;
+  m_NextSaveToDisk = llarp::time_now_ms() + m_SaveInterval;
+
+  // old layout files are only removed once the store has them on disk, so
+  // any still around are from a run that did not get that far. the store
+  // wins over them for routers both have
+  std::set< std::string > files;
+  for(const char &ch : skiplist_subdirs)
+  {
+    if(!ch)
+      continue;
+    llarp::util::IterDir(nodePath / std::string(1, ch),
+                         [&files](const fs::path &f) -> bool {
+                           if(f.extension() == RC_FILE_EXT)
+                             files.insert(f.string());
+                           return true;
+                         });
+  }
+  if(files.empty())
+    return loaded;
+  const ssize_t migrated = std::max(Load(nodePath), ssize_t(0));
+  LogInfo("moving ", migrated, " RCs into the nodedb store");
+  if(not SaveAll())
+  {
+    LogWarn("keeping the old nodedb files until the store takes them");
+    return loaded + migrated;
+  }
+  // the old files are dead weight from here on
+  disk->addJob(std::bind(&KillRCJobs, files));
+  return loaded + migrated;
 }
 
 size_t
 llarp_nodedb::num_loaded() const
 {
-  auto l = llarp::util::shared_lock(access);
-  return entries.size();
+  return GetSnapshot()->size();
 }
 
 bool
 llarp_nodedb::select_random_exit(llarp::RouterContact &result)
 {
-  llarp::util::Lock lock(access);
-  const auto sz = entries.size();
-  auto itr      = entries.begin();
-  if(sz < 3)
+  const auto snapshot = GetSnapshot();
+  if(snapshot->size() < 3)
     return false;
-  auto idx = llarp::randint() % sz;
-  if(idx)
-    std::advance(itr, idx - 1);
-  while(itr != entries.end())
-  {
-    if(itr->second.rc.IsExit())
-    {
-      result = itr->second.rc;
-      return true;
-    }
-    ++itr;
-  }
-  // wrap around
-  itr = entries.begin();
-  while(idx--)
-  {
-    if(itr->second.rc.IsExit())
-    {
-      result = itr->second.rc;
-      return true;
-    }
-    ++itr;
-  }
-  return false;
+  const auto rc = snapshot->PickExit();
+  if(rc == nullptr)
+    return false;
+  result = *rc;
+  return true;
 }
 
 bool
 llarp_nodedb::select_random_hop_excluding(
     llarp::RouterContact &result, const std::set< llarp::RouterID > &exclude)
 {
-  llarp::util::Lock lock(access);
+  const auto snapshot = GetSnapshot();
   /// checking for "guard" status for N = 0 is done by caller inside of
   /// pathbuilder's scope
-  const size_t sz = entries.size();
-  if(sz < 3)
+  if(snapshot->size() < 3)
   {
     return false;
   }
-
-  const size_t pos = llarp::randint() % sz;
-  const auto start = std::next(entries.begin(), pos);
-  for(auto itr = start; itr != entries.end(); ++itr)
-  {
-    if(exclude.count(itr->first) == 0 and itr->second.rc.IsPublicRouter())
-    {
-      result = itr->second.rc;
-      return true;
-    }
-  }
-  for(auto itr = entries.begin(); itr != start; ++itr)
-  {
-    if(exclude.count(itr->first) == 0 and itr->second.rc.IsPublicRouter())
-    {
-      result = itr->second.rc;
-      return true;
-    }
-  }
-  return false;
+  const auto rc = snapshot->PickHop(exclude);
+  if(rc == nullptr)
+    return false;
+  result = *rc;
+  return true;
 }
@@ -2,15 +2,20 @@
 #define LLARP_NODEDB_HPP
 
 #include <router_contact.hpp>
+#include <rc_store.hpp>
 #include <router_id.hpp>
 #include <util/common.hpp>
 #include <util/fs.hpp>
 #include <util/thread/threading.hpp>
 #include <util/thread/annotations.hpp>
 #include <dht/key.hpp>
+#include <nodedb_snapshot.hpp>
 
 #include <set>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
+#include <vector>
 
 /**
  * nodedb.hpp
@@ -34,8 +39,9 @@ struct llarp_nodedb
 {
   explicit llarp_nodedb(std::shared_ptr< llarp::thread::ThreadPool > diskworker,
                         const std::string rootdir)
-      : disk(std::move(diskworker)), nodePath(rootdir)
-
+      : disk(std::move(diskworker))
+      , nodePath(rootdir)
+      , store(nodePath / llarp::RCStore::FileName)
   {
   }
 
@@ -45,25 +51,28 @@ struct llarp_nodedb
   }
 
   std::shared_ptr< llarp::thread::ThreadPool > disk;
-  mutable llarp::util::Mutex access;  // protects entries
+  /// serializes writers, readers never take it
+  mutable llarp::util::Mutex access;
   /// time for next save to disk event, 0 if never happened
   llarp_time_t m_NextSaveToDisk = 0s;
   /// how often to save to disk
   const llarp_time_t m_SaveInterval = 5min;
 
-  struct NetDBEntry
-  {
-    const llarp::RouterContact rc;
-    llarp_time_t inserted;
-
-    NetDBEntry(llarp::RouterContact data);
-  };
-
-  using NetDBMap_t =
-      std::unordered_map< llarp::RouterID, NetDBEntry, llarp::RouterID::Hash >;
-
-  NetDBMap_t entries GUARDED_BY(access);
   fs::path nodePath;
+  /// when we last heard of every router in the snapshot
+  std::unordered_map< llarp::RouterID, llarp_time_t, llarp::RouterID::Hash >
+      insertedAt GUARDED_BY(access);
+  /// routers inserted or removed since the last save
+  std::unordered_set< llarp::RouterID, llarp::RouterID::Hash > dirty
+      GUARDED_BY(access);
+  mutable llarp::util::Mutex storeAccess;  // protects store
+  /// where the routers are kept between runs
+  llarp::RCStore store GUARDED_BY(storeAccess);
+
+  /// the routers as of the last write. readers keep the snapshot they got
+  /// for as long as they need it while writers publish new ones
+  llarp::NodeDBSnapshot::Ptr
+  GetSnapshot() const;
 
   llarp::RouterContact
   FindClosestTo(const llarp::dht::Key_t &location);
@@ -100,11 +109,13 @@ struct llarp_nodedb
   Insert(const llarp::RouterContact &rc) EXCLUDES(access);
 
   /// invokes Insert() asynchronously with an optional completion
-  /// callback
+  /// callback. inserts queued while the disk thread is busy are published
+  /// together
   void
   InsertAsync(llarp::RouterContact rc,
               std::shared_ptr< llarp::Logic > l             = nullptr,
-              std::function< void(void) > completionHandler = nullptr);
+              std::function< void(void) > completionHandler = nullptr)
+      EXCLUDES(pendingAccess);
 
   /// update rc if newer
   /// return true if we started to put this rc in the database
@@ -115,6 +126,7 @@ struct llarp_nodedb
                      std::function< void(void) > completionHandler = nullptr)
       EXCLUDES(access);
 
+  /// load the old layout of one file per router in skiplist directories
   ssize_t
   Load(const fs::path &path);
 
@@ -134,8 +146,11 @@ struct llarp_nodedb
   void
   set_dir(const char *dir);
 
+  /// load the store, bringing over whatever is left in the old layout.
+  /// signatures are checked in batches on verifiers if we have them
   ssize_t
-  LoadAll();
+  LoadAll(llarp::thread::ThreadPool *verifiers = nullptr)
+      EXCLUDES(access, storeAccess);
 
   ssize_t
   store_dir(const char *dir);
@@ -162,8 +177,38 @@ struct llarp_nodedb
   static bool
   ensure_dir(const char *dir);
 
+  /// append the routers changed since the last save to the store, true
+  /// once they are on disk
+  bool
+  SaveAll() EXCLUDES(access, storeAccess);
+
+ private:
+  struct PendingInsert
+  {
+    llarp::RouterContact rc;
+    std::shared_ptr< llarp::Logic > logic;
+    std::function< void(void) > completionHandler;
+  };
+
+  ssize_t
+  LoadStore(llarp::thread::ThreadPool *verifiers)
+      EXCLUDES(access, storeAccess);
+
+  /// insert everything InsertAsync queued up with one snapshot
   void
-  SaveAll() EXCLUDES(access);
+  FlushInserts() EXCLUDES(access, pendingAccess);
+
+  /// publish the current snapshot with put and drop applied
+  void
+  Publish(const std::vector< llarp::RouterContact > &put,
+          const std::vector< llarp::RouterID > &drop) REQUIRES(access);
+
+  /// only ever swapped with std::atomic_store while holding access
+  llarp::NodeDBSnapshot::Ptr current =
+      std::make_shared< const llarp::NodeDBSnapshot >();
+
+  llarp::util::Mutex pendingAccess;  // protects pendingInserts
+  std::vector< PendingInsert > pendingInserts GUARDED_BY(pendingAccess);
 };
 
 /// struct for async rc verification
@@ -0,0 +1,188 @@
+#include <nodedb_snapshot.hpp>
+
+#include <crypto/crypto.hpp>
+#include <dht/sorted_closest.hpp>
+
+#include <algorithm>
+
+namespace llarp
+{
+  constexpr size_t NodeDBSnapshot::NumShards;
+
+  namespace
+  {
+    using Entry = NodeDBSnapshot::Shard::Entry;
+
+    bool
+    EntryLess(const Entry &a, const Entry &b)
+    {
+      return a.pk < b.pk;
+    }
+  }  // namespace
+
+  NodeDBSnapshot::NodeDBSnapshot()
+  {
+    static const ShardPtr empty = std::make_shared< Shard >();
+    m_Shards.fill(empty);
+    m_Entries.fill(0);
+    m_Hops.fill(0);
+    m_Exits.fill(0);
+  }
+
+  NodeDBSnapshot::Ptr
+  NodeDBSnapshot::With(const std::vector< RouterContact > &put,
+                       const std::vector< RouterID > &drop) const
+  {
+    // changes to every shard in the order they apply, no rc drops the router
+    std::array< std::vector< Entry >, NumShards > changes;
+    for(const auto &rc : put)
+    {
+      changes[rc.pubkey[0]].emplace_back(
+          Entry{rc.pubkey, std::make_shared< const RouterContact >(rc)});
+    }
+    for(const auto &pk : drop)
+      changes[pk[0]].emplace_back(Entry{pk, nullptr});
+
+    auto next = std::make_shared< NodeDBSnapshot >(*this);
+    for(size_t idx = 0; idx < NumShards; ++idx)
+    {
+      auto &change = changes[idx];
+      if(change.empty())
+        continue;
+      std::stable_sort(change.begin(), change.end(), &EntryLess);
+
+      const auto &old = m_Shards[idx]->entries;
+      auto shard      = std::make_shared< Shard >();
+      shard->entries.reserve(old.size() + change.size());
+      auto itr = old.begin();
+      for(auto c = change.begin(); c != change.end(); ++c)
+      {
+        // only the last change of a router counts
+        if(c + 1 != change.end() && (c + 1)->pk == c->pk)
+          continue;
+        while(itr != old.end() && itr->pk < c->pk)
+          shard->entries.emplace_back(*itr++);
+        if(itr != old.end() && itr->pk == c->pk)
+          ++itr;
+        if(c->rc)
+          shard->entries.emplace_back(std::move(*c));
+      }
+      shard->entries.insert(shard->entries.end(), itr, old.end());
+
+      for(uint32_t pos = 0; pos < shard->entries.size(); ++pos)
+      {
+        const auto &rc = *shard->entries[pos].rc;
+        if(rc.IsPublicRouter())
+          shard->hops.emplace_back(pos);
+        if(rc.IsExit())
+          shard->exits.emplace_back(pos);
+      }
+      next->m_Shards[idx] = std::move(shard);
+    }
+
+    for(size_t idx = 0; idx < NumShards; ++idx)
+    {
+      const auto &shard        = *next->m_Shards[idx];
+      next->m_Entries[idx + 1] = next->m_Entries[idx] + shard.entries.size();
+      next->m_Hops[idx + 1]    = next->m_Hops[idx] + shard.hops.size();
+      next->m_Exits[idx + 1]   = next->m_Exits[idx] + shard.exits.size();
+    }
+    return next;
+  }
+
+  std::shared_ptr< const RouterContact >
+  NodeDBSnapshot::Get(const RouterID &pk) const
+  {
+    const auto &entries = m_Shards[pk[0]]->entries;
+    const auto itr      = std::lower_bound(entries.begin(), entries.end(),
+                                           Entry{pk, nullptr}, &EntryLess);
+    if(itr == entries.end() || itr->pk != pk)
+      return nullptr;
+    return itr->rc;
+  }
+
+  void
+  NodeDBSnapshot::Visit(const Visit_t &visit) const
+  {
+    for(const auto &shard : m_Shards)
+    {
+      for(const auto &entry : shard->entries)
+      {
+        if(not visit(*entry.rc))
+          return;
+      }
+    }
+  }
+
+  void
+  NodeDBSnapshot::VisitClosest(const dht::Key_t &target,
+                               const Visit_t &visit) const
+  {
+    // every router in a shard is closer than all of those in shards that are
+    // further away on the first byte
+    for(size_t dist = 0; dist < NumShards; ++dist)
+    {
+      const auto &entries = m_Shards[target[0] ^ dist]->entries;
+      // keys in a shard all share the first byte
+      if(not dht::VisitSortedClosest(
+             entries.begin(), entries.end(), target,
+             [](const Entry &e) -> const RouterID & { return e.pk; },
+             [&visit](auto itr) { return visit(*itr->rc); }, 8))
+        return;
+    }
+  }
+
+  const NodeDBSnapshot::Shard::Entry &
+  NodeDBSnapshot::Nth(const Counts_t &counts, Pool_t pool, size_t nth) const
+  {
+    const size_t idx =
+        std::upper_bound(counts.begin(), counts.end(), nth) - counts.begin()
+        - 1;
+    const Shard &shard = *m_Shards[idx];
+    const size_t pos   = nth - counts[idx];
+    return shard.entries[pool ? (shard.*pool)[pos] : pos];
+  }
+
+  std::shared_ptr< const RouterContact >
+  NodeDBSnapshot::Pick(const Counts_t &counts, Pool_t pool,
+                       const std::set< RouterID > &exclude) const
+  {
+    static constexpr size_t RandomPicks = 16;
+    const size_t sz                     = counts[NumShards];
+    if(sz == 0)
+      return nullptr;
+    for(size_t tries = 0; tries < RandomPicks; ++tries)
+    {
+      const auto &entry = Nth(counts, pool, randint() % sz);
+      if(exclude.count(entry.pk) == 0)
+        return entry.rc;
+    }
+    // most of them are excluded, walk them once from a random start
+    const size_t start = randint() % sz;
+    for(size_t idx = 0; idx < sz; ++idx)
+    {
+      const auto &entry = Nth(counts, pool, (start + idx) % sz);
+      if(exclude.count(entry.pk) == 0)
+        return entry.rc;
+    }
+    return nullptr;
+  }
+
+  std::shared_ptr< const RouterContact >
+  NodeDBSnapshot::PickRouter() const
+  {
+    return Pick(m_Entries, nullptr, {});
+  }
+
+  std::shared_ptr< const RouterContact >
+  NodeDBSnapshot::PickHop(const std::set< RouterID > &exclude) const
+  {
+    return Pick(m_Hops, &Shard::hops, exclude);
+  }
+
+  std::shared_ptr< const RouterContact >
+  NodeDBSnapshot::PickExit() const
+  {
+    return Pick(m_Exits, &Shard::exits, {});
+  }
+}  // namespace llarp
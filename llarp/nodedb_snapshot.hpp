@@ -0,0 +1,127 @@
+#ifndef LLARP_NODEDB_SNAPSHOT_HPP
+#define LLARP_NODEDB_SNAPSHOT_HPP
+
+#include <dht/key.hpp>
+#include <router_contact.hpp>
+#include <router_id.hpp>
+
+#include <array>
+#include <functional>
+#include <memory>
+#include <set>
+#include <vector>
+
+namespace llarp
+{
+  /// immutable view of every router in the nodedb
+  ///
+  /// routers are split into shards on the first byte of their id and every
+  /// shard keeps them sorted by id. a change copies only the shards it
+  /// touches and shares the rest, as well as every rc, with the snapshot it
+  /// was made from. readers hold on to a snapshot for as long as they like
+  /// without ever waiting for a writer.
+  ///
+  /// sorted shards double as the closest router index: keys sharing a prefix
+  /// with the target are a contiguous run, so closest first order comes from
+  /// splitting runs on one bit after another.
+  struct NodeDBSnapshot
+  {
+    static constexpr size_t NumShards = 256;
+
+    using Ptr     = std::shared_ptr< const NodeDBSnapshot >;
+    using Visit_t = std::function< bool(const RouterContact &) >;
+
+    struct Shard
+    {
+      struct Entry
+      {
+        RouterID pk;
+        std::shared_ptr< const RouterContact > rc;
+      };
+
+      /// sorted by pk
+      std::vector< Entry > entries;
+      /// positions in entries of public routers we can use as path hops
+      std::vector< uint32_t > hops;
+      /// positions in entries of routers that offer exit traffic
+      std::vector< uint32_t > exits;
+    };
+
+    using ShardPtr = std::shared_ptr< const Shard >;
+    /// running totals over the shards, shard i starts at [i]
+    using Counts_t = std::array< uint32_t, NumShards + 1 >;
+
+    NodeDBSnapshot();
+
+    /// a snapshot with the rcs in put added or replaced and the routers in
+    /// drop removed, drop wins over put. shards neither touch are shared.
+    Ptr
+    With(const std::vector< RouterContact > &put,
+         const std::vector< RouterID > &drop) const;
+
+    size_t
+    size() const
+    {
+      return m_Entries[NumShards];
+    }
+
+    size_t
+    NumHops() const
+    {
+      return m_Hops[NumShards];
+    }
+
+    size_t
+    NumExits() const
+    {
+      return m_Exits[NumShards];
+    }
+
+    /// the rc of pk or nullptr if we do not have it
+    std::shared_ptr< const RouterContact >
+    Get(const RouterID &pk) const;
+
+    bool
+    Has(const RouterID &pk) const
+    {
+      return Get(pk) != nullptr;
+    }
+
+    /// visit every rc in id order until visit returns false
+    void
+    Visit(const Visit_t &visit) const;
+
+    /// visit rcs closest to target first until visit returns false
+    void
+    VisitClosest(const dht::Key_t &target, const Visit_t &visit) const;
+
+    /// pick a random router, hop or exit not in exclude. takes constant
+    /// expected time as long as exclude covers only a small part of them
+    std::shared_ptr< const RouterContact >
+    PickRouter() const;
+
+    std::shared_ptr< const RouterContact >
+    PickHop(const std::set< RouterID > &exclude) const;
+
+    std::shared_ptr< const RouterContact >
+    PickExit() const;
+
+   private:
+    using Pool_t = std::vector< uint32_t > Shard::*;
+
+    /// the nth router of pool over all shards, pool nullptr means all
+    const Shard::Entry &
+    Nth(const Counts_t &counts, Pool_t pool, size_t nth) const;
+
+    std::shared_ptr< const RouterContact >
+    Pick(const Counts_t &counts, Pool_t pool,
+         const std::set< RouterID > &exclude) const;
+
+    std::array< ShardPtr, NumShards > m_Shards;
+    Counts_t m_Entries;
+    Counts_t m_Hops;
+    Counts_t m_Exits;
+  };
+}  // namespace llarp
+
+#endif
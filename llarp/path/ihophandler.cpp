@@ -1,21 +1,59 @@
 #include <path/ihophandler.hpp>
 
+#include <util/packet_pool.hpp>
+
+#include <algorithm>
+#include <utility>
+
 namespace llarp
 {
   namespace path
   {
+    RelayCell::RelayCell(const llarp_buffer_t& buf, const TunnelNonce& nonce)
+        : Y(nonce)
+        , m_Data(reinterpret_cast< byte_t* >(util::PacketPool::Alloc(buf.sz)))
+        , m_Size(buf.sz)
+    {
+      std::copy_n(buf.base, buf.sz, m_Data);
+    }
+
+    RelayCell::RelayCell(RelayCell&& other) noexcept
+        : Y(other.Y)
+        , pathid(other.pathid)
+        , m_Data(other.m_Data)
+        , m_Size(other.m_Size)
+    {
+      other.m_Data = nullptr;
+      other.m_Size = 0;
+    }
+
+    RelayCell&
+    RelayCell::operator=(RelayCell&& other) noexcept
+    {
+      Y      = other.Y;
+      pathid = other.pathid;
+      std::swap(m_Data, other.m_Data);
+      std::swap(m_Size, other.m_Size);
+      return *this;
+    }
+
+    RelayCell::~RelayCell()
+    {
+      if(m_Data)
+        util::PacketPool::Free(reinterpret_cast< char* >(m_Data));
+    }
+
     // handle data in upstream direction
     bool
     IHopHandler::HandleUpstream(const llarp_buffer_t& X, const TunnelNonce& Y,
                                 AbstractRouter*)
     {
       if(m_UpstreamQueue == nullptr)
-        m_UpstreamQueue = std::make_shared< TrafficQueue_t >();
-      m_UpstreamQueue->emplace_back();
-      auto& pkt = m_UpstreamQueue->back();
-      pkt.first.resize(X.sz);
-      std::copy_n(X.base, X.sz, pkt.first.begin());
-      pkt.second = Y;
+      {
+        m_UpstreamQueue = std::make_shared< UpstreamQueue_t >();
+        m_UpstreamQueue->reserve(m_UpstreamBatch);
+      }
+      m_UpstreamQueue->emplace_back(X, Y);
       return true;
     }
 
@@ -25,12 +63,11 @@ namespace llarp
                                   AbstractRouter*)
     {
       if(m_DownstreamQueue == nullptr)
-        m_DownstreamQueue = std::make_shared< TrafficQueue_t >();
-      m_DownstreamQueue->emplace_back();
-      auto& pkt = m_DownstreamQueue->back();
-      pkt.first.resize(X.sz);
-      std::copy_n(X.base, X.sz, pkt.first.begin());
-      pkt.second = Y;
+      {
+        m_DownstreamQueue = std::make_shared< DownstreamQueue_t >();
+        m_DownstreamQueue->reserve(m_DownstreamBatch);
+      }
+      m_DownstreamQueue->emplace_back(X, Y);
       return true;
     }
   }  // namespace path
@@ -5,6 +5,8 @@
 #include <util/types.hpp>
 #include <crypto/encrypted_frame.hpp>
 #include <messages/relay.hpp>
+#include <path/path_types.hpp>
+#include <util/buffer.hpp>
 #include <vector>
 
 #include <memory>
@@ -22,11 +24,53 @@ namespace llarp
 
   namespace path
   {
+    /// a relayed cell waiting for the worker. the bytes live in a packet pool
+    /// block the size of the cell instead of a max sized link message, so a
+    /// queue of them stays small and grows without copying payloads
+    struct RelayCell
+    {
+      TunnelNonce Y;
+      PathID_t pathid;
+
+      RelayCell(const llarp_buffer_t& buf, const TunnelNonce& nonce);
+
+      RelayCell(RelayCell&& other) noexcept;
+
+      RelayCell&
+      operator=(RelayCell&& other) noexcept;
+
+      RelayCell(const RelayCell&) = delete;
+
+      RelayCell&
+      operator=(const RelayCell&) = delete;
+
+      ~RelayCell();
+
+      byte_t*
+      data() const
+      {
+        return m_Data;
+      }
+
+      size_t
+      size() const
+      {
+        return m_Size;
+      }
+
+     private:
+      byte_t* m_Data = nullptr;
+      size_t m_Size  = 0;
+    };
+
     struct IHopHandler
     {
-      using TrafficEvent_t   = std::pair< std::vector< byte_t >, TunnelNonce >;
-      using TrafficQueue_t   = std::vector< TrafficEvent_t >;
-      using TrafficQueue_ptr = std::shared_ptr< TrafficQueue_t >;
+      /// cells waiting for the worker. each one gets its onion layer done in
+      /// place and is then sent on as is.
+      using UpstreamQueue_t     = std::vector< RelayCell >;
+      using DownstreamQueue_t   = std::vector< RelayCell >;
+      using UpstreamQueue_ptr   = std::shared_ptr< UpstreamQueue_t >;
+      using DownstreamQueue_ptr = std::shared_ptr< DownstreamQueue_t >;
 
       virtual ~IHopHandler() = default;
 
@@ -71,21 +115,23 @@ namespace llarp
 
      protected:
       uint64_t m_SequenceNum = 0;
-      TrafficQueue_ptr m_UpstreamQueue;
-      TrafficQueue_ptr m_DownstreamQueue;
+      UpstreamQueue_ptr m_UpstreamQueue;
+      DownstreamQueue_ptr m_DownstreamQueue;
+      /// size of the last queues we flushed, new ones start out with room
+      /// for as many cells
+      size_t m_UpstreamBatch   = 0;
+      size_t m_DownstreamBatch = 0;
 
       virtual void
-      UpstreamWork(TrafficQueue_ptr queue, AbstractRouter* r) = 0;
+      UpstreamWork(UpstreamQueue_ptr queue, AbstractRouter* r) = 0;
 
       virtual void
-      DownstreamWork(TrafficQueue_ptr queue, AbstractRouter* r) = 0;
+      DownstreamWork(DownstreamQueue_ptr queue, AbstractRouter* r) = 0;
 
       virtual void
-      HandleAllUpstream(std::vector< RelayUpstreamMessage > msgs,
-                        AbstractRouter* r) = 0;
+      HandleAllUpstream(UpstreamQueue_t cells, AbstractRouter* r) = 0;
       virtual void
-      HandleAllDownstream(std::vector< RelayDownstreamMessage > msgs,
-                          AbstractRouter* r) = 0;
+      HandleAllDownstream(DownstreamQueue_t cells, AbstractRouter* r) = 0;
     };
 
     using HopHandler_ptr = std::shared_ptr< IHopHandler >;
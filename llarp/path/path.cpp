@@ -10,6 +10,7 @@
 #include <profiling.hpp>
 #include <router/abstractrouter.hpp>
 #include <routing/dht_message.hpp>
+#include <routing/path_close_message.hpp>
 #include <routing/path_latency_message.hpp>
 #include <routing/transfer_traffic_message.hpp>
 #include <util/buffer.hpp>
@@ -197,6 +198,11 @@ namespace llarp
         auto self = shared_from_this();
         LogicCall(r->logic(), [=]() { self->HandlePathConfirmMessage(r); });
       }
+      else if(_status == ePathIgnore)
+      {
+        // we closed it or gave up on it, the hops did nothing wrong
+        LogDebug(Name(), " is gone, status=", currentStatus);
+      }
       else
       {
         if(failedAt.has_value())
@@ -295,6 +301,13 @@ namespace llarp
       _status = st;
     }
 
+    void
+    Path::Abandon(llarp_time_t now)
+    {
+      m_Abandoned = true;
+      EnterState(ePathIgnore, now);
+    }
+
     util::StatusObject
     PathHopConfig::ExtractStatus() const
     {
@@ -435,14 +448,17 @@ namespace llarp
     }
 
     void
-    Path::HandleAllUpstream(std::vector< RelayUpstreamMessage > msgs,
-                            AbstractRouter* r)
+    Path::HandleAllUpstream(UpstreamQueue_t cells, AbstractRouter* r)
     {
-      for(const auto& msg : msgs)
+      RelayUpstreamMessage msg;
+      for(const auto& cell : cells)
       {
+        msg.X      = llarp_buffer_t(cell.data(), cell.size());
+        msg.Y      = cell.Y;
+        msg.pathid = cell.pathid;
         if(r->SendToOrQueue(Upstream(), &msg))
         {
-          m_TXRate += msg.X.size();
+          m_TXRate += cell.size();
         }
         else
         {
@@ -453,28 +469,22 @@ namespace llarp
     }
 
     void
-    Path::UpstreamWork(TrafficQueue_ptr msgs, AbstractRouter* r)
+    Path::UpstreamWork(UpstreamQueue_ptr msgs, AbstractRouter* r)
     {
-      std::vector< RelayUpstreamMessage > sendmsgs(msgs->size());
-      size_t idx = 0;
-      for(auto& ev : *msgs)
+      for(auto& cell : *msgs)
       {
-        const llarp_buffer_t buf(ev.first);
-        TunnelNonce n = ev.second;
+        const llarp_buffer_t buf(cell.data(), cell.size());
+        TunnelNonce n = cell.Y;
         for(const auto& hop : hops)
         {
           CryptoManager::instance()->xchacha20(buf, hop.shared, n);
           n ^= hop.nonceXOR;
         }
-        auto& msg  = sendmsgs[idx];
-        msg.X      = buf;
-        msg.Y      = ev.second;
-        msg.pathid = TXID();
-        ++idx;
+        cell.pathid = TXID();
       }
-      LogicCall(r->logic(),
-                std::bind(&Path::HandleAllUpstream, shared_from_this(),
-                          std::move(sendmsgs), r));
+      LogicCall(r->logic(), [self = shared_from_this(), msgs, r]() {
+        self->HandleAllUpstream(std::move(*msgs), r);
+      });
     }
 
     void
@@ -482,6 +492,7 @@ namespace llarp
     {
       if(m_UpstreamQueue && !m_UpstreamQueue->empty())
       {
+        m_UpstreamBatch = m_UpstreamQueue->size();
         r->threadpool()->addJob(std::bind(&Path::UpstreamWork,
                                           shared_from_this(),
                                           std::move(m_UpstreamQueue), r));
@@ -494,6 +505,7 @@ namespace llarp
     {
       if(m_DownstreamQueue && !m_DownstreamQueue->empty())
       {
+        m_DownstreamBatch = m_DownstreamQueue->size();
         r->threadpool()->addJob(std::bind(&Path::DownstreamWork,
                                           shared_from_this(),
                                           std::move(m_DownstreamQueue), r));
@@ -508,6 +520,10 @@ namespace llarp
         return true;
       if(_status == ePathBuilding)
         return false;
+      // stay around to close it if it is built after all and to take the
+      // status that comes back
+      if(m_Abandoned)
+        return now >= buildStarted + path::build_timeout;
       if(_status == ePathEstablished || _status == ePathTimeout)
       {
         return now >= ExpireTime();
@@ -526,35 +542,28 @@ namespace llarp
     }
 
     void
-    Path::DownstreamWork(TrafficQueue_ptr msgs, AbstractRouter* r)
+    Path::DownstreamWork(DownstreamQueue_ptr msgs, AbstractRouter* r)
     {
-      std::vector< RelayDownstreamMessage > sendMsgs(msgs->size());
-      size_t idx = 0;
-      for(auto& ev : *msgs)
+      for(auto& cell : *msgs)
       {
-        const llarp_buffer_t buf(ev.first);
-        sendMsgs[idx].Y = ev.second;
+        const llarp_buffer_t buf(cell.data(), cell.size());
         for(const auto& hop : hops)
         {
-          sendMsgs[idx].Y ^= hop.nonceXOR;
-          CryptoManager::instance()->xchacha20(buf, hop.shared,
-                                               sendMsgs[idx].Y);
+          cell.Y ^= hop.nonceXOR;
+          CryptoManager::instance()->xchacha20(buf, hop.shared, cell.Y);
         }
-        sendMsgs[idx].X = buf;
-        ++idx;
       }
-      LogicCall(r->logic(),
-                std::bind(&Path::HandleAllDownstream, shared_from_this(),
-                          std::move(sendMsgs), r));
+      LogicCall(r->logic(), [self = shared_from_this(), msgs, r]() {
+        self->HandleAllDownstream(std::move(*msgs), r);
+      });
     }
 
     void
-    Path::HandleAllDownstream(std::vector< RelayDownstreamMessage > msgs,
-                              AbstractRouter* r)
+    Path::HandleAllDownstream(DownstreamQueue_t cells, AbstractRouter* r)
     {
-      for(const auto& msg : msgs)
+      for(const auto& cell : cells)
       {
-        const llarp_buffer_t buf(msg.X);
+        const llarp_buffer_t buf(cell.data(), cell.size());
         m_RXRate += buf.sz;
         if(!HandleRoutingMessage(buf, r))
         {
@@ -669,6 +678,16 @@ namespace llarp
         FlushUpstream(r);
         return true;
       }
+      if(m_Abandoned)
+      {
+        LogInfo(Name(), " was built after we gave up on it, closing it");
+        routing::PathCloseMessage close;
+        close.S = NextSeqNo();
+        if(!SendRoutingMessage(close, r))
+          return false;
+        FlushUpstream(r);
+        return true;
+      }
       LogWarn("got unwarranted path confirm message on tx=", RXID(),
               " rx=", RXID());
       return false;
@@ -698,6 +717,7 @@ namespace llarp
       {
         intro.latency       = now - m_LastLatencyTestTime;
         m_LastLatencyTestID = 0;
+        r->routerProfiling().MarkPathLatency(this, intro.latency);
         EnterState(ePathEstablished, now);
         if(m_BuiltHook)
           m_BuiltHook(shared_from_this());
@@ -773,6 +793,16 @@ namespace llarp
       return false;
     }
 
+    bool
+    Path::HandlePathCloseMessage(const routing::PathCloseMessage& msg,
+                                 AbstractRouter* r)
+    {
+      (void)msg;
+      (void)r;
+      LogError(Name(), " got unwarranted path close");
+      return false;
+    }
+
     bool
     Path::HandleUpdateExitMessage(const routing::UpdateExitMessage& msg,
                                   AbstractRouter* r)
@@ -205,6 +205,11 @@ namespace llarp
         return _status;
       }
 
+      /// give up on a build we no longer want. if it still gets built we
+      /// close it rather than wait for its hops to expire it
+      void
+      Abandon(llarp_time_t now);
+
       const std::string&
       ShortName() const;
 
@@ -338,6 +343,10 @@ namespace llarp
       HandlePathLatencyMessage(const routing::PathLatencyMessage& msg,
                                AbstractRouter* r) override;
 
+      bool
+      HandlePathCloseMessage(const routing::PathCloseMessage& msg,
+                             AbstractRouter* r) override;
+
       bool
       HandlePathTransferMessage(const routing::PathTransferMessage& msg,
                                 AbstractRouter* r) override;
@@ -400,18 +409,16 @@ namespace llarp
 
      protected:
       void
-      UpstreamWork(TrafficQueue_ptr queue, AbstractRouter* r) override;
+      UpstreamWork(UpstreamQueue_ptr queue, AbstractRouter* r) override;
 
       void
-      DownstreamWork(TrafficQueue_ptr queue, AbstractRouter* r) override;
+      DownstreamWork(DownstreamQueue_ptr queue, AbstractRouter* r) override;
 
       void
-      HandleAllUpstream(std::vector< RelayUpstreamMessage > msgs,
-                        AbstractRouter* r) override;
+      HandleAllUpstream(UpstreamQueue_t cells, AbstractRouter* r) override;
 
       void
-      HandleAllDownstream(std::vector< RelayDownstreamMessage > msgs,
-                          AbstractRouter* r) override;
+      HandleAllDownstream(DownstreamQueue_t cells, AbstractRouter* r) override;
 
      private:
       /// call obtained exit hooks
@@ -432,6 +439,7 @@ namespace llarp
       uint64_t m_UpdateExitTX            = 0;
       uint64_t m_CloseExitTX             = 0;
       uint64_t m_ExitObtainTX            = 0;
+      bool m_Abandoned                   = false;
       PathStatus _status;
       PathRole _role;
       util::DecayingHashSet< TunnelNonce > m_UpstreamReplayFilter;
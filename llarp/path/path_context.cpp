@@ -11,6 +11,8 @@ namespace llarp
   {
     static constexpr auto DefaultPathBuildLimit = 500ms;
 
+    constexpr size_t PathContext::MaxCommitBatch;
+
     PathContext::PathContext(AbstractRouter* router)
         : m_Router(router)
         , m_AllowTransit(false)
@@ -51,6 +53,82 @@ namespace llarp
 #endif
     }
 
+    bool
+    PathContext::HandleRelayCommit(const LR_CommitMessage& msg)
+    {
+      return msg.AsyncDecrypt(this);
+    }
+
+    void
+    PathContext::QueueCommitDecrypt(CommitDecrypt job)
+    {
+      {
+        util::Lock lock(m_CommitsMutex);
+        if(m_PendingCommits.empty())
+          m_CommitBatchStarted = CommitClock_t::now();
+        m_PendingCommits.emplace_back(std::move(job));
+        if(m_PendingCommits.size() < MaxCommitBatch)
+          return;
+      }
+      FlushCommitDecrypts();
+    }
+
+    void
+    PathContext::FlushCommitDecrypts()
+    {
+      struct Batch
+      {
+        std::vector< CommitDecrypt > jobs;
+        CommitClock_t::time_point started;
+        std::atomic< size_t > running;
+      };
+      auto batch = std::make_shared< Batch >();
+      {
+        util::Lock lock(m_CommitsMutex);
+        if(m_PendingCommits.empty())
+          return;
+        batch->jobs    = std::move(m_PendingCommits);
+        batch->started = m_CommitBatchStarted;
+        m_PendingCommits.clear();
+      }
+      // one job per worker thread, each doing a contiguous run of decrypts
+      auto worker          = Worker();
+      const size_t numJobs = batch->jobs.size();
+      const size_t chunks =
+          std::max(size_t{1}, std::min(worker->threadCount(), numJobs));
+      const size_t chunkSize = (numJobs + chunks - 1) / chunks;
+      batch->running         = (numJobs + chunkSize - 1) / chunkSize;
+      for(size_t begin = 0; begin < numJobs; begin += chunkSize)
+      {
+        const size_t end = std::min(begin + chunkSize, numJobs);
+        worker->addJob([stats = m_CommitStats, batch, begin, end]() {
+          for(size_t idx = begin; idx < end; ++idx)
+            batch->jobs[idx]();
+          if(--batch->running > 0)
+            return;
+          const auto latency =
+              std::chrono::duration_cast< std::chrono::microseconds >(
+                  CommitClock_t::now() - batch->started);
+          stats->lastLatency = latency.count();
+          ++stats->batchesDone;
+          LogDebug("decrypted ", batch->jobs.size(), " LRCM in ",
+                   latency.count(), "us");
+        });
+      }
+    }
+
+    uint64_t
+    PathContext::LastCommitBatchLatency() const
+    {
+      return m_CommitStats->lastLatency;
+    }
+
+    uint64_t
+    PathContext::CommitBatchesDone() const
+    {
+      return m_CommitStats->batchesDone;
+    }
+
     std::shared_ptr< Logic >
     PathContext::logic()
     {
@@ -294,6 +372,35 @@ namespace llarp
       return map.size() / 2;
     }
 
+    bool
+    PathContext::StartRelaying(size_t numLanes)
+    {
+      m_Relay = std::make_unique< RelayEngine >(numLanes, 1024);
+      return m_Relay->Start();
+    }
+
+    void
+    PathContext::StopRelaying()
+    {
+      if(m_Relay)
+        m_Relay->Stop();
+    }
+
+    bool
+    PathContext::QueueRelayWork(const PathID_t& id, size_t numBytes,
+                                RelayEngine::Job job)
+    {
+      return m_Relay && m_Relay->AddJob(id, numBytes, std::move(job));
+    }
+
+    util::StatusObject
+    PathContext::ExtractRelayStatus() const
+    {
+      if(m_Relay)
+        return m_Relay->ExtractStatus();
+      return util::StatusObject{{"lanes", 0}};
+    }
+
     void
     PathContext::PutTransitHop(std::shared_ptr< TransitHop > hop)
     {
@@ -5,6 +5,7 @@
 #include <path/ihophandler.hpp>
 #include <path/path_types.hpp>
 #include <path/pathset.hpp>
+#include <path/relay_engine.hpp>
 #include <path/transit_hop.hpp>
 #include <routing/handler.hpp>
 #include <router/i_outbound_message_handler.hpp>
@@ -12,8 +13,11 @@
 #include <util/decaying_hashset.hpp>
 #include <util/types.hpp>
 
+#include <atomic>
+#include <functional>
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 namespace llarp
 {
@@ -63,6 +67,30 @@ namespace llarp
       bool
       HandleRelayCommit(const LR_CommitMessage& msg);
 
+      /// most LRCM frame decrypts we hold back before handing them out
+      static constexpr size_t MaxCommitBatch = 32;
+
+      /// decrypts the frame of one LRCM, runs on the worker pool
+      using CommitDecrypt = std::function< void(void) >;
+
+      /// queue up the frame decrypt of a LRCM. pending decrypts go out to the
+      /// worker pool together once the batch is full or on the next pump.
+      void
+      QueueCommitDecrypt(CommitDecrypt job);
+
+      /// hand every pending LRCM frame decrypt to the worker pool
+      void
+      FlushCommitDecrypts();
+
+      /// microseconds the last batch of LRCM decrypts took from its first
+      /// decrypt being queued to its last one done
+      uint64_t
+      LastCommitBatchLatency() const;
+
+      /// number of LRCM decrypt batches done so far
+      uint64_t
+      CommitBatchesDone() const;
+
       void
       PutTransitHop(std::shared_ptr< TransitHop > hop);
 
@@ -167,12 +195,45 @@ namespace llarp
       uint64_t
       CurrentTransitPaths();
 
+      /// start relaying transit traffic on numLanes worker threads
+      bool
+      StartRelaying(size_t numLanes);
+
+      void
+      StopRelaying();
+
+      /// queue the relay work of transit path id, false if we are not
+      /// relaying
+      bool
+      QueueRelayWork(const PathID_t& id, size_t numBytes,
+                     RelayEngine::Job job);
+
+      util::StatusObject
+      ExtractRelayStatus() const;
+
      private:
       AbstractRouter* m_Router;
       SyncTransitMap_t m_TransitPaths;
       SyncOwnedPathsMap_t m_OurPaths;
       bool m_AllowTransit;
       util::DecayingHashSet< llarp::Addr > m_PathLimits;
+
+      using CommitClock_t = std::chrono::steady_clock;
+
+      util::Mutex m_CommitsMutex;  // protects m_PendingCommits
+      std::vector< CommitDecrypt > m_PendingCommits GUARDED_BY(m_CommitsMutex);
+      CommitClock_t::time_point m_CommitBatchStarted
+          GUARDED_BY(m_CommitsMutex);
+      /// filled in by the last job of each batch on a worker, shared with
+      /// the jobs so they never touch a context that went away under them
+      struct CommitStats
+      {
+        std::atomic< uint64_t > lastLatency{0};
+        std::atomic< uint64_t > batchesDone{0};
+      };
+      const std::shared_ptr< CommitStats > m_CommitStats =
+          std::make_shared< CommitStats >();
+      std::unique_ptr< RelayEngine > m_Relay;
     };
   }  // namespace path
 }  // namespace llarp
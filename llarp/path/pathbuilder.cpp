@@ -175,7 +175,10 @@ namespace llarp
     {
       const auto now = llarp::time_now_ms();
       ExpirePaths(now, m_router);
-      if(ShouldBuildMore(now))
+      TickSpeculativeBuilds(now);
+      if(ShouldBuildSpeculatively(now))
+        BuildSpeculatively();
+      else if(ShouldBuildMore(now))
         BuildOne();
       TickPaths(m_router);
       if(m_BuildStats.attempts > 50)
@@ -238,20 +241,27 @@ namespace llarp
         return got;
       }
 
+      // draw a few good routers and let profiling weigh them against each
+      // other on latency and reliability
+      static constexpr size_t HopCandidates = 4;
+      std::vector< RouterContact > candidates;
+      std::set< RouterID > excluding = exclude;
       do
       {
-        cur.Clear();
         --tries;
-        std::set< RouterID > excluding = exclude;
-        if(db->select_random_hop_excluding(cur, excluding))
+        RouterContact rc;
+        if(db->select_random_hop_excluding(rc, excluding))
         {
-          excluding.insert(cur.pubkey);
-          if(!m_router->routerProfiling().IsBadForPath(cur.pubkey))
-            return true;
+          excluding.insert(rc.pubkey);
+          if(!m_router->routerProfiling().IsBadForPath(rc.pubkey))
+            candidates.emplace_back(std::move(rc));
         }
-      } while(tries > 0);
+      } while(tries > 0 && candidates.size() < HopCandidates);
 
-      return false;
+      if(candidates.empty())
+        return false;
+      cur = candidates[m_router->routerProfiling().PickHop(candidates)];
+      return true;
     }
 
     bool
@@ -303,6 +313,60 @@ namespace llarp
         Build(hops, roles);
     }
 
+    bool
+    Builder::ShouldBuildSpeculatively(llarp_time_t now) const
+    {
+      if(buildBudget < 2 || not m_SpeculativeBuilds.empty())
+        return false;
+      return NumInStatus(ePathEstablished) == 0 && ShouldBuildMore(now);
+    }
+
+    void
+    Builder::BuildSpeculatively()
+    {
+      m_SpeculativeKeep =
+          std::max(size_t{1}, std::min(numPaths, buildBudget / 2));
+      for(size_t idx = 0; idx < buildBudget; ++idx)
+      {
+        std::vector< RouterContact > hops(numHops);
+        if(not SelectHops(m_router->nodedb(), hops))
+          break;
+        auto path = StartBuild(hops, ePathRoleAny);
+        if(path == nullptr)
+          break;
+        m_SpeculativeBuilds.emplace_back(std::move(path));
+      }
+      if(not m_SpeculativeBuilds.empty())
+        LogInfo(Name(), " has no paths, building ", m_SpeculativeBuilds.size(),
+                " at once");
+    }
+
+    void
+    Builder::TickSpeculativeBuilds(llarp_time_t now)
+    {
+      if(m_SpeculativeBuilds.empty())
+        return;
+      size_t built = 0, building = 0;
+      for(const auto& path : m_SpeculativeBuilds)
+      {
+        if(path->Status() == ePathBuilding)
+          ++building;
+        else if(path->IsReady())
+          ++built;
+      }
+      if(building > 0 && built < m_SpeculativeKeep)
+        return;
+      for(const auto& path : m_SpeculativeBuilds)
+      {
+        if(path->Status() != ePathBuilding)
+          continue;
+        // too slow, the ones we keep already won
+        LogInfo(Name(), " dropping straggling build ", path->ShortName());
+        path->Abandon(now);
+      }
+      m_SpeculativeBuilds.clear();
+    }
+
     bool Builder::UrgentBuild(llarp_time_t) const
     {
       return buildIntervalLimit > MIN_PATH_BUILD_INTERVAL * 4;
@@ -430,9 +494,16 @@ namespace llarp
 
     void
     Builder::Build(const std::vector< RouterContact >& hops, PathRole roles)
+    {
+      StartBuild(hops, roles);
+    }
+
+    Path_ptr
+    Builder::StartBuild(const std::vector< RouterContact >& hops,
+                        PathRole roles)
     {
       if(IsStopped())
-        return;
+        return nullptr;
       lastBuild = Now();
       // async generate keys
       auto ctx     = std::make_shared< AsyncPathKeyExchangeContext >();
@@ -449,6 +520,7 @@ namespace llarp
           [self](Path_ptr p) { self->HandlePathBuilt(p); });
       ctx->AsyncGenerateKeys(path, m_router->logic(), m_router->threadpool(),
                              &PathBuilderKeysGenerated);
+      return path;
     }
 
     void
@@ -23,6 +23,10 @@ namespace llarp
       /// flag for PathSet::Stop()
       std::atomic< bool > _run;
 
+      /// start building a path over hops, nullptr if we are stopped
+      virtual Path_ptr
+      StartBuild(const std::vector< RouterContact >& hops, PathRole roles);
+
       virtual bool
       UrgentBuild(llarp_time_t now) const;
 
@@ -38,12 +42,33 @@ namespace llarp
       DoBuildAlignedTo(const RouterID remote,
                        std::vector< RouterContact >& hops);
 
+      /// true if we have no usable path and nothing speculative going on
+      bool
+      ShouldBuildSpeculatively(llarp_time_t now) const;
+
+      /// launch up to buildBudget builds at once
+      void
+      BuildSpeculatively();
+
+      /// once enough of the speculative builds are done drop the rest
+      void
+      TickSpeculativeBuilds(llarp_time_t now);
+
+      /// paths of the current speculative round
+      std::vector< Path_ptr > m_SpeculativeBuilds;
+      /// how many of them we keep
+      size_t m_SpeculativeKeep = 0;
+
      public:
       AbstractRouter* m_router;
       SecretKey enckey;
       size_t numHops;
       llarp_time_t lastBuild          = 0s;
       llarp_time_t buildIntervalLimit = MIN_PATH_BUILD_INTERVAL;
+      /// while we have no usable path build this many at once, keep the
+      /// first half of them to finish and close the stragglers. 1 turns
+      /// speculative builds off, only endpoints turn them on.
+      size_t buildBudget = 1;
 
       /// construct
       Builder(AbstractRouter* p_router, size_t numPaths, size_t numHops);
@@ -0,0 +1,74 @@
+#include <path/relay_engine.hpp>
+
+#include <util/logging/logger.hpp>
+
+#include <string>
+
+namespace llarp
+{
+  namespace path
+  {
+    RelayEngine::Lane::Lane(size_t idx, size_t maxJobs)
+        : worker(1, maxJobs, "relay-" + std::to_string(idx))
+    {
+    }
+
+    RelayEngine::RelayEngine(size_t numLanes, size_t maxJobsPerLane)
+    {
+      m_Lanes.reserve(numLanes);
+      for(size_t idx = 0; idx < std::max(numLanes, size_t{1}); ++idx)
+        m_Lanes.emplace_back(std::make_unique< Lane >(idx, maxJobsPerLane));
+    }
+
+    bool
+    RelayEngine::Start()
+    {
+      for(const auto& lane : m_Lanes)
+      {
+        if(not lane->worker.start())
+          return false;
+      }
+      LogInfo("relaying transit traffic on ", m_Lanes.size(), " lanes");
+      return true;
+    }
+
+    void
+    RelayEngine::Stop()
+    {
+      for(const auto& lane : m_Lanes)
+        lane->worker.stop();
+    }
+
+    size_t
+    RelayEngine::LaneFor(const PathID_t& id) const
+    {
+      return PathID_t::Hash{}(id) % m_Lanes.size();
+    }
+
+    bool
+    RelayEngine::AddJob(const PathID_t& id, size_t numBytes, Job job)
+    {
+      auto& lane = *m_Lanes[LaneFor(id)];
+      return lane.worker.addJob([&lane, numBytes, job = std::move(job)]() {
+        job();
+        lane.relayedBytes += numBytes;
+      });
+    }
+
+    std::vector< uint64_t >
+    RelayEngine::RelayedBytes() const
+    {
+      std::vector< uint64_t > bytes;
+      for(const auto& lane : m_Lanes)
+        bytes.emplace_back(lane->relayedBytes.load());
+      return bytes;
+    }
+
+    util::StatusObject
+    RelayEngine::ExtractStatus() const
+    {
+      return util::StatusObject{{"lanes", m_Lanes.size()},
+                                {"relayedBytes", RelayedBytes()}};
+    }
+  }  // namespace path
+}  // namespace llarp
@@ -0,0 +1,68 @@
+#ifndef LLARP_PATH_RELAY_ENGINE_HPP
+#define LLARP_PATH_RELAY_ENGINE_HPP
+
+#include <path/path_types.hpp>
+#include <util/status.hpp>
+#include <util/thread/thread_pool.hpp>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace llarp
+{
+  namespace path
+  {
+    /// relays transit traffic on lanes of one worker thread each. the work
+    /// of a path always goes to the same lane, so it runs in the order it
+    /// was queued and stays on one core.
+    struct RelayEngine
+    {
+      using Job = std::function< void(void) >;
+
+      RelayEngine(size_t numLanes, size_t maxJobsPerLane);
+
+      bool
+      Start();
+
+      void
+      Stop();
+
+      size_t
+      NumLanes() const
+      {
+        return m_Lanes.size();
+      }
+
+      /// the lane the work of path id goes to
+      size_t
+      LaneFor(const PathID_t& id) const;
+
+      /// queue job relaying numBytes of traffic for path id, false if we are
+      /// not running
+      bool
+      AddJob(const PathID_t& id, size_t numBytes, Job job);
+
+      /// bytes relayed so far on each lane
+      std::vector< uint64_t >
+      RelayedBytes() const;
+
+      util::StatusObject
+      ExtractStatus() const;
+
+     private:
+      struct Lane
+      {
+        Lane(size_t idx, size_t maxJobs);
+
+        thread::ThreadPool worker;
+        std::atomic< uint64_t > relayedBytes{0};
+      };
+
+      std::vector< std::unique_ptr< Lane > > m_Lanes;
+    };
+  }  // namespace path
+}  // namespace llarp
+
+#endif
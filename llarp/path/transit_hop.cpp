@@ -10,6 +10,7 @@
 #include <path/path_context.hpp>
 #include <path/transit_hop.hpp>
 #include <router/abstractrouter.hpp>
+#include <routing/path_close_message.hpp>
 #include <routing/path_latency_message.hpp>
 #include <routing/path_transfer_message.hpp>
 #include <routing/handler.hpp>
@@ -32,13 +33,7 @@ namespace llarp
       return stream;
     }
 
-    TransitHop::TransitHop() : m_UpstreamGather(128), m_DownstreamGather(128)
-    {
-      m_UpstreamGather.enable();
-      m_DownstreamGather.enable();
-      m_UpstreamWorkCounter   = 0;
-      m_DownstreamWorkCounter = 0;
-    }
+    TransitHop::TransitHop() = default;
 
     bool
     TransitHop::Expired(llarp_time_t now) const
@@ -123,86 +118,50 @@ namespace llarp
     }
 
     void
-    TransitHop::DownstreamWork(TrafficQueue_ptr msgs, AbstractRouter* r)
+    TransitHop::DownstreamWork(DownstreamQueue_ptr msgs, AbstractRouter* r)
     {
-      m_DownstreamWorkCounter++;
-      auto flushIt = [self = shared_from_this(), r]() {
-        std::vector< RelayDownstreamMessage > msgs;
-        do
-        {
-          auto maybe = self->m_DownstreamGather.tryPopFront();
-          if(not maybe.has_value())
-            break;
-          msgs.emplace_back(maybe.value());
-        } while(true);
-        self->HandleAllDownstream(std::move(msgs), r);
-      };
-      for(auto& ev : *msgs)
+      if(m_Stopped)
+        return;
+      for(auto& cell : *msgs)
       {
-        RelayDownstreamMessage msg;
-        const llarp_buffer_t buf(ev.first);
-        msg.pathid = info.rxID;
-        msg.Y      = ev.second ^ nonceXOR;
-        CryptoManager::instance()->xchacha20(buf, pathKey, ev.second);
-        msg.X = buf;
-        llarp::LogDebug("relay ", msg.X.size(), " bytes downstream from ",
+        const llarp_buffer_t buf(cell.data(), cell.size());
+        CryptoManager::instance()->xchacha20(buf, pathKey, cell.Y);
+        cell.pathid = info.rxID;
+        cell.Y ^= nonceXOR;
+        llarp::LogDebug("relay ", cell.size(), " bytes downstream from ",
                         info.upstream, " to ", info.downstream);
-        if(m_DownstreamGather.full())
-        {
-          LogicCall(r->logic(), flushIt);
-        }
-        if(m_DownstreamGather.enabled())
-          m_DownstreamGather.pushBack(msg);
       }
-      m_DownstreamWorkCounter--;
-      if(m_DownstreamWorkCounter == 0)
-        LogicCall(r->logic(), flushIt);
+      // our lane runs the work of this hop in order so this stays in order
+      LogicCall(r->logic(), [self = shared_from_this(), msgs, r]() {
+        self->HandleAllDownstream(std::move(*msgs), r);
+      });
     }
 
     void
-    TransitHop::UpstreamWork(TrafficQueue_ptr msgs, AbstractRouter* r)
+    TransitHop::UpstreamWork(UpstreamQueue_ptr msgs, AbstractRouter* r)
     {
-      m_UpstreamWorkCounter++;
-      auto flushIt = [self = shared_from_this(), r]() {
-        std::vector< RelayUpstreamMessage > msgs;
-        do
-        {
-          auto maybe = self->m_UpstreamGather.tryPopFront();
-          if(not maybe.has_value())
-            break;
-          msgs.emplace_back(maybe.value());
-        } while(true);
-        self->HandleAllUpstream(std::move(msgs), r);
-      };
-      for(auto& ev : *msgs)
+      if(m_Stopped)
+        return;
+      for(auto& cell : *msgs)
       {
-        const llarp_buffer_t buf(ev.first);
-        RelayUpstreamMessage msg;
-        CryptoManager::instance()->xchacha20(buf, pathKey, ev.second);
-        msg.pathid = info.txID;
-        msg.Y      = ev.second ^ nonceXOR;
-        msg.X      = buf;
-        if(m_UpstreamGather.full())
-        {
-          LogicCall(r->logic(), flushIt);
-        }
-        if(m_UpstreamGather.enabled())
-          m_UpstreamGather.pushBack(msg);
+        const llarp_buffer_t buf(cell.data(), cell.size());
+        CryptoManager::instance()->xchacha20(buf, pathKey, cell.Y);
+        cell.pathid = info.txID;
+        cell.Y ^= nonceXOR;
       }
-      m_UpstreamWorkCounter--;
-      if(m_UpstreamWorkCounter == 0)
-        LogicCall(r->logic(), flushIt);
+      LogicCall(r->logic(), [self = shared_from_this(), msgs, r]() {
+        self->HandleAllUpstream(std::move(*msgs), r);
+      });
     }
 
     void
-    TransitHop::HandleAllUpstream(std::vector< RelayUpstreamMessage > msgs,
-                                  AbstractRouter* r)
+    TransitHop::HandleAllUpstream(UpstreamQueue_t cells, AbstractRouter* r)
     {
       if(IsEndpoint(r->pubkey()))
       {
-        for(const auto& msg : msgs)
+        for(const auto& cell : cells)
         {
-          const llarp_buffer_t buf(msg.X);
+          const llarp_buffer_t buf(cell.data(), cell.size());
           if(!r->ParseRoutingMessageBuffer(buf, this, info.rxID))
           {
             LogWarn("invalid upstream data on endpoint ", info);
@@ -218,10 +177,15 @@ namespace llarp
       }
       else
       {
-        for(const auto& msg : msgs)
+        // one message to send every cell through, it holds a max sized cell
+        RelayUpstreamMessage msg;
+        for(const auto& cell : cells)
         {
-          llarp::LogDebug("relay ", msg.X.size(), " bytes upstream from ",
+          llarp::LogDebug("relay ", cell.size(), " bytes upstream from ",
                           info.downstream, " to ", info.upstream);
+          msg.X      = llarp_buffer_t(cell.data(), cell.size());
+          msg.Y      = cell.Y;
+          msg.pathid = cell.pathid;
           r->SendToOrQueue(info.upstream, &msg);
         }
       }
@@ -229,26 +193,47 @@ namespace llarp
     }
 
     void
-    TransitHop::HandleAllDownstream(std::vector< RelayDownstreamMessage > msgs,
-                                    AbstractRouter* r)
+    TransitHop::HandleAllDownstream(DownstreamQueue_t cells, AbstractRouter* r)
     {
-      for(const auto& msg : msgs)
+      RelayDownstreamMessage msg;
+      for(const auto& cell : cells)
       {
-        llarp::LogDebug("relay ", msg.X.size(), " bytes downstream from ",
+        llarp::LogDebug("relay ", cell.size(), " bytes downstream from ",
                         info.upstream, " to ", info.downstream);
+        msg.X      = llarp_buffer_t(cell.data(), cell.size());
+        msg.Y      = cell.Y;
+        msg.pathid = cell.pathid;
         r->SendToOrQueue(info.downstream, &msg);
       }
       r->linkManager().PumpLinks();
     }
 
+    /// bytes of traffic in queue
+    template < typename Queue_t >
+    static size_t
+    QueuedBytes(const Queue_t& queue)
+    {
+      size_t sz = 0;
+      for(const auto& cell : queue)
+        sz += cell.size();
+      return sz;
+    }
+
     void
     TransitHop::FlushUpstream(AbstractRouter* r)
     {
+      // both directions of a hop go to the lane of its tx id
       if(m_UpstreamQueue && !m_UpstreamQueue->empty())
-        r->threadpool()->addJob(std::bind(&TransitHop::UpstreamWork,
-                                          shared_from_this(),
-                                          std::move(m_UpstreamQueue), r));
-
+      {
+        m_UpstreamBatch = m_UpstreamQueue->size();
+        // count before the queue gets moved into the job, the order call
+        // arguments are evaluated in is up to the compiler
+        const auto bytes = QueuedBytes(*m_UpstreamQueue);
+        r->pathContext().QueueRelayWork(
+            info.txID, bytes,
+            std::bind(&TransitHop::UpstreamWork, shared_from_this(),
+                      std::move(m_UpstreamQueue), r));
+      }
       m_UpstreamQueue = nullptr;
     }
 
@@ -256,9 +241,14 @@ namespace llarp
     TransitHop::FlushDownstream(AbstractRouter* r)
     {
       if(m_DownstreamQueue && !m_DownstreamQueue->empty())
-        r->threadpool()->addJob(std::bind(&TransitHop::DownstreamWork,
-                                          shared_from_this(),
-                                          std::move(m_DownstreamQueue), r));
+      {
+        m_DownstreamBatch = m_DownstreamQueue->size();
+        const auto bytes = QueuedBytes(*m_DownstreamQueue);
+        r->pathContext().QueueRelayWork(
+            info.txID, bytes,
+            std::bind(&TransitHop::DownstreamWork, shared_from_this(),
+                      std::move(m_DownstreamQueue), r));
+      }
       m_DownstreamQueue = nullptr;
     }
 
@@ -280,6 +270,19 @@ namespace llarp
       return SendRoutingMessage(reply, r);
     }
 
+    bool
+    TransitHop::HandlePathCloseMessage(
+        __attribute__((unused)) const llarp::routing::PathCloseMessage& msg,
+        AbstractRouter* r)
+    {
+      // a failed status makes every hop on the way back let go of the path
+      llarp::LogInfo("closing path ", info);
+      SetSelfDestruct();
+      return LR_StatusMessage::CreateAndSend(r, info.rxID, info.downstream,
+                                             pathKey,
+                                             LR_StatusRecord::FAIL_CLOSED);
+    }
+
     bool
     TransitHop::HandlePathConfirmMessage(
         __attribute__((unused)) const llarp::routing::PathConfirmMessage& msg,
@@ -474,8 +477,7 @@ namespace llarp
     void
     TransitHop::Stop()
     {
-      m_UpstreamGather.disable();
-      m_DownstreamGather.disable();
+      m_Stopped = true;
     }
 
     void
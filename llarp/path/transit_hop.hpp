@@ -163,6 +163,10 @@ namespace llarp
       HandlePathLatencyMessage(const routing::PathLatencyMessage& msg,
                                AbstractRouter* r) override;
 
+      bool
+      HandlePathCloseMessage(const routing::PathCloseMessage& msg,
+                             AbstractRouter* r) override;
+
       bool
       HandleObtainExitMessage(const routing::ObtainExitMessage& msg,
                               AbstractRouter* r) override;
@@ -212,18 +216,16 @@ namespace llarp
 
      protected:
       void
-      UpstreamWork(TrafficQueue_ptr queue, AbstractRouter* r) override;
+      UpstreamWork(UpstreamQueue_ptr queue, AbstractRouter* r) override;
 
       void
-      DownstreamWork(TrafficQueue_ptr queue, AbstractRouter* r) override;
+      DownstreamWork(DownstreamQueue_ptr queue, AbstractRouter* r) override;
 
       void
-      HandleAllUpstream(std::vector< RelayUpstreamMessage > msgs,
-                        AbstractRouter* r) override;
+      HandleAllUpstream(UpstreamQueue_t cells, AbstractRouter* r) override;
 
       void
-      HandleAllDownstream(std::vector< RelayDownstreamMessage > msgs,
-                          AbstractRouter* r) override;
+      HandleAllDownstream(DownstreamQueue_t cells, AbstractRouter* r) override;
 
      private:
       void
@@ -235,10 +237,8 @@ namespace llarp
       std::set< std::shared_ptr< TransitHop >,
                 ComparePtr< std::shared_ptr< TransitHop > > >
           m_FlushOthers;
-      thread::Queue< RelayUpstreamMessage > m_UpstreamGather;
-      thread::Queue< RelayDownstreamMessage > m_DownstreamGather;
-      std::atomic< uint32_t > m_UpstreamWorkCounter;
-      std::atomic< uint32_t > m_DownstreamWorkCounter;
+      /// set once we stopped relaying for this hop
+      std::atomic< bool > m_Stopped{false};
     };
 
     inline std::ostream&
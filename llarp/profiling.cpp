@@ -1,8 +1,12 @@
 #include <profiling.hpp>
 
-#include <fstream>
+#include <crypto/crypto.hpp>
 #include <util/fs.hpp>
 
+#include <algorithm>
+#include <fstream>
+#include <limits>
+
 namespace llarp
 {
   bool
@@ -13,6 +17,8 @@ namespace llarp
 
     if(!BEncodeWriteDictInt("g", connectGoodCount, buf))
       return false;
+    if(!BEncodeWriteDictInt("l", latency.count(), buf))
+      return false;
     if(!BEncodeWriteDictInt("p", pathSuccessCount, buf))
       return false;
     if(!BEncodeWriteDictInt("s", pathFailCount, buf))
@@ -43,6 +49,8 @@ namespace llarp
       return false;
     if(!BEncodeMaybeReadDictInt("p", pathSuccessCount, read, k, buf))
       return false;
+    if(!BEncodeMaybeReadDictInt("l", latency, read, k, buf))
+      return false;
     return read;
   }
 
@@ -97,8 +105,36 @@ namespace llarp
     return checkIsGood(pathFailCount, pathSuccessCount, chances);
   }
 
-  Profiling::Profiling() : m_DisableProfiling(false)
+  double
+  RouterProfile::HopScore() const
   {
+    // per hop latency at which a router is worth half one without any
+    static constexpr auto ReferenceLatency = 100ms;
+
+    // routers we know nothing about land in the middle on every count
+    const double success =
+        (pathSuccessCount + 1.0) / (pathSuccessCount + pathFailCount + 2.0);
+    const auto lat = latency == 0s ? ReferenceLatency : latency;
+    const double speed =
+        double(ReferenceLatency.count()) / (ReferenceLatency + lat).count();
+    return success * speed;
+  }
+
+  void
+  RouterProfile::AddLatency(llarp_time_t sample)
+  {
+    // same gain as the tcp smoothed rtt
+    latency = latency == 0s ? sample : (latency * 7 + sample) / 8;
+  }
+
+  Profiling::Profiling() : m_DisableProfiling(false), m_HopRandomness(25)
+  {
+  }
+
+  void
+  Profiling::SetHopRandomness(uint32_t percent)
+  {
+    m_HopRandomness.store(std::min(percent, uint32_t{100}));
   }
 
   void
@@ -188,6 +224,48 @@ namespace llarp
     m_Profiles[r].lastUpdated = llarp::time_now_ms();
   }
 
+  void
+  Profiling::MarkPathLatency(path::Path* p, llarp_time_t latency)
+  {
+    if(p->hops.empty())
+      return;
+    // we only see the whole round trip, every hop gets an equal share and
+    // the averages sort out who is slow over many paths
+    const auto share = latency / p->hops.size();
+    util::Lock lock(m_ProfilesMutex);
+    for(const auto& hop : p->hops)
+      m_Profiles[hop.rc.pubkey].AddLatency(share);
+  }
+
+  size_t
+  Profiling::PickHop(const std::vector< RouterContact >& candidates)
+  {
+    if(candidates.size() < 2)
+      return 0;
+    if(m_DisableProfiling.load() || randint() % 100 < m_HopRandomness.load())
+      return randint() % candidates.size();
+
+    static const RouterProfile unknown{};
+    // running total of the scores up to each candidate
+    std::vector< double > totals;
+    totals.reserve(candidates.size());
+    double total = 0;
+    {
+      util::Lock lock(m_ProfilesMutex);
+      for(const auto& rc : candidates)
+      {
+        const auto itr = m_Profiles.find(rc.pubkey);
+        total += (itr == m_Profiles.end() ? unknown : itr->second).HopScore();
+        totals.emplace_back(total);
+      }
+    }
+    const double pick =
+        total * (double(randint()) / std::numeric_limits< uint64_t >::max());
+    const size_t idx =
+        std::upper_bound(totals.begin(), totals.end(), pick) - totals.begin();
+    return std::min(idx, candidates.size() - 1);
+  }
+
   void
   Profiling::MarkPathFail(path::Path* p)
   {
@@ -8,6 +8,7 @@
 
 #include <util/thread/annotations.hpp>
 #include <map>
+#include <vector>
 
 namespace llarp
 {
@@ -21,6 +22,9 @@ namespace llarp
     llarp_time_t lastUpdated        = 0s;
     llarp_time_t lastDecay          = 0s;
     uint64_t version                = LLARP_PROTO_VERSION;
+    /// smoothed share of a path's latency per hop for paths over this
+    /// router, 0s until one was measured
+    llarp_time_t latency = 0s;
 
     bool
     BEncode(llarp_buffer_t* buf) const;
@@ -37,6 +41,13 @@ namespace llarp
     bool
     IsGoodForPath(uint64_t chances) const;
 
+    /// how much path builds favour this router as a hop, higher is better
+    double
+    HopScore() const;
+
+    void
+    AddLatency(llarp_time_t sample);
+
     /// decay stats
     void
     Decay();
@@ -79,6 +90,21 @@ namespace llarp
     void
     MarkHopFail(const RouterID& r) EXCLUDES(m_ProfilesMutex);
 
+    /// feed a measured round trip over p to the latency of its hops
+    void
+    MarkPathLatency(path::Path* p, llarp_time_t latency)
+        EXCLUDES(m_ProfilesMutex);
+
+    /// index of the candidate to use as a path hop, picked with a chance
+    /// weighted by HopScore or, HopRandomness percent of the time, uniformly
+    /// at random so new and slow routers keep getting tried
+    size_t
+    PickHop(const std::vector< RouterContact >& candidates)
+        EXCLUDES(m_ProfilesMutex);
+
+    void
+    SetHopRandomness(uint32_t percent);
+
     void
     ClearProfile(const RouterID& r) EXCLUDES(m_ProfilesMutex);
 
@@ -115,6 +141,7 @@ namespace llarp
     std::map< RouterID, RouterProfile > m_Profiles GUARDED_BY(m_ProfilesMutex);
     llarp_time_t m_LastSave = 0s;
     std::atomic< bool > m_DisableProfiling;
+    std::atomic< uint32_t > m_HopRandomness;
   };
 
 }  // namespace llarp
@@ -0,0 +1,316 @@
+#include <rc_store.hpp>
+
+#include <util/endian.hpp>
+#include <util/logging/logger.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+
+#ifdef _WIN32
+#include <fstream>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace llarp
+{
+  constexpr const char* RCStore::FileName;
+  constexpr size_t RCStore::MagicSize;
+  constexpr size_t RCStore::RecordHeaderSize;
+  constexpr size_t RCStore::CompactMinSize;
+
+  const byte_t RCStore::Magic[MagicSize] = {'l', 'l', 'a', 'r',
+                                            'p', 'r', 'c', 1};
+
+  namespace
+  {
+    /// write data to fpath, after what is there if append, and only return
+    /// once it is on disk
+    bool
+    WriteSynced(const fs::path& fpath, const std::vector< byte_t >& data,
+                bool append)
+    {
+#ifdef _WIN32
+      auto optional_f = util::OpenFileStream< std::ofstream >(
+          fpath, std::ios::binary | (append ? std::ios::app : std::ios::trunc));
+      if(not optional_f)
+        return false;
+      auto& f = optional_f.value();
+      f.write(reinterpret_cast< const char* >(data.data()), data.size());
+      f.flush();
+      return f.good();
+#else
+      const int flags =
+          O_WRONLY | O_CREAT | O_CLOEXEC | (append ? O_APPEND : O_TRUNC);
+      const int fd = ::open(fpath.string().c_str(), flags, 0644);
+      if(fd == -1)
+        return false;
+      const byte_t* ptr = data.data();
+      size_t left       = data.size();
+      while(left > 0)
+      {
+        const ssize_t wrote = ::write(fd, ptr, left);
+        if(wrote == -1)
+        {
+          if(errno == EINTR)
+            continue;
+          ::close(fd);
+          return false;
+        }
+        ptr += wrote;
+        left -= wrote;
+      }
+      const bool synced = ::fsync(fd) == 0;
+      return ::close(fd) == 0 && synced;
+#endif
+    }
+
+    /// make files created in or renamed into dir survive a crash
+    bool
+    SyncDir(const fs::path& dir)
+    {
+#ifdef _WIN32
+      (void)dir;
+      return true;
+#else
+      const auto path = dir.empty() ? fs::path(".") : dir;
+      const int fd = ::open(path.string().c_str(), O_RDONLY | O_CLOEXEC);
+      if(fd == -1)
+        return false;
+      const bool synced = ::fsync(fd) == 0;
+      ::close(fd);
+      return synced;
+#endif
+    }
+
+    /// a fresh file at fpath holding data, all of it on disk
+    bool
+    WriteFresh(const fs::path& fpath, const std::vector< byte_t >& data)
+    {
+      return WriteSynced(fpath, data, false) && SyncDir(fpath.parent_path());
+    }
+  }  // namespace
+
+  RCStore::RCStore(fs::path fpath) : m_File(std::move(fpath))
+  {
+  }
+
+  bool
+  RCStore::Open()
+  {
+    Close();
+    std::error_code ec;
+    const std::vector< byte_t > empty(Magic, Magic + MagicSize);
+    if(not fs::exists(m_File, ec) && not WriteFresh(m_File, empty))
+    {
+      LogError("cannot create ", m_File);
+      return false;
+    }
+    if(not m_Map.Open(m_File))
+    {
+      LogError("cannot map ", m_File);
+      return false;
+    }
+    const byte_t* data = m_Map.data();
+    const size_t sz    = m_Map.size();
+    if(sz < MagicSize || not std::equal(Magic, Magic + MagicSize, data))
+    {
+      // not ours, keep it around for a human and start over
+      LogError(m_File, " is not a nodedb store, moving it aside");
+      m_Map.Close();
+      fs::path aside = m_File;
+      aside += ".bad";
+      fs::rename(m_File, aside, ec);
+      if(ec)
+        return false;
+      return Open();
+    }
+
+    uint64_t off = MagicSize;
+    while(off + RecordHeaderSize <= sz)
+    {
+      uint32_t recsz;
+      std::memcpy(&recsz, data + off, sizeof(recsz));
+      recsz = le32toh(recsz);
+      if(off + RecordHeaderSize + recsz > sz)
+        break;
+      const RouterID pk(data + off + sizeof(recsz));
+      auto itr = m_Index.find(pk);
+      if(itr != m_Index.end())
+      {
+        m_LiveBytes -= RecordHeaderSize + itr->second.size;
+        m_Index.erase(itr);
+      }
+      if(recsz)
+      {
+        m_Index.emplace(pk, Record{off + RecordHeaderSize, recsz});
+        m_LiveBytes += RecordHeaderSize + recsz;
+      }
+      off += RecordHeaderSize + recsz;
+    }
+    m_End = off;
+    if(m_End < sz)
+    {
+      // we died in the middle of an append
+      LogWarn("cutting ", sz - m_End, " bytes of torn record off ", m_File);
+      m_Map.Close();
+      fs::resize_file(m_File, m_End, ec);
+      if(ec || not m_Map.Open(m_File))
+      {
+        Close();
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool
+  RCStore::Remap()
+  {
+    if(m_End == 0)
+      return Open();
+    if(m_Map.size() >= m_End)
+      return true;
+    return m_Map.Open(m_File);
+  }
+
+  void
+  RCStore::ForEach(const Visit_t& visit)
+  {
+    if(not Remap())
+      return;
+    for(const auto& item : m_Index)
+    {
+      const Record& rec = item.second;
+      if(rec.offset + rec.size > m_Map.size())
+        continue;
+      const llarp_buffer_t buf(m_Map.data() + rec.offset, rec.size);
+      visit(item.first, buf);
+    }
+  }
+
+  bool
+  RCStore::Append(const std::vector< RouterContact >& put,
+                  const std::vector< RouterID >& drop)
+  {
+    if(m_End == 0 && not Open())
+      return false;
+
+    std::vector< byte_t > out;
+    out.reserve(put.size() * (RecordHeaderSize + MAX_RC_SIZE / 4)
+                + drop.size() * RecordHeaderSize);
+    std::vector< std::pair< RouterID, Record > > added;
+    auto addRecord = [&](const RouterID& pk, const byte_t* rc, uint32_t sz) {
+      const uint64_t off  = m_End + out.size();
+      const uint32_t lesz = htole32(sz);
+      const auto* szptr   = reinterpret_cast< const byte_t* >(&lesz);
+      out.insert(out.end(), szptr, szptr + sizeof(lesz));
+      out.insert(out.end(), pk.begin(), pk.end());
+      out.insert(out.end(), rc, rc + sz);
+      added.emplace_back(pk, Record{off + RecordHeaderSize, sz});
+    };
+
+    std::array< byte_t, MAX_RC_SIZE > tmp;
+    for(const auto& rc : put)
+    {
+      llarp_buffer_t buf(tmp);
+      if(not rc.BEncode(&buf))
+        continue;
+      addRecord(rc.pubkey, tmp.data(), buf.cur - buf.base);
+    }
+    for(const auto& pk : drop)
+    {
+      if(m_Index.count(pk))
+        addRecord(pk, nullptr, 0);
+    }
+    if(added.empty())
+      return true;
+
+    if(not WriteSynced(m_File, out, true))
+    {
+      // we do not know how much made it, reindex from disk on next use
+      LogError("failed to append to ", m_File);
+      Close();
+      return false;
+    }
+
+    for(const auto& item : added)
+    {
+      auto itr = m_Index.find(item.first);
+      if(itr != m_Index.end())
+      {
+        m_LiveBytes -= RecordHeaderSize + itr->second.size;
+        m_Index.erase(itr);
+      }
+      if(item.second.size)
+      {
+        m_Index.emplace(item.first, item.second);
+        m_LiveBytes += RecordHeaderSize + item.second.size;
+      }
+    }
+    m_End += out.size();
+    return true;
+  }
+
+  bool
+  RCStore::NeedsCompaction() const
+  {
+    if(m_End < CompactMinSize)
+      return false;
+    return m_End - MagicSize - m_LiveBytes > m_LiveBytes;
+  }
+
+  bool
+  RCStore::Compact()
+  {
+    if(not Remap())
+      return false;
+    std::vector< byte_t > out(Magic, Magic + MagicSize);
+    out.reserve(MagicSize + m_LiveBytes);
+    for(const auto& item : m_Index)
+    {
+      const Record& rec = item.second;
+      if(rec.offset + rec.size > m_Map.size())
+        return false;
+      const byte_t* start = m_Map.data() + rec.offset - RecordHeaderSize;
+      out.insert(out.end(), start, start + RecordHeaderSize + rec.size);
+    }
+
+    fs::path tmpPath = m_File;
+    tmpPath += ".tmp";
+    std::error_code ec;
+    // the new file has to be on disk before it replaces the old one
+    if(not WriteSynced(tmpPath, out, false))
+    {
+      fs::remove(tmpPath, ec);
+      return false;
+    }
+    const uint64_t before = m_End;
+    m_Map.Close();
+    fs::rename(tmpPath, m_File, ec);
+    if(ec)
+    {
+      LogError("failed to replace ", m_File, ": ", ec.message());
+      fs::remove(tmpPath, ec);
+      Open();
+      return false;
+    }
+    if(not SyncDir(m_File.parent_path()))
+      LogWarn("failed to sync the directory of ", m_File);
+    LogDebug("compacted ", m_File, " from ", before, " to ", out.size(),
+             " bytes");
+    return Open();
+  }
+
+  void
+  RCStore::Close()
+  {
+    m_Map.Close();
+    m_Index.clear();
+    m_End       = 0;
+    m_LiveBytes = 0;
+  }
+}  // namespace llarp
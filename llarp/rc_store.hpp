@@ -0,0 +1,107 @@
+#ifndef LLARP_RC_STORE_HPP
+#define LLARP_RC_STORE_HPP
+
+#include <router_contact.hpp>
+#include <router_id.hpp>
+#include <util/buffer.hpp>
+#include <util/fs.hpp>
+#include <util/mapped_file.hpp>
+
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace llarp
+{
+  /// append only file holding the bencoded router contacts of a nodedb
+  ///
+  /// the file starts with Magic and is followed by records of a 4 byte
+  /// little endian size, the 32 byte router id and size bytes of rc. a later
+  /// record for a router replaces the earlier ones and a record of size 0
+  /// drops the router. opening the store maps the file and indexes the newest
+  /// record of every router without decoding any of them. once most of the
+  /// file is replaced records it is rewritten with only the live ones.
+  struct RCStore
+  {
+    using Visit_t =
+        std::function< void(const RouterID&, const llarp_buffer_t&) >;
+
+    /// name of the store inside the nodedb directory
+    static constexpr const char* FileName = "nodedb.store";
+
+    static constexpr size_t MagicSize = 8;
+    static const byte_t Magic[MagicSize];
+
+    /// record size and router id in front of every rc
+    static constexpr size_t RecordHeaderSize = 4 + RouterID::SIZE;
+
+    /// smallest file we bother compacting
+    static constexpr size_t CompactMinSize = 64 * 1024;
+
+    explicit RCStore(fs::path fpath);
+
+    RCStore(const RCStore&) = delete;
+    RCStore&
+    operator=(const RCStore&) = delete;
+
+    const fs::path&
+    File() const
+    {
+      return m_File;
+    }
+
+    /// map and index the store, creating an empty one if there is none.
+    /// a torn record at the end of the file is cut off
+    bool
+    Open();
+
+    /// visit the newest rc of every router in the store
+    void
+    ForEach(const Visit_t& visit);
+
+    /// number of routers in the store
+    size_t
+    size() const
+    {
+      return m_Index.size();
+    }
+
+    /// append put and drop records for the given routers with one write,
+    /// true once they are on disk
+    bool
+    Append(const std::vector< RouterContact >& put,
+           const std::vector< RouterID >& drop);
+
+    /// true if most of the file is records that were replaced or dropped
+    bool
+    NeedsCompaction() const;
+
+    /// rewrite the store with only the newest record of every router
+    bool
+    Compact();
+
+    void
+    Close();
+
+   private:
+    struct Record
+    {
+      uint64_t offset;
+      uint32_t size;
+    };
+
+    /// make sure everything we appended is visible through the mapping
+    bool
+    Remap();
+
+    fs::path m_File;
+    util::MappedFile m_Map;
+    std::unordered_map< RouterID, Record, RouterID::Hash > m_Index;
+    /// where the next record goes
+    uint64_t m_End = 0;
+    /// bytes taken by the newest records of the routers in m_Index
+    uint64_t m_LiveBytes = 0;
+  };
+}  // namespace llarp
+
+#endif
@@ -8,6 +8,7 @@
 #include <crypto/crypto.hpp>
 #include <dht/context.hpp>
 #include <dht/node.hpp>
+#include <iwp/congestion.hpp>
 #include <iwp/iwp.hpp>
 #include <link/server.hpp>
 #include <messages/link_message.hpp>
@@ -20,6 +21,7 @@
 #include <util/logging/logger_syslog.hpp>
 #include <util/logging/logger.hpp>
 #include <util/meta/memfn.hpp>
+#include <util/packet_pool.hpp>
 #include <util/str.hpp>
 #include <ev/ev.hpp>
 
@@ -84,7 +86,9 @@ namespace llarp
           {"services", _hiddenServiceContext.ExtractStatus()},
           {"exit", _exitContext.ExtractStatus()},
           {"links", _linkManager.ExtractStatus()},
-          {"outboundMessages", _outboundMessageHandler.ExtractStatus()}};
+          {"outboundMessages", _outboundMessageHandler.ExtractStatus()},
+          {"relay", paths.ExtractRelayStatus()},
+          {"packetPool", util::PacketPool::ExtractStatus()}};
     }
     else
     {
@@ -133,19 +137,11 @@ namespace llarp
       return _rcLookupHandler.GetRandomWhitelistRouter(router);
     }
 
-    auto pick_router = [&](auto &collection) -> bool {
-      const auto sz = collection.size();
-      auto itr      = collection.begin();
-      if(sz == 0)
-        return false;
-      if(sz > 1)
-        std::advance(itr, randint() % sz);
-      router = itr->first;
-      return true;
-    };
-
-    auto l = util::shared_lock(nodedb()->access);
-    return pick_router(nodedb()->entries);
+    const auto rc = nodedb()->GetSnapshot()->PickRouter();
+    if(rc == nullptr)
+      return false;
+    router = rc->pubkey;
+    return true;
   }
 
   void
@@ -162,6 +158,8 @@ namespace llarp
       return;
     }
     _lastPump = now;
+    paths.FlushCommitDecrypts();
+    hiddenServiceContext().FlushFrameDecrypts();
     paths.PumpDownstream();
     paths.PumpUpstream();
 
@@ -296,6 +294,7 @@ namespace llarp
   {
     LogInfo("closing router");
     llarp_ev_loop_stop(_netloop);
+    paths.StopRelaying();
     disk->stop();
     disk->shutdown();
   }
@@ -394,6 +393,13 @@ namespace llarp
                "' as that is invalid");
       return false;
     }
+    const auto congestion = conf->router.congestionControl();
+    if(iwp::CongestionControl::Create(congestion) == nullptr)
+    {
+      LogError("no such congestion control algorithm '", congestion, "'");
+      return false;
+    }
+    m_CongestionControl = congestion;
 
     // IWP config
     m_OutboundPort = std::get< LinksConfig::Port >(conf->links.outboundLink());
@@ -557,7 +563,7 @@ namespace llarp
           util::memFn(&IOutboundSessionMaker::OnConnectTimeout,
                       &_outboundSessionMaker),
           util::memFn(&AbstractRouter::SessionClosed, this),
-          util::memFn(&AbstractRouter::PumpLL, this));
+          util::memFn(&AbstractRouter::PumpLL, this), m_CongestionControl);
 
       const auto &key = std::get< LinksConfig::Interface >(serverConfig);
       int af          = std::get< LinksConfig::AddressFamily >(serverConfig);
@@ -582,6 +588,8 @@ namespace llarp
         LogWarn("router profiling explicitly disabled");
       }
     }
+    if(conf->network.pathRandomness() >= 0)
+      routerProfiling().SetHopRandomness(conf->network.pathRandomness());
 
     if(!conf->network.routerProfilesFile().empty())
     {
@@ -967,6 +975,12 @@ namespace llarp
       return false;
     }
 
+    if(!paths.StartRelaying(cryptoworker->threadCount()))
+    {
+      LogError("relay workers failed to start");
+      return false;
+    }
+
     routerProfiling().Load(routerProfilesFile.c_str());
 
     Addr publicAddr(this->addrInfo);
@@ -1083,7 +1097,7 @@ namespace llarp
     }
 
     {
-      ssize_t loaded = _nodedb->LoadAll();
+      ssize_t loaded = _nodedb->LoadAll(cryptoworker.get());
       llarp::LogInfo("loaded ", loaded, " RCs");
       if(loaded < 0)
       {
@@ -1275,7 +1289,8 @@ namespace llarp
                 util::memFn(&IOutboundSessionMaker::OnConnectTimeout,
                             &_outboundSessionMaker),
                 util::memFn(&AbstractRouter::SessionClosed, this),
-                util::memFn(&AbstractRouter::PumpLL, this));
+                util::memFn(&AbstractRouter::PumpLL, this),
+                m_CongestionControl);
 
     if(!link)
       return false;
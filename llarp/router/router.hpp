@@ -10,6 +10,7 @@
 #include <ev/ev.h>
 #include <exit/context.hpp>
 #include <handlers/tun.hpp>
+#include <iwp/congestion.hpp>
 #include <link/factory.hpp>
 #include <link/link_manager.hpp>
 #include <link/server.hpp>
@@ -177,6 +178,8 @@ namespace llarp
     AddressInfo addrInfo;
 
     LinkFactory::LinkType _defaultLinkType;
+    /// congestion control algorithm of our links
+    std::string m_CongestionControl = iwp::CongestionControl::DefaultAlgorithm;
 
     llarp_ev_loop_ptr _netloop;
     std::shared_ptr< llarp::thread::ThreadPool > cryptoworker;
@@ -7,14 +7,69 @@
 #include <util/buffer.hpp>
 #include <util/logging/logger.hpp>
 #include <util/mem.hpp>
+#include <util/decaying_hashset.hpp>
 #include <util/printer.hpp>
+#include <util/thread/thread_pool.hpp>
+#include <util/thread/threading.hpp>
 #include <util/time.hpp>
 
+#include <atomic>
 #include <fstream>
+#include <future>
 #include <util/fs.hpp>
 
 namespace llarp
 {
+  namespace
+  {
+    /// rcs verified in one job of VerifyRCs
+    constexpr size_t VerifyBatchSize = 32;
+
+    /// digests of signed rcs whose signature checked out, shared by every
+    /// thread verifying rcs
+    struct VerifiedCache
+    {
+      /// how long we trust a digest we verified
+      static constexpr std::chrono::milliseconds Interval = 1h;
+      /// how often we forget digests older than Interval
+      static constexpr std::chrono::milliseconds DecayInterval = 1min;
+
+      bool
+      Contains(const ShortHash &digest)
+      {
+        auto l = util::shared_lock(mutex);
+        return digests.Contains(digest);
+      }
+
+      void
+      Insert(const ShortHash &digest)
+      {
+        const auto now = time_now_ms();
+        util::Lock l(mutex);
+        digests.Insert(digest, now);
+        if(now >= nextDecay)
+        {
+          digests.Decay(now);
+          nextDecay = now + DecayInterval;
+        }
+      }
+
+      util::Mutex mutex;
+      util::DecayingHashSet< ShortHash > digests GUARDED_BY(mutex){Interval};
+      llarp_time_t nextDecay GUARDED_BY(mutex) = 0s;
+    };
+
+    constexpr std::chrono::milliseconds VerifiedCache::Interval;
+    constexpr std::chrono::milliseconds VerifiedCache::DecayInterval;
+
+    VerifiedCache &
+    Verified()
+    {
+      static VerifiedCache cache;
+      return cache;
+    }
+  }  // namespace
+
   NetID &
   NetID::DefaultValue()
   {
@@ -321,6 +376,19 @@ namespace llarp
 
   bool
   RouterContact::Verify(llarp_time_t now, bool allowExpired) const
+  {
+    if(!VerifyFields(now, allowExpired))
+      return false;
+    if(!VerifySignature())
+    {
+      llarp::LogError("invalid signature: ", *this);
+      return false;
+    }
+    return true;
+  }
+
+  bool
+  RouterContact::VerifyFields(llarp_time_t now, bool allowExpired) const
   {
     if(netID != NetID::DefaultValue())
     {
@@ -353,11 +421,6 @@ namespace llarp
         return false;
       }
     }
-    if(!VerifySignature())
-    {
-      llarp::LogError("invalid signature: ", *this);
-      return false;
-    }
     return true;
   }
 
@@ -367,16 +430,69 @@ namespace llarp
     RouterContact copy;
     copy = *this;
     copy.signature.Zero();
-    std::array< byte_t, MAX_RC_SIZE > tmp;
-    llarp_buffer_t buf(tmp);
+    // the signature goes after the signed bytes, the digest covers both
+    std::array< byte_t, MAX_RC_SIZE + Signature::SIZE > tmp;
+    llarp_buffer_t buf(tmp.data(), MAX_RC_SIZE);
     if(!copy.BEncode(&buf))
     {
       llarp::LogError("bencode failed");
       return false;
     }
-    buf.sz  = buf.cur - buf.base;
+    buf.sz = buf.cur - buf.base;
+    std::copy(signature.begin(), signature.end(), buf.cur);
     buf.cur = buf.base;
-    return CryptoManager::instance()->verify(pubkey, buf, signature);
+
+    auto crypto = CryptoManager::instance();
+    ShortHash digest;
+    const bool hashed = crypto->shorthash(
+        digest, llarp_buffer_t(buf.base, buf.sz + Signature::SIZE));
+    if(hashed && Verified().Contains(digest))
+      return true;
+    if(!crypto->verify(pubkey, buf, signature))
+      return false;
+    if(hashed)
+      Verified().Insert(digest);
+    return true;
+  }
+
+  std::vector< byte_t >
+  VerifyRCs(const std::vector< RouterContact > &rcs, llarp_time_t now,
+            thread::ThreadPool *workers)
+  {
+    std::vector< byte_t > valid(rcs.size(), 0);
+    const size_t batches = (rcs.size() + VerifyBatchSize - 1) / VerifyBatchSize;
+    if(workers == nullptr || batches < 2)
+    {
+      for(size_t idx = 0; idx < rcs.size(); ++idx)
+        valid[idx] = rcs[idx].Verify(now);
+      return valid;
+    }
+
+    // outlives us in the job that finishes last
+    struct Batches
+    {
+      std::atomic_size_t pending;
+      std::promise< void > done;
+    };
+    auto state     = std::make_shared< Batches >();
+    state->pending = batches;
+    auto done      = state->done.get_future();
+    const auto *in = rcs.data();
+    byte_t *out    = valid.data();
+    auto verify    = [state, in, out, now](size_t begin, size_t end) {
+      for(size_t idx = begin; idx < end; ++idx)
+        out[idx] = in[idx].Verify(now);
+      if(--state->pending == 0)
+        state->done.set_value();
+    };
+    for(size_t begin = 0; begin < rcs.size(); begin += VerifyBatchSize)
+    {
+      const size_t end = std::min(begin + VerifyBatchSize, rcs.size());
+      if(not workers->tryAddJob(std::bind(verify, begin, end)))
+        verify(begin, end);
+    }
+    done.wait();
+    return valid;
   }
 
   bool
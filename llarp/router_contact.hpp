@@ -19,6 +19,11 @@
 
 namespace llarp
 {
+  namespace thread
+  {
+    class ThreadPool;
+  }
+
   /// NetID
   struct NetID final : public AlignedBuffer< 8 >
   {
@@ -174,6 +179,10 @@ namespace llarp
     bool
     Verify(llarp_time_t now, bool allowExpired = true) const;
 
+    /// the cheap part of Verify(), everything but the signature
+    bool
+    VerifyFields(llarp_time_t now, bool allowExpired = true) const;
+
     bool
     Sign(const llarp::SecretKey &secret);
 
@@ -208,10 +217,19 @@ namespace llarp
     bool
     Write(const char *fname) const;
 
+    /// check our signature, remembering the digests of rcs that checked out
+    /// so seeing the exact same rc again skips the ed25519 verify
     bool
     VerifySignature() const;
   };
 
+  /// Verify() every rc in batches spread over workers and wait for all of
+  /// them. returns one flag per rc that is set if it is valid. runs inline
+  /// if there are no workers and on this thread too when they are backed up
+  std::vector< byte_t >
+  VerifyRCs(const std::vector< RouterContact > &rcs, llarp_time_t now,
+            thread::ThreadPool *workers);
+
   inline std::ostream &
   operator<<(std::ostream &out, const RouterContact &rc)
   {
@@ -27,6 +27,7 @@ namespace llarp
     struct UpdateExitMessage;
     struct UpdateExitVerifyMessage;
     struct CloseExitMessage;
+    struct PathCloseMessage;
     struct PathTransferMessage;
     struct PathConfirmMessage;
     struct PathLatencyMessage;
@@ -80,6 +81,11 @@ namespace llarp
       virtual bool
       HandlePathLatencyMessage(const PathLatencyMessage& msg,
                                AbstractRouter* r) = 0;
+
+      virtual bool
+      HandlePathCloseMessage(const PathCloseMessage& msg,
+                             AbstractRouter* r) = 0;
+
       virtual bool
       HandleDHTMessage(const dht::IMessage& msg, AbstractRouter* r) = 0;
     };
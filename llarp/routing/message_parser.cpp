@@ -4,6 +4,7 @@
 #include <messages/discard.hpp>
 #include <path/path_types.hpp>
 #include <routing/dht_message.hpp>
+#include <routing/path_close_message.hpp>
 #include <routing/path_confirm_message.hpp>
 #include <routing/path_latency_message.hpp>
 #include <routing/path_transfer_message.hpp>
@@ -28,6 +29,7 @@ namespace llarp
       ObtainExitMessage O;
       UpdateExitMessage U;
       CloseExitMessage C;
+      PathCloseMessage Q;
     };
 
     InboundMessageParser::InboundMessageParser()
@@ -97,6 +99,9 @@ namespace llarp
           case 'C':
             msg = &m_Holder->C;
             break;
+          case 'Q':
+            msg = &m_Holder->Q;
+            break;
           default:
             llarp::LogError("invalid routing message id: ", *strbuf.cur);
         }
@@ -0,0 +1,42 @@
+#include <routing/path_close_message.hpp>
+
+#include <routing/handler.hpp>
+#include <util/bencode.hpp>
+
+namespace llarp
+{
+  namespace routing
+  {
+    bool
+    PathCloseMessage::DecodeKey(const llarp_buffer_t& key, llarp_buffer_t* val)
+    {
+      bool read = false;
+      if(!BEncodeMaybeReadDictInt("S", S, read, key, val))
+        return false;
+      if(!BEncodeMaybeReadDictInt("V", version, read, key, val))
+        return false;
+      return read;
+    }
+
+    bool
+    PathCloseMessage::BEncode(llarp_buffer_t* buf) const
+    {
+      if(!bencode_start_dict(buf))
+        return false;
+      if(!BEncodeWriteDictMsgType(buf, "A", "Q"))
+        return false;
+      if(!BEncodeWriteDictInt("S", S, buf))
+        return false;
+      if(!BEncodeWriteDictInt("V", version, buf))
+        return false;
+      return bencode_end(buf);
+    }
+
+    bool
+    PathCloseMessage::HandleMessage(IMessageHandler* h, AbstractRouter* r) const
+    {
+      return h && h->HandlePathCloseMessage(*this, r);
+    }
+
+  }  // namespace routing
+}  // namespace llarp
@@ -0,0 +1,35 @@
+#ifndef LLARP_MESSAGES_PATH_CLOSE_HPP
+#define LLARP_MESSAGES_PATH_CLOSE_HPP
+
+#include <routing/message.hpp>
+
+namespace llarp
+{
+  namespace routing
+  {
+    /// sent by the owner of a path to its last hop to tear the path down
+    /// before it expires
+    struct PathCloseMessage final : public IMessage
+    {
+      PathCloseMessage() = default;
+      ~PathCloseMessage() override = default;
+
+      bool
+      BEncode(llarp_buffer_t* buf) const override;
+
+      bool
+      DecodeKey(const llarp_buffer_t& key, llarp_buffer_t* val) override;
+
+      bool
+      HandleMessage(IMessageHandler* h, AbstractRouter* r) const override;
+
+      void
+      Clear() override
+      {
+        version = 0;
+      }
+    };
+  }  // namespace routing
+}  // namespace llarp
+
+#endif
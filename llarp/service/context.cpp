@@ -88,6 +88,13 @@ namespace llarp
       }
     }
 
+    void
+    Context::FlushFrameDecrypts()
+    {
+      for(const auto &item : m_Endpoints)
+        item.second->FlushFrameDecrypts();
+    }
+
     bool
     Context::RemoveEndpoint(const std::string &name)
     {
@@ -21,6 +21,10 @@ namespace llarp
       void
       Tick(llarp_time_t now);
 
+      /// hand the frames every endpoint queued to the crypto workers
+      void
+      FlushFrameDecrypts();
+
       /// stop all held services
       bool
       StopAll();
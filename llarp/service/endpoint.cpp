@@ -24,6 +24,8 @@
 #include <hook/shell.hpp>
 #include <link/link_manager.hpp>
 
+#include <algorithm>
+#include <atomic>
 #include <utility>
 
 namespace llarp
@@ -41,6 +43,7 @@ namespace llarp
       m_state->m_Name   = name;
       m_state->m_Tag.Zero();
       m_RecvQueue.enable();
+      buildBudget = DefaultBuildBudget;
     }
 
     bool
@@ -398,6 +401,41 @@ namespace llarp
       }
     }
 
+    void
+    Endpoint::MarkMacFramesFor(const ConvoTag& tag)
+    {
+      auto itr = Sessions().find(tag);
+      if(itr != Sessions().end())
+      {
+        itr->second.macFrames = true;
+      }
+    }
+
+    bool
+    Endpoint::UsesMacFramesFor(const ConvoTag& tag) const
+    {
+      auto itr = Sessions().find(tag);
+      return itr != Sessions().end() && itr->second.macFrames;
+    }
+
+    void
+    Endpoint::SendCapabilitiesFor(const ConvoTag& tag, const Address& remote)
+    {
+      auto itr = Sessions().find(tag);
+      if(itr == Sessions().end() || itr->second.sentCapabilities)
+        return;
+      itr->second.sentCapabilities = true;
+      ProtocolCapabilities caps;
+      caps.flags = LocalCapabilities;
+      std::array< byte_t, 64 > tmp;
+      llarp_buffer_t buf(tmp);
+      if(!caps.BEncode(&buf))
+        return;
+      buf.sz  = buf.cur - buf.base;
+      buf.cur = buf.base;
+      SendToServiceOrQueue(remote, buf, eProtocolControl);
+    }
+
     bool
     Endpoint::LoadKeyFile()
     {
@@ -807,21 +845,111 @@ namespace llarp
       {
         auto maybe = m_RecvQueue.tryPopFront();
         if(not maybe.has_value())
-          return;
-        auto ev = std::move(maybe.value());
-        ProtocolMessage::ProcessAsync(ev.fromPath, ev.pathid, ev.msg);
+          break;
+        auto batch = std::move(maybe.value());
+        m_EarlyRecvBatches.emplace(batch.seqno, std::move(batch.events));
       } while(true);
+      // batches can finish out of order on the worker, hand them over in the
+      // order their frames came in
+      auto itr = m_EarlyRecvBatches.begin();
+      while(itr != m_EarlyRecvBatches.end() && itr->first == m_DeliverRecvBatch)
+      {
+        for(const auto& ev : itr->second)
+          ProtocolMessage::ProcessAsync(ev.fromPath, ev.pathid, ev.msg);
+        ++m_DeliverRecvBatch;
+        itr = m_EarlyRecvBatches.erase(itr);
+      }
     }
 
     void
-    Endpoint::QueueRecvData(RecvDataEvent ev)
+    Endpoint::QueueRecvData(RecvDataBatch batch)
     {
       if(m_RecvQueue.full() || m_RecvQueue.empty())
       {
         auto self = this;
         LogicCall(m_router->logic(), [self]() { self->FlushRecvData(); });
       }
-      m_RecvQueue.pushBack(std::move(ev));
+      m_RecvQueue.pushBack(std::move(batch));
+    }
+
+    bool
+    Endpoint::QueueFrameDecrypt(path::Path_ptr p, const ProtocolFrame& frame)
+    {
+      PendingFrame pending;
+      if(!m_DataHandler->GetCachedSessionKeyFor(frame.T, pending.sharedKey))
+      {
+        LogError("No cached session for T=", frame.T);
+        return false;
+      }
+      if(!m_DataHandler->GetSenderFor(frame.T, pending.sender))
+      {
+        LogError("No sender for T=", frame.T);
+        return false;
+      }
+      pending.fromPath = std::move(p);
+      pending.frame    = frame;
+      m_PendingFrames.emplace_back(std::move(pending));
+      return true;
+    }
+
+    void
+    Endpoint::FlushFrameDecrypts()
+    {
+      struct Batch
+      {
+        std::vector< PendingFrame > frames;
+        std::vector< std::shared_ptr< ProtocolMessage > > msgs;
+        uint64_t seqno;
+        std::atomic< size_t > running;
+      };
+      if(m_PendingFrames.empty())
+        return;
+      auto batch    = std::make_shared< Batch >();
+      batch->frames = std::move(m_PendingFrames);
+      m_PendingFrames.clear();
+      batch->msgs.resize(batch->frames.size());
+      batch->seqno = m_NextRecvBatch++;
+      // one job per worker thread, each doing a contiguous run of frames
+      auto worker            = CryptoWorker();
+      const size_t numFrames = batch->frames.size();
+      const size_t chunks =
+          std::max(size_t{1}, std::min(worker->threadCount(), numFrames));
+      const size_t chunkSize = (numFrames + chunks - 1) / chunks;
+      batch->running         = (numFrames + chunkSize - 1) / chunkSize;
+      IDataHandler* handler  = m_DataHandler;
+      for(size_t begin = 0; begin < numFrames; begin += chunkSize)
+      {
+        const size_t end = std::min(begin + chunkSize, numFrames);
+        auto job         = [batch, handler, begin, end]() {
+          for(size_t idx = begin; idx < end; ++idx)
+          {
+            const auto& pending = batch->frames[idx];
+            auto msg            = std::make_shared< ProtocolMessage >();
+            msg->handler        = handler;
+            if(pending.frame.VerifyAndDecrypt(pending.sender, pending.sharedKey,
+                                              *msg))
+              batch->msgs[idx] = std::move(msg);
+          }
+          if(--batch->running > 0)
+            return;
+          // the whole batch goes back in one handover
+          RecvDataBatch recv;
+          recv.seqno = batch->seqno;
+          for(size_t idx = 0; idx < batch->frames.size(); ++idx)
+          {
+            if(batch->msgs[idx] == nullptr)
+              continue;
+            auto& pending = batch->frames[idx];
+            recv.events.emplace_back(RecvDataEvent{std::move(pending.fromPath),
+                                                   pending.frame.F,
+                                                   std::move(batch->msgs[idx])});
+          }
+          handler->QueueRecvData(std::move(recv));
+        };
+        // a batch that never finishes would hold back every later one
+        if(not worker->addJob(job))
+          job();
+      }
     }
 
     bool
@@ -836,6 +964,7 @@ namespace llarp
       intro.router    = PubKey(path->Endpoint());
       intro.expiresAt = std::min(path->ExpireTime(), msg->introReply.expiresAt);
       PutIntroFor(msg->tag, intro);
+      SendCapabilitiesFor(msg->tag, msg->sender.Addr());
       return ProcessDataMessage(msg);
     }
 
@@ -866,8 +995,11 @@ namespace llarp
       }
       if(msg->proto == eProtocolControl)
       {
-        // TODO: implement me (?)
-        // right now it's just random noise
+        // capabilities are all we send here so far
+        ProtocolCapabilities caps;
+        llarp_buffer_t buf(msg->payload);
+        if(caps.BDecode(&buf) && (caps.flags & eCapMacFrames))
+          MarkMacFramesFor(msg->tag);
         return true;
       }
       return false;
@@ -897,8 +1029,11 @@ namespace llarp
         RemoveConvoTag(frame.T);
         return true;
       }
-      if(!frame.AsyncDecryptAndVerify(EndpointLogic(), p, CryptoWorker(),
-                                      m_Identity, m_DataHandler))
+      const bool queued = frame.T.IsZero()
+          ? frame.AsyncDecryptAndVerify(EndpointLogic(), p, CryptoWorker(),
+                                        m_Identity, m_DataHandler)
+          : QueueFrameDecrypt(p, frame);
+      if(!queued)
       {
         // send discard
         ProtocolFrame f;
@@ -1098,6 +1233,7 @@ namespace llarp
       const auto& sessions = m_state->m_SNodeSessions;
       auto& queue          = m_state->m_InboundTrafficQueue;
 
+      FlushFrameDecrypts();
       auto epPump = [&]() {
         FlushRecvData();
         // send downstream packets to user for snode
@@ -1221,9 +1357,14 @@ namespace llarp
             f.S         = 1;
             f.F         = m->introReply.pathID;
             transfer->P = remoteIntro.pathID;
-            auto self   = this;
-            return CryptoWorker()->addJob([transfer, p, m, K, self]() {
-              if(not transfer->T.EncryptAndSign(*m, K, self->m_Identity))
+
+            const bool mac = UsesMacFramesFor(f.T);
+            auto self      = this;
+            return CryptoWorker()->addJob([transfer, p, m, K, mac, self]() {
+              const bool encrypted = mac
+                  ? transfer->T.EncryptAndMac(*m, K)
+                  : transfer->T.EncryptAndSign(*m, K, self->m_Identity);
+              if(not encrypted)
               {
                 LogError("failed to encrypt and sign");
                 return;
@@ -20,6 +20,9 @@
 #include <util/compare_ptr.hpp>
 #include <util/thread/logic.hpp>
 
+#include <map>
+#include <vector>
+
 // minimum time between introset shifts
 #ifndef MIN_SHIFT_INTERVAL
 #define MIN_SHIFT_INTERVAL 5s
@@ -70,6 +73,8 @@ namespace llarp
                       public IDataHandler
     {
       static const size_t MAX_OUTBOUND_CONTEXT_COUNT = 4;
+      /// paths built at once while we have none, see Builder::buildBudget
+      static const size_t DefaultBuildBudget = 4;
 
       Endpoint(const std::string& nickname, AbstractRouter* r, Context* parent);
       ~Endpoint() override;
@@ -79,7 +84,7 @@ namespace llarp
       IsReady() const;
 
       void
-      QueueRecvData(RecvDataEvent ev) override;
+      QueueRecvData(RecvDataBatch batch) override;
 
       /// return true if our introset has expired intros
       bool
@@ -225,6 +230,12 @@ namespace llarp
       virtual void
       Pump(llarp_time_t now);
 
+      /// verify and decrypt the frames queued since the last flush on the
+      /// crypto worker. the router does this every pump for every endpoint,
+      /// so frames come through on endpoints that have no pump of their own
+      void
+      FlushFrameDecrypts();
+
       /// stop this endpoint
       bool
       Stop() override;
@@ -333,6 +344,16 @@ namespace llarp
       void
       MarkConvoTagActive(const ConvoTag& remote) override;
 
+      void
+      MarkMacFramesFor(const ConvoTag& remote) override;
+
+      bool
+      UsesMacFramesFor(const ConvoTag& remote) const override;
+
+      /// tell the remote of a convo our capabilities, once
+      void
+      SendCapabilitiesFor(const ConvoTag& tag, const Address& remote);
+
       void
       PutReplyIntroFor(const ConvoTag& remote,
                        const Introduction& intro) override;
@@ -446,6 +467,11 @@ namespace llarp
       void
       FlushRecvData();
 
+      /// queue a frame of an established convo for the next batch, false if
+      /// we do not know the convo
+      bool
+      QueueFrameDecrypt(path::Path_ptr p, const ProtocolFrame& frame);
+
       friend struct EndpointUtil;
 
       // clang-format off
@@ -457,8 +483,24 @@ namespace llarp
       ConvoMap&       Sessions();
       // clang-format on
 
+      /// a frame of an established convo waiting for the crypto worker
+      struct PendingFrame
+      {
+        path::Path_ptr fromPath;
+        ServiceInfo sender;
+        SharedSecret sharedKey;
+        ProtocolFrame frame;
+      };
+
       std::unique_ptr< EndpointState > m_state;
-      thread::Queue< RecvDataEvent > m_RecvQueue;
+      std::vector< PendingFrame > m_PendingFrames;
+      /// seqno of the next batch of frames that goes to the crypto worker
+      uint64_t m_NextRecvBatch = 0;
+      /// seqno of the next batch we hand over
+      uint64_t m_DeliverRecvBatch = 0;
+      /// batches that finished before an earlier one
+      std::map< uint64_t, std::vector< RecvDataEvent > > m_EarlyRecvBatches;
+      thread::Queue< RecvDataBatch > m_RecvQueue;
     };
 
     using Endpoint_ptr = std::shared_ptr< Endpoint >;
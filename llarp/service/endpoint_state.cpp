@@ -53,6 +53,19 @@ namespace llarp
           LogWarn(name, " invalid number of paths: ", v);
         }
       }
+      if(k == "build-budget")
+      {
+        const auto val = atoi(v.c_str());
+        if(val >= 1 && val <= static_cast< int >(path::PathSet::max_paths))
+        {
+          ep.buildBudget = val;
+          LogInfo(name, " set path build budget to ", ep.buildBudget);
+        }
+        else
+        {
+          LogWarn(name, " invalid path build budget: ", v);
+        }
+      }
       if(k == "hops")
       {
         const auto val = atoi(v.c_str());
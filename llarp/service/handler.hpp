@@ -8,6 +8,7 @@
 
 #include <memory>
 #include <set>
+#include <vector>
 
 namespace llarp
 {
@@ -23,6 +24,14 @@ namespace llarp
       std::shared_ptr< ProtocolMessage > msg;
     };
 
+    /// the messages of a batch of frames in the order the frames came in
+    struct RecvDataBatch
+    {
+      /// batches are handed over in the order of seqno
+      uint64_t seqno = 0;
+      std::vector< RecvDataEvent > events;
+    };
+
     struct ProtocolMessage;
     struct IDataHandler
     {
@@ -46,6 +55,14 @@ namespace llarp
       virtual bool
       HasConvoTag(const ConvoTag& remote) const = 0;
 
+      /// remote understands frames authenticated with the session key
+      virtual void
+      MarkMacFramesFor(const ConvoTag& remote) = 0;
+
+      /// can we send frames authenticated with the session key to remote
+      virtual bool
+      UsesMacFramesFor(const ConvoTag& remote) const = 0;
+
       virtual void
       PutSenderFor(const ConvoTag& remote, const ServiceInfo& si,
                    bool inbound) = 0;
@@ -80,7 +97,7 @@ namespace llarp
       MarkAddressOutbound(const Address& addr) = 0;
 
       virtual void
-      QueueRecvData(RecvDataEvent ev) = 0;
+      QueueRecvData(RecvDataBatch batch) = 0;
     };
   }  // namespace service
 }  // namespace llarp
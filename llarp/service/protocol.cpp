@@ -8,6 +8,8 @@
 
 #include <utility>
 
+#include <sodium/utils.h>
+
 namespace llarp
 {
   namespace service
@@ -92,6 +94,36 @@ namespace llarp
       return bencode_end(buf);
     }
 
+    bool
+    ProtocolCapabilities::BEncode(llarp_buffer_t* buf) const
+    {
+      if(!bencode_start_dict(buf))
+        return false;
+      if(!BEncodeWriteDictMsgType(buf, "A", "C"))
+        return false;
+      if(!BEncodeWriteDictInt("c", flags, buf))
+        return false;
+      return bencode_end(buf);
+    }
+
+    bool
+    ProtocolCapabilities::DecodeKey(const llarp_buffer_t& key,
+                                    llarp_buffer_t* buf)
+    {
+      bool read = false;
+      if(key == "A")
+      {
+        llarp_buffer_t strbuf;
+        if(!bencode_read_string(buf, &strbuf))
+          return false;
+        return strbuf.sz == 1 && *strbuf.cur == 'C';
+      }
+      if(!BEncodeMaybeReadDictInt("c", flags, read, key, buf))
+        return false;
+      // skip bits of later capabilities
+      return read || bencode_discard(buf);
+    }
+
     ProtocolFrame::~ProtocolFrame() = default;
 
     bool
@@ -114,6 +146,11 @@ namespace llarp
       }
       if(!BEncodeWriteDictEntry("F", F, buf))
         return false;
+      if(!M.IsZero())
+      {
+        if(!BEncodeWriteDictEntry("M", M, buf))
+          return false;
+      }
       if(!N.IsZero())
       {
         if(!BEncodeWriteDictEntry("N", N, buf))
@@ -155,6 +192,8 @@ namespace llarp
         return false;
       if(!BEncodeMaybeReadDictEntry("C", C, read, key, val))
         return false;
+      if(!BEncodeMaybeReadDictEntry("M", M, read, key, val))
+        return false;
       if(!BEncodeMaybeReadDictEntry("N", N, read, key, val))
         return false;
       if(!BEncodeMaybeReadDictInt("S", S, read, key, val))
@@ -201,9 +240,8 @@ namespace llarp
     }
 
     bool
-    ProtocolFrame::EncryptAndSign(const ProtocolMessage& msg,
-                                  const SharedSecret& sessionKey,
-                                  const Identity& localIdent)
+    ProtocolFrame::EncryptPayload(const ProtocolMessage& msg,
+                                  const SharedSecret& sessionKey)
     {
       std::array< byte_t, MAX_PROTOCOL_MESSAGE_SIZE > tmp;
       llarp_buffer_t buf(tmp);
@@ -220,26 +258,65 @@ namespace llarp
       CryptoManager::instance()->xchacha20(buf, sessionKey, N);
       // put encrypted buffer
       D = buf;
-      // zero out signature
+      return true;
+    }
+
+    bool
+    ProtocolFrame::EncryptAndSign(const ProtocolMessage& msg,
+                                  const SharedSecret& sessionKey,
+                                  const Identity& localIdent)
+    {
+      if(!EncryptPayload(msg, sessionKey))
+        return false;
+      M.Zero();
+      return Sign(localIdent);
+    }
+
+    bool
+    ProtocolFrame::EncryptAndMac(const ProtocolMessage& msg,
+                                 const SharedSecret& sessionKey)
+    {
+      if(!EncryptPayload(msg, sessionKey))
+        return false;
       Z.Zero();
-      llarp_buffer_t buf2(tmp);
-      // encode frame
-      if(!BEncode(&buf2))
+      return ComputeMac(sessionKey, M);
+    }
+
+    bool
+    ProtocolFrame::ComputeMac(const SharedSecret& sessionKey,
+                              ShortHash& mac) const
+    {
+      auto crypto = CryptoManager::instance();
+      // keep the mac key apart from the key D is encrypted with
+      static constexpr char macKeyInfo[] = "lokinet-protocol-frame-mac";
+      SharedSecret macKey;
+      if(!crypto->hmac(macKey.data(),
+                       llarp_buffer_t(macKeyInfo, sizeof(macKeyInfo)),
+                       sessionKey))
+        return false;
+      ProtocolFrame copy(*this);
+      copy.M.Zero();
+      copy.Z.Zero();
+      std::array< byte_t, MAX_PROTOCOL_MESSAGE_SIZE > tmp;
+      llarp_buffer_t buf(tmp);
+      if(!copy.BEncode(&buf))
       {
         LogError("frame too big to encode");
-        DumpBuffer(buf2);
         return false;
       }
       // rewind
-      buf2.sz  = buf2.cur - buf2.base;
-      buf2.cur = buf2.base;
-      // sign
-      if(!localIdent.Sign(Z, buf2))
-      {
-        LogError("failed to sign? wtf?!");
-        return false;
-      }
-      return true;
+      buf.sz  = buf.cur - buf.base;
+      buf.cur = buf.base;
+      return crypto->hmac(mac.data(), buf, macKey);
+    }
+
+    bool
+    ProtocolFrame::VerifyMac(const SharedSecret& sessionKey) const
+    {
+      ShortHash mac;
+      // constant time so the mac can not be guessed byte by byte
+      return !M.IsZero() && ComputeMac(sessionKey, mac)
+          && sodium_memcmp(mac.data(), M.data(), mac.size()) == 0;
     }
 
     struct AsyncFrameDecrypt
@@ -358,81 +435,60 @@ namespace llarp
       N       = other.N;
       Z       = other.Z;
       T       = other.T;
+      M       = other.M;
       R       = other.R;
       S       = other.S;
       version = other.version;
       return *this;
     }
 
-    struct AsyncDecrypt
-    {
-      ServiceInfo si;
-      SharedSecret shared;
-      ProtocolFrame frame;
-    };
-
     bool
     ProtocolFrame::AsyncDecryptAndVerify(
         std::shared_ptr< Logic > logic, path::Path_ptr recvPath,
         const std::shared_ptr< llarp::thread::ThreadPool >& worker,
         const Identity& localIdent, IDataHandler* handler) const
     {
-      auto msg     = std::make_shared< ProtocolMessage >();
-      msg->handler = handler;
-      if(T.IsZero())
+      if(not T.IsZero())
       {
-        LogInfo("Got protocol frame with new convo");
-        // we need to dh
-        auto dh  = new AsyncFrameDecrypt(logic, localIdent, handler, msg, *this,
-                                        recvPath->intro);
-        dh->path = recvPath;
-        return worker->addJob(std::bind(&AsyncFrameDecrypt::Work, dh));
+        LogError("frame of established convo T=", T, " outside of a batch");
+        return false;
       }
+      LogInfo("Got protocol frame with new convo");
+      auto msg     = std::make_shared< ProtocolMessage >();
+      msg->handler = handler;
+      // we need to dh
+      auto dh  = new AsyncFrameDecrypt(logic, localIdent, handler, msg, *this,
+                                      recvPath->intro);
+      dh->path = recvPath;
+      return worker->addJob(std::bind(&AsyncFrameDecrypt::Work, dh));
+    }
 
-      auto v = new AsyncDecrypt();
-
-      if(!handler->GetCachedSessionKeyFor(T, v->shared))
+    bool
+    ProtocolFrame::VerifyAndDecrypt(const ServiceInfo& sender,
+                                    const SharedSecret& sharedKey,
+                                    ProtocolMessage& msg) const
+    {
+      // established sessions may authenticate with the session key
+      const bool valid = M.IsZero() ? Verify(sender) : VerifyMac(sharedKey);
+      if(not valid)
       {
-        LogError("No cached session for T=", T);
-        delete v;
+        LogError("Signature failure from ", sender.Addr());
         return false;
       }
-
-      if(!handler->GetSenderFor(T, v->si))
+      if(not DecryptPayloadInto(sharedKey, msg))
       {
-        LogError("No sender for T=", T);
-        delete v;
+        LogError("failed to decrypt message");
         return false;
       }
-      v->frame = *this;
-      return worker->addJob(
-          [v, msg = std::move(msg), recvPath = std::move(recvPath)]() {
-            if(not v->frame.Verify(v->si))
-            {
-              LogError("Signature failure from ", v->si.Addr());
-              delete v;
-              return;
-            }
-            if(not v->frame.DecryptPayloadInto(v->shared, *msg))
-            {
-              LogError("failed to decrypt message");
-              delete v;
-              return;
-            }
-            RecvDataEvent ev;
-            ev.fromPath = std::move(recvPath);
-            ev.pathid   = v->frame.F;
-            ev.msg      = std::move(msg);
-            msg->handler->QueueRecvData(std::move(ev));
-            delete v;
-          });
+      return true;
     }
 
     bool
     ProtocolFrame::operator==(const ProtocolFrame& other) const
     {
       return C == other.C && D == other.D && N == other.N && Z == other.Z
-          && T == other.T && S == other.S && version == other.version;
+          && T == other.T && M == other.M && S == other.S
+          && version == other.version;
     }
 
     bool
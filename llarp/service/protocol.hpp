@@ -37,6 +37,30 @@ namespace llarp
     constexpr ProtocolType eProtocolTrafficV4 = 1UL;
     constexpr ProtocolType eProtocolTrafficV6 = 2UL;
 
+    /// takes frames authenticated with the session key instead of signed
+    constexpr uint64_t eCapMacFrames = 1UL << 0;
+    /// every capability bit this endpoint has
+    constexpr uint64_t LocalCapabilities = eCapMacFrames;
+
+    /// body of an eProtocolControl message telling the remote what we take
+    /// beyond the baseline protocol, older endpoints ignore control messages
+    struct ProtocolCapabilities
+    {
+      uint64_t flags = 0;
+
+      bool
+      BEncode(llarp_buffer_t* buf) const;
+
+      bool
+      BDecode(llarp_buffer_t* buf)
+      {
+        return bencode_decode_dict(*this, buf);
+      }
+
+      bool
+      DecodeKey(const llarp_buffer_t& key, llarp_buffer_t* buf);
+    };
+
     /// inner message
     struct ProtocolMessage
     {
@@ -84,6 +108,9 @@ namespace llarp
       Signature Z;
       PathID_t F;
       service::ConvoTag T;
+      /// keyed hash from the session key, takes the place of Z on established
+      /// sessions
+      ShortHash M;
 
       ProtocolFrame(const ProtocolFrame& other)
           : routing::IMessage()
@@ -94,6 +121,7 @@ namespace llarp
           , Z(other.Z)
           , F(other.F)
           , T(other.T)
+          , M(other.M)
       {
         S       = other.S;
         version = other.version;
@@ -122,9 +150,20 @@ namespace llarp
       EncryptAndSign(const ProtocolMessage& msg, const SharedSecret& sharedkey,
                      const Identity& localIdent);
 
+      /// like EncryptAndSign but authenticates with M instead of signing,
+      /// for sessions whose remote told us it has eCapMacFrames
+      bool
+      EncryptAndMac(const ProtocolMessage& msg, const SharedSecret& sharedkey);
+
       bool
       Sign(const Identity& localIdent);
 
+      /// check M against the session key
+      bool
+      VerifyMac(const SharedSecret& sharedkey) const;
+
+      /// key exchange and decrypt the frame that opens a new convo, frames of
+      /// established convos are verified in batches by the endpoint
       bool
       AsyncDecryptAndVerify(
           std::shared_ptr< Logic > logic, path::Path_ptr fromPath,
@@ -135,6 +174,12 @@ namespace llarp
       DecryptPayloadInto(const SharedSecret& sharedkey,
                          ProtocolMessage& into) const;
 
+      /// check a frame of an established convo came from sender and decrypt
+      /// it into msg
+      bool
+      VerifyAndDecrypt(const ServiceInfo& sender, const SharedSecret& sharedkey,
+                       ProtocolMessage& msg) const;
+
       bool
       DecodeKey(const llarp_buffer_t& key, llarp_buffer_t* val) override;
 
@@ -156,6 +201,7 @@ namespace llarp
         T.Zero();
         N.Zero();
         Z.Zero();
+        M.Zero();
         R       = 0;
         version = LLARP_PROTO_VERSION;
       }
@@ -166,6 +212,15 @@ namespace llarp
       bool
       HandleMessage(routing::IMessageHandler* h,
                     AbstractRouter* r) const override;
+
+     private:
+      /// encrypt msg into D
+      bool
+      EncryptPayload(const ProtocolMessage& msg, const SharedSecret& sharedkey);
+
+      /// keyed hash over this frame without M and Z
+      bool
+      ComputeMac(const SharedSecret& sharedkey, ShortHash& mac) const;
     };
   }  // namespace service
 }  // namespace llarp
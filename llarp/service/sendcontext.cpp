@@ -102,9 +102,13 @@ namespace llarp
       m->sender     = m_Endpoint->GetIdentity().pub;
       m->tag        = f->T;
       m->PutBuffer(payload);
-      auto self = this;
-      m_Endpoint->CryptoWorker()->addJob([f, m, shared, path, self]() {
-        if(not f->EncryptAndSign(*m, shared, self->m_Endpoint->GetIdentity()))
+      const bool mac = m_DataHandler->UsesMacFramesFor(f->T);
+      auto self      = this;
+      m_Endpoint->CryptoWorker()->addJob([f, m, shared, path, mac, self]() {
+        const bool encrypted = mac
+            ? f->EncryptAndMac(*m, shared)
+            : f->EncryptAndSign(*m, shared, self->m_Endpoint->GetIdentity());
+        if(not encrypted)
         {
           LogError(self->m_Endpoint->Name(), " failed to sign message");
           return;
@@ -27,6 +27,11 @@ namespace llarp
       llarp_time_t lastUsed = 0s;
       uint64_t seqno        = 0;
       bool inbound          = false;
+      /// remote told us it takes frames that are authenticated with
+      /// sharedKey instead of signed
+      bool macFrames = false;
+      /// we told the remote our capabilities on this convo
+      bool sentCapabilities = false;
 
       util::StatusObject
       ExtractStatus() const;
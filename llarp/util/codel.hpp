@@ -10,6 +10,7 @@
 #include <array>
 #include <cmath>
 #include <functional>
+#include <new>
 #include <string>
 #include <utility>
 
@@ -56,10 +57,11 @@ namespace llarp
         if(m_QueueIdx == MaxSize)
           return false;
         T* t = &m_Queue[m_QueueIdx];
+        t->~T();
         new(t) T(std::forward< Args >(args)...);
         if(!pred(*t))
         {
-          t->~T();
+          Reset(t);
           return false;
         }
 
@@ -79,6 +81,7 @@ namespace llarp
         if(m_QueueIdx == MaxSize)
           return;
         T* t = &m_Queue[m_QueueIdx];
+        t->~T();
         new(t) T(std::forward< Args >(args)...);
         _putTime(m_Queue[m_QueueIdx]);
         if(firstPut == 0s)
@@ -107,8 +110,7 @@ namespace llarp
         if(m_QueueIdx == 1)
         {
           visitor(m_Queue[0]);
-          T* t = &m_Queue[0];
-          t->~T();
+          Reset(&m_Queue[0]);
           m_QueueIdx = 0;
           firstPut   = 0s;
           return;
@@ -130,7 +132,7 @@ namespace llarp
             // lowest, " dropMs: ", dropMs);
             if(lowest > dropMs)
             {
-              item->~T();
+              Reset(item);
               nextTickInterval +=
                   initialIntervalMs / uint64_t(std::sqrt(++dropNum));
               firstPut   = 0s;
@@ -142,12 +144,21 @@ namespace llarp
             dropNum          = 0;
           }
           visitor(*item);
-          item->~T();
+          Reset(item);
         }
         firstPut   = 0s;
         nextTickAt = start + nextTickInterval;
       }
 
+      /// every slot holds a live T, an item that leaves the queue is replaced
+      /// by a default constructed one so it lets go of what it owns
+      static void
+      Reset(T* t)
+      {
+        t->~T();
+        new(t) T;
+      }
+
       const llarp_time_t initialIntervalMs = 5ms;
       const llarp_time_t dropMs            = 100ms;
       llarp_time_t firstPut                = 0s;
@@ -0,0 +1,76 @@
+#include <util/mapped_file.hpp>
+
+#ifdef _WIN32
+#include <fstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace llarp
+{
+  namespace util
+  {
+    bool
+    MappedFile::Open(const fs::path& fpath)
+    {
+      Close();
+#ifdef _WIN32
+      std::ifstream f(fpath.string(), std::ios::binary | std::ios::ate);
+      if(not f.is_open())
+        return false;
+      m_Copy.resize(f.tellg());
+      f.seekg(0, std::ios::beg);
+      if(not f.read(reinterpret_cast< char* >(m_Copy.data()), m_Copy.size()))
+      {
+        m_Copy.clear();
+        return false;
+      }
+      m_Data = m_Copy.data();
+      m_Size = m_Copy.size();
+      return true;
+#else
+      const int fd = ::open(fpath.string().c_str(), O_RDONLY | O_CLOEXEC);
+      if(fd == -1)
+        return false;
+      struct stat st;
+      if(::fstat(fd, &st) == -1)
+      {
+        ::close(fd);
+        return false;
+      }
+      // mmap refuses empty mappings, an empty file is just empty
+      if(st.st_size > 0)
+      {
+        void* ptr = ::mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        if(ptr == MAP_FAILED)
+        {
+          ::close(fd);
+          return false;
+        }
+        m_Data = static_cast< const byte_t* >(ptr);
+        m_Size = st.st_size;
+      }
+      // the mapping keeps the file alive on its own
+      ::close(fd);
+      return true;
+#endif
+    }
+
+    void
+    MappedFile::Close()
+    {
+#ifdef _WIN32
+      m_Copy.clear();
+      m_Copy.shrink_to_fit();
+#else
+      if(m_Data)
+        ::munmap(const_cast< byte_t* >(m_Data), m_Size);
+#endif
+      m_Data = nullptr;
+      m_Size = 0;
+    }
+  }  // namespace util
+}  // namespace llarp
@@ -0,0 +1,59 @@
+#ifndef LLARP_UTIL_MAPPED_FILE_HPP
+#define LLARP_UTIL_MAPPED_FILE_HPP
+
+#include <util/fs.hpp>
+#include <util/types.hpp>
+
+#include <vector>
+
+namespace llarp
+{
+  namespace util
+  {
+    /// read only view of a whole file
+    ///
+    /// the file is mapped into memory where the platform lets us, so pages
+    /// are only read from disk when touched. elsewhere it is read in one go.
+    class MappedFile
+    {
+     public:
+      MappedFile() = default;
+      MappedFile(const MappedFile&) = delete;
+      MappedFile&
+      operator=(const MappedFile&) = delete;
+
+      ~MappedFile()
+      {
+        Close();
+      }
+
+      /// map fpath, dropping any earlier mapping first
+      bool
+      Open(const fs::path& fpath);
+
+      void
+      Close();
+
+      const byte_t*
+      data() const
+      {
+        return m_Data;
+      }
+
+      size_t
+      size() const
+      {
+        return m_Size;
+      }
+
+     private:
+      const byte_t* m_Data = nullptr;
+      size_t m_Size        = 0;
+#ifdef _WIN32
+      std::vector< byte_t > m_Copy;
+#endif
+    };
+  }  // namespace util
+}  // namespace llarp
+
+#endif
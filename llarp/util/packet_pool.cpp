@@ -0,0 +1,353 @@
+#include <util/packet_pool.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace llarp
+{
+  namespace util
+  {
+    namespace
+    {
+      constexpr std::array< size_t, PacketPool::NumClasses > ClassSizes = {
+          {256, 512, 1024, 1536, 4096}};
+
+      /// size class marker for allocations we do not pool
+      constexpr uint32_t Oversize = ~uint32_t{0};
+
+      /// prepended to every block so Free knows where it goes
+      struct alignas(16) Header
+      {
+        uint32_t cls;
+        uint32_t capacity;
+      };
+
+      char*
+      ToData(Header* hdr)
+      {
+        return reinterpret_cast< char* >(hdr) + sizeof(Header);
+      }
+
+      Header*
+      ToHeader(const char* ptr)
+      {
+        return reinterpret_cast< Header* >(const_cast< char* >(ptr)
+                                           - sizeof(Header));
+      }
+
+      Header*
+      NewBlock(uint32_t cls, uint32_t capacity)
+      {
+        auto* hdr     = reinterpret_cast< Header* >(
+            new char[sizeof(Header) + capacity]);
+        hdr->cls      = cls;
+        hdr->capacity = capacity;
+        return hdr;
+      }
+
+      void
+      DeleteBlock(Header* hdr)
+      {
+        delete[] reinterpret_cast< char* >(hdr);
+      }
+
+      /// stats counted by one thread. only that thread writes them so a
+      /// bump is a plain load and store on a line no other thread writes,
+      /// they are atomic only so GetStats can read them from anywhere
+      struct Counters
+      {
+        std::atomic< uint64_t > hits{0};
+        std::atomic< uint64_t > misses{0};
+        std::atomic< uint64_t > oversize{0};
+        /// negative on threads that free more than they allocate
+        std::atomic< int64_t > outstanding{0};
+      };
+
+      /// the counters of every live thread
+      struct CounterRegistry
+      {
+        std::mutex access;
+        std::vector< const Counters* > live;
+        /// what exited threads counted, and what exiting threads count once
+        /// their cache is gone. written by many threads so only ever added to
+        Counters retired;
+      };
+
+      CounterRegistry&
+      GetRegistry()
+      {
+        // never destroyed so exiting threads can still count into it
+        static CounterRegistry* registry = new CounterRegistry();
+        return *registry;
+      }
+
+      using FreeList_t = std::vector< Header* >;
+
+      /// blocks shared between threads
+      struct Depot
+      {
+        std::mutex access;
+        std::array< FreeList_t, PacketPool::NumClasses > free;
+        std::atomic< uint64_t > count{0};
+
+        /// move up to TransferBatch blocks into list, returns true if any
+        bool
+        Take(size_t cls, FreeList_t& list)
+        {
+          std::lock_guard< std::mutex > lock(access);
+          auto& src = free[cls];
+          const size_t num =
+              std::min(src.size(), size_t{PacketPool::TransferBatch});
+          if(num == 0)
+            return false;
+          list.insert(list.end(), src.end() - num, src.end());
+          src.resize(src.size() - num);
+          count -= num;
+          return true;
+        }
+
+        /// move the last num blocks of list in, freeing what does not fit
+        void
+        Put(size_t cls, FreeList_t& list, size_t num)
+        {
+          {
+            std::lock_guard< std::mutex > lock(access);
+            auto& dst         = free[cls];
+            const size_t room = PacketPool::DepotSize - std::min(
+                                    dst.size(), size_t{PacketPool::DepotSize});
+            const size_t keep = std::min(room, num);
+            dst.insert(dst.end(), list.end() - keep, list.end());
+            list.resize(list.size() - keep);
+            count += keep;
+            num -= keep;
+          }
+          while(num--)
+          {
+            DeleteBlock(list.back());
+            list.pop_back();
+          }
+        }
+
+        /// take one block, nullptr if there is none
+        Header*
+        TakeOne(size_t cls)
+        {
+          std::lock_guard< std::mutex > lock(access);
+          auto& src = free[cls];
+          if(src.empty())
+            return nullptr;
+          Header* hdr = src.back();
+          src.pop_back();
+          count--;
+          return hdr;
+        }
+
+        /// keep one block, freeing it if we are full
+        void
+        PutOne(Header* hdr)
+        {
+          {
+            std::lock_guard< std::mutex > lock(access);
+            auto& dst = free[hdr->cls];
+            if(dst.size() < PacketPool::DepotSize)
+            {
+              dst.push_back(hdr);
+              count++;
+              return;
+            }
+          }
+          DeleteBlock(hdr);
+        }
+      };
+
+      Depot&
+      GetDepot()
+      {
+        // never destroyed so thread caches can still flush into it at exit
+        static Depot* depot = new Depot();
+        return *depot;
+      }
+
+      /// set once this thread's cache is destroyed. a plain thread_local
+      /// bool has no destructor so it can still be read after the cache is
+      /// gone, by frees from the destructors of other thread_locals
+      thread_local bool t_CacheGone = false;
+
+      /// per thread free lists and stats
+      struct ThreadCache
+      {
+        std::array< FreeList_t, PacketPool::NumClasses > free;
+        Counters counters;
+
+        ThreadCache()
+        {
+          for(auto& list : free)
+            list.reserve(PacketPool::ThreadCacheSize);
+          auto& registry = GetRegistry();
+          std::lock_guard< std::mutex > lock(registry.access);
+          registry.live.push_back(&counters);
+        }
+
+        ~ThreadCache()
+        {
+          t_CacheGone = true;
+          for(size_t cls = 0; cls < free.size(); ++cls)
+            GetDepot().Put(cls, free[cls], free[cls].size());
+          auto& registry = GetRegistry();
+          std::lock_guard< std::mutex > lock(registry.access);
+          registry.retired.hits += counters.hits.load();
+          registry.retired.misses += counters.misses.load();
+          registry.retired.oversize += counters.oversize.load();
+          registry.retired.outstanding += counters.outstanding.load();
+          auto& live = registry.live;
+          live.erase(std::find(live.begin(), live.end(), &counters));
+        }
+      };
+
+      /// this thread's cache, nullptr once it is destroyed at thread exit
+      ThreadCache*
+      GetCache()
+      {
+        if(t_CacheGone)
+          return nullptr;
+        static thread_local ThreadCache cache;
+        return &cache;
+      }
+
+      /// add delta to one of this thread's counters, or to the retired ones
+      /// once its cache is gone
+      template < typename T >
+      void
+      Count(ThreadCache* cache, std::atomic< T > Counters::*counter, T delta)
+      {
+        if(cache == nullptr)
+        {
+          GetRegistry().retired.*counter += delta;
+          return;
+        }
+        auto& own = cache->counters.*counter;
+        own.store(own.load(std::memory_order_relaxed) + delta,
+                  std::memory_order_relaxed);
+      }
+
+      size_t
+      ClassFor(size_t sz)
+      {
+        for(size_t cls = 0; cls < ClassSizes.size(); ++cls)
+        {
+          if(sz <= ClassSizes[cls])
+            return cls;
+        }
+        return Oversize;
+      }
+    }  // namespace
+
+    size_t
+    PacketPool::ClassSize(size_t cls)
+    {
+      return ClassSizes[cls];
+    }
+
+    char*
+    PacketPool::Alloc(size_t sz)
+    {
+      const size_t cls = ClassFor(sz);
+      auto* cache      = GetCache();
+      if(cls == Oversize)
+      {
+        Count(cache, &Counters::oversize, uint64_t{1});
+        Count(cache, &Counters::outstanding, int64_t(sz));
+        return ToData(NewBlock(Oversize, sz));
+      }
+      Count(cache, &Counters::outstanding, int64_t(ClassSizes[cls]));
+      if(cache == nullptr)
+      {
+        // thread is exiting, go to the depot one block at a time
+        if(Header* hdr = GetDepot().TakeOne(cls))
+        {
+          Count(cache, &Counters::hits, uint64_t{1});
+          return ToData(hdr);
+        }
+        Count(cache, &Counters::misses, uint64_t{1});
+        return ToData(NewBlock(cls, ClassSizes[cls]));
+      }
+      auto& list = cache->free[cls];
+      if(list.empty() && not GetDepot().Take(cls, list))
+      {
+        Count(cache, &Counters::misses, uint64_t{1});
+        return ToData(NewBlock(cls, ClassSizes[cls]));
+      }
+      Count(cache, &Counters::hits, uint64_t{1});
+      Header* hdr = list.back();
+      list.pop_back();
+      return ToData(hdr);
+    }
+
+    void
+    PacketPool::Free(char* ptr)
+    {
+      if(ptr == nullptr)
+        return;
+      Header* hdr = ToHeader(ptr);
+      auto* cache = GetCache();
+      Count(cache, &Counters::outstanding, -int64_t(hdr->capacity));
+      if(hdr->cls == Oversize)
+      {
+        DeleteBlock(hdr);
+        return;
+      }
+      if(cache == nullptr)
+      {
+        GetDepot().PutOne(hdr);
+        return;
+      }
+      auto& list = cache->free[hdr->cls];
+      if(list.size() >= ThreadCacheSize)
+        GetDepot().Put(hdr->cls, list, TransferBatch);
+      list.push_back(hdr);
+    }
+
+    size_t
+    PacketPool::Capacity(const char* ptr)
+    {
+      return ptr ? ToHeader(ptr)->capacity : 0;
+    }
+
+    PacketPool::Stats
+    PacketPool::GetStats()
+    {
+      Stats st;
+      int64_t outstanding = 0;
+      auto add            = [&](const Counters& counters) {
+        st.hits += counters.hits.load();
+        st.misses += counters.misses.load();
+        st.oversize += counters.oversize.load();
+        outstanding += counters.outstanding.load();
+      };
+      {
+        auto& registry = GetRegistry();
+        std::lock_guard< std::mutex > lock(registry.access);
+        add(registry.retired);
+        for(const auto* counters : registry.live)
+          add(*counters);
+      }
+      st.bytesOutstanding = std::max(int64_t{0}, outstanding);
+      st.blocksInDepot    = GetDepot().count.load();
+      return st;
+    }
+
+    util::StatusObject
+    PacketPool::ExtractStatus()
+    {
+      const auto st = GetStats();
+      return util::StatusObject{{"hits", st.hits},
+                                {"misses", st.misses},
+                                {"oversize", st.oversize},
+                                {"bytesOutstanding", st.bytesOutstanding},
+                                {"blocksInDepot", st.blocksInDepot}};
+    }
+  }  // namespace util
+}  // namespace llarp
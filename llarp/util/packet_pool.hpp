@@ -0,0 +1,71 @@
+#ifndef LLARP_UTIL_PACKET_POOL_HPP
+#define LLARP_UTIL_PACKET_POOL_HPP
+
+#include <util/status.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace llarp
+{
+  namespace util
+  {
+    /// size classed buffer pool for packet sized allocations
+    ///
+    /// each thread keeps a small cache of free blocks per size class and
+    /// exchanges blocks in batches with a shared depot, so buffers allocated
+    /// on the event loop and freed on the logic thread or a crypto worker get
+    /// recycled without going back to the heap. requests larger than the
+    /// biggest size class go straight to the heap.
+    struct PacketPool
+    {
+      /// number of size classes
+      static constexpr size_t NumClasses = 5;
+      /// max free blocks per size class kept in each thread's cache
+      static constexpr size_t ThreadCacheSize = 256;
+      /// number of blocks moved to or from the depot at once
+      static constexpr size_t TransferBatch = ThreadCacheSize / 4;
+      /// max free blocks per size class kept in the shared depot
+      static constexpr size_t DepotSize = 4096;
+
+      /// get the block size of a size class
+      static size_t
+      ClassSize(size_t cls);
+
+      /// allocate a buffer of at least sz bytes
+      static char*
+      Alloc(size_t sz);
+
+      /// return a buffer obtained from Alloc to the pool
+      static void
+      Free(char* ptr);
+
+      /// usable size of a buffer obtained from Alloc
+      static size_t
+      Capacity(const char* ptr);
+
+      struct Stats
+      {
+        /// allocations served from a cache or the depot
+        uint64_t hits = 0;
+        /// allocations that had to go to the heap
+        uint64_t misses = 0;
+        /// allocations too big for any size class
+        uint64_t oversize = 0;
+        /// bytes currently handed out
+        uint64_t bytesOutstanding = 0;
+        /// free blocks sitting in the shared depot
+        uint64_t blocksInDepot = 0;
+      };
+
+      /// sum the counts every thread keeps of its own, takes a lock
+      static Stats
+      GetStats();
+
+      static util::StatusObject
+      ExtractStatus();
+    };
+  }  // namespace util
+}  // namespace llarp
+
+#endif
@@ -0,0 +1,145 @@
+#ifndef LLARP_LOGIC_QUEUE_HPP
+#define LLARP_LOGIC_QUEUE_HPP
+
+#include <util/status.hpp>
+#include <util/thread/logic.hpp>
+#include <util/thread/queue.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+
+namespace llarp
+{
+  /// typed handoff from any number of threads to the logic thread
+  ///
+  /// items go through a fixed size lock free ring so pushing them does not
+  /// allocate. the logic thread is woken once per burst of pushes and hands
+  /// everything queued so far to the handler in push order. only when the
+  /// ring is full does an item fall back to its own logic call, which may
+  /// then run ahead of items still in the ring.
+  ///
+  /// logic calls only hold the queue weakly, the ones still pending when it
+  /// goes away do nothing.
+  template < typename T >
+  class LogicQueue
+  {
+   public:
+    using Handler_t = std::function< void(T) >;
+    using Clock_t   = std::chrono::steady_clock;
+
+    LogicQueue(size_t capacity, Handler_t handler)
+        : m_State(std::make_shared< State >(capacity, std::move(handler)))
+    {
+    }
+
+    LogicQueue(const LogicQueue&) = delete;
+    LogicQueue&
+    operator=(const LogicQueue&) = delete;
+
+    /// hand item to the logic thread, callable from any thread
+    void
+    Push(const std::shared_ptr< Logic >& logic, T item)
+    {
+      Entry entry{std::move(item), Clock_t::now()};
+      std::weak_ptr< State > weak = m_State;
+      if(m_State->queue.tryPushBack(std::move(entry))
+         != thread::QueueReturn::Success)
+      {
+        m_State->overflows++;
+        auto overflow = std::make_shared< T >(std::move(entry.item));
+        LogicCall(logic, [weak, overflow]() {
+          if(auto state = weak.lock())
+            state->handler(std::move(*overflow));
+        });
+        return;
+      }
+      if(not m_State->drainQueued.exchange(true))
+      {
+        LogicCall(logic, [weak]() {
+          if(auto state = weak.lock())
+            state->Drain();
+        });
+      }
+    }
+
+    /// items waiting in the ring
+    size_t
+    Depth() const
+    {
+      return m_State->queue.size();
+    }
+
+    /// callable from any thread
+    util::StatusObject
+    ExtractStatus() const
+    {
+      const State& state     = *m_State;
+      const uint64_t handled = state.handled.load();
+      const uint64_t avgLatency =
+          handled ? state.totalLatencyMicros.load() / handled : 0;
+      return util::StatusObject{{"depth", Depth()},
+                                {"maxDepth", state.maxDepth.load()},
+                                {"capacity", state.queue.capacity()},
+                                {"handled", handled},
+                                {"drains", state.drains.load()},
+                                {"overflows", state.overflows.load()},
+                                {"avgLatencyMicros", avgLatency},
+                                {"maxLatencyMicros",
+                                 state.maxLatencyMicros.load()}};
+    }
+
+   private:
+    struct Entry
+    {
+      T item;
+      Clock_t::time_point queuedAt;
+    };
+
+    struct State
+    {
+      State(size_t capacity, Handler_t h)
+          : queue(capacity), handler(std::move(h))
+      {
+      }
+
+      /// runs on the logic thread
+      void
+      Drain()
+      {
+        // clear first so a push racing with us queues another drain instead
+        // of being left behind
+        drainQueued.store(false);
+        drains++;
+        // only the logic thread writes the maximums
+        maxDepth.store(std::max(maxDepth.load(), queue.size()));
+        while(auto entry = queue.tryPopFront())
+        {
+          const auto waited = std::chrono::duration_cast<
+              std::chrono::microseconds >(Clock_t::now() - entry->queuedAt);
+          const uint64_t micros = waited.count();
+          totalLatencyMicros += micros;
+          maxLatencyMicros.store(std::max(maxLatencyMicros.load(), micros));
+          handled++;
+          handler(std::move(entry->item));
+        }
+      }
+
+      thread::Queue< Entry > queue;
+      const Handler_t handler;
+      std::atomic_bool drainQueued{false};
+      std::atomic< uint64_t > overflows{0};
+      std::atomic< size_t > maxDepth{0};
+      std::atomic< uint64_t > handled{0};
+      std::atomic< uint64_t > drains{0};
+      std::atomic< uint64_t > totalLatencyMicros{0};
+      std::atomic< uint64_t > maxLatencyMicros{0};
+    };
+
+    std::shared_ptr< State > m_State;
+  };
+}  // namespace llarp
+
+#endif
@@ -0,0 +1,105 @@
+#ifndef LLARP_UTIL_THREAD_SPSC_RING_HPP
+#define LLARP_UTIL_THREAD_SPSC_RING_HPP
+
+#include <nonstd/optional.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace llarp
+{
+  namespace thread
+  {
+    /// fixed size lock free ring from exactly one producer thread to exactly
+    /// one consumer thread
+    ///
+    /// each side only ever stores its own index and keeps a cached copy of
+    /// the other side's, so a push or pop touches the shared cache line of
+    /// the other index only when its cached copy says the ring is full or
+    /// empty
+    template < typename Type >
+    class SPSCRing
+    {
+     public:
+      /// capacity is rounded up to a power of 2
+      explicit SPSCRing(size_t capacity) : m_Slots(RoundUp(capacity))
+      {
+      }
+
+      SPSCRing(const SPSCRing&) = delete;
+      SPSCRing&
+      operator=(const SPSCRing&) = delete;
+
+      /// producer only, returns false if the ring is full
+      bool
+      tryPushBack(Type&& value)
+      {
+        const size_t tail = m_Tail.load(std::memory_order_relaxed);
+        if(tail - m_HeadCache == m_Slots.size())
+        {
+          m_HeadCache = m_Head.load(std::memory_order_acquire);
+          if(tail - m_HeadCache == m_Slots.size())
+            return false;
+        }
+        m_Slots[tail & (m_Slots.size() - 1)] = std::move(value);
+        m_Tail.store(tail + 1, std::memory_order_release);
+        return true;
+      }
+
+      /// consumer only, empty if there is nothing in the ring
+      nonstd::optional< Type >
+      tryPopFront()
+      {
+        const size_t head = m_Head.load(std::memory_order_relaxed);
+        if(head == m_TailCache)
+        {
+          m_TailCache = m_Tail.load(std::memory_order_acquire);
+          if(head == m_TailCache)
+            return {};
+        }
+        nonstd::optional< Type > value(
+            std::move(m_Slots[head & (m_Slots.size() - 1)]));
+        m_Head.store(head + 1, std::memory_order_release);
+        return value;
+      }
+
+      /// items in the ring, only exact when neither side is busy with it
+      size_t
+      size() const
+      {
+        return m_Tail.load(std::memory_order_acquire)
+            - m_Head.load(std::memory_order_acquire);
+      }
+
+      size_t
+      capacity() const
+      {
+        return m_Slots.size();
+      }
+
+     private:
+      static size_t
+      RoundUp(size_t sz)
+      {
+        size_t cap = 1;
+        while(cap < sz)
+          cap <<= 1;
+        return cap;
+      }
+
+      std::vector< Type > m_Slots;
+      /// consumer side, the next slot to pop and its copy of m_Tail
+      std::atomic< size_t > m_Head{0};
+      size_t m_TailCache = 0;
+      /// keeps the two sides off each other's cache line
+      char m_Pad[64];
+      /// producer side, the next slot to push and its copy of m_Head
+      std::atomic< size_t > m_Tail{0};
+      size_t m_HeadCache = 0;
+    };
+  }  // namespace thread
+}  // namespace llarp
+
+#endif
@@ -19,6 +19,10 @@ namespace llarp
                    bool(const llarp_buffer_t &, const llarp_buffer_t &,
                         const SharedSecret &, const byte_t *));
 
+      MOCK_METHOD3(xchacha20_batch,
+                   bool(const CryptoBatchItem *, size_t,
+                        const SharedSecret &));
+
       MOCK_METHOD4(dh_client,
                    bool(SharedSecret &, const PubKey &, const SecretKey &,
                         const TunnelNonce &));
@@ -43,6 +47,10 @@ namespace llarp
                    bool(byte_t *, const llarp_buffer_t &,
                         const SharedSecret &));
 
+      MOCK_METHOD3(hmac_batch,
+                   bool(const CryptoBatchItem *, size_t,
+                        const SharedSecret &));
+
       MOCK_METHOD4(derive_subkey, bool(PubKey &, const PubKey &, uint64_t, const AlignedBuffer<32> *));
 
       MOCK_METHOD4(derive_subkey_private,
@@ -0,0 +1,151 @@
+#include <crypto/multibuf.hpp>
+
+#include <sodium/core.h>
+#include <sodium/crypto_generichash_blake2b.h>
+#include <sodium/crypto_stream_xchacha20.h>
+
+#include <catch2/catch.hpp>
+
+#include <array>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using llarp::CryptoBatchItem;
+using llarp::multibuf::Kernel;
+
+namespace
+{
+  std::vector< Kernel >
+  Kernels()
+  {
+    std::vector< Kernel > kernels{Kernel::Scalar};
+    if(llarp::multibuf::Best() != Kernel::Scalar)
+      kernels.push_back(llarp::multibuf::Best());
+    return kernels;
+  }
+
+  /// random packets with their own nonce and mac storage
+  struct Batch
+  {
+    std::vector< std::vector< byte_t > > data;
+    std::vector< std::array< byte_t, 24 > > nonces;
+    std::vector< std::array< byte_t, HMACSIZE > > macs;
+    std::vector< CryptoBatchItem > items;
+
+    Batch(std::mt19937& rng, const std::vector< size_t >& sizes)
+        : data(sizes.size()), nonces(sizes.size()), macs(sizes.size())
+    {
+      for(size_t idx = 0; idx < sizes.size(); ++idx)
+      {
+        data[idx].resize(sizes[idx]);
+        for(auto& b : data[idx])
+          b = byte_t(rng());
+        for(auto& b : nonces[idx])
+          b = byte_t(rng());
+        items.emplace_back(CryptoBatchItem{data[idx].data(), data[idx].size(),
+                                           nonces[idx].data(),
+                                           macs[idx].data()});
+      }
+    }
+  };
+}  // namespace
+
+TEST_CASE("multibuf kernels match libsodium", "[crypto][multibuf]")
+{
+  REQUIRE(sodium_init() != -1);
+  std::mt19937 rng(1337);
+  std::array< byte_t, 32 > key;
+  for(auto& b : key)
+    b = byte_t(rng());
+
+  // odd lane counts, empty buffers, partial and exact blocks of both ciphers
+  const std::vector< size_t > sizes = {0,   1,    63,   64,  65,  127,
+                                       128, 129,  200,  511, 512, 1000,
+                                       1400, 1436, 1500, 31,  4096};
+  for(const auto kernel : Kernels())
+  {
+    for(size_t num : {size_t{1}, size_t{3}, size_t{8}, sizes.size()})
+    {
+      DYNAMIC_SECTION(llarp::multibuf::KernelName(kernel) << " x" << num)
+      {
+        const std::vector< size_t > batchSizes(sizes.begin(),
+                                               sizes.begin() + num);
+        Batch batch(rng, batchSizes);
+        const auto plaintext = batch.data;
+
+        llarp::multibuf::hmac(kernel, batch.items.data(), num, key.data());
+        for(size_t idx = 0; idx < num; ++idx)
+        {
+          std::array< byte_t, HMACSIZE > expected;
+          crypto_generichash_blake2b(expected.data(), expected.size(),
+                                     plaintext[idx].data(),
+                                     plaintext[idx].size(), key.data(),
+                                     key.size());
+          REQUIRE(batch.macs[idx] == expected);
+        }
+
+        llarp::multibuf::xchacha20(kernel, batch.items.data(), num,
+                                   key.data());
+        for(size_t idx = 0; idx < num; ++idx)
+        {
+          std::vector< byte_t > expected(plaintext[idx].size());
+          crypto_stream_xchacha20_xor(expected.data(), plaintext[idx].data(),
+                                      expected.size(),
+                                      batch.nonces[idx].data(), key.data());
+          REQUIRE(batch.data[idx] == expected);
+        }
+
+        // applying the keystream again gets the plaintext back
+        llarp::multibuf::xchacha20(kernel, batch.items.data(), num,
+                                   key.data());
+        REQUIRE(batch.data == plaintext);
+      }
+    }
+  }
+}
+
+TEST_CASE("multibuf throughput", "[.][benchmark][crypto][multibuf]")
+{
+  REQUIRE(sodium_init() != -1);
+  static constexpr size_t batchSize = 64;
+  static constexpr size_t pktSize   = 1400;
+  static constexpr size_t rounds    = 2000;
+  using Clock_t                     = std::chrono::steady_clock;
+
+  std::mt19937 rng(42);
+  std::array< byte_t, 32 > key;
+  for(auto& b : key)
+    b = byte_t(rng());
+  Batch batch(rng, std::vector< size_t >(batchSize, pktSize));
+
+  auto measure = [&](const char* name, auto&& func) {
+    const auto start = Clock_t::now();
+    for(size_t round = 0; round < rounds; ++round)
+      func();
+    const std::chrono::duration< double > dlt = Clock_t::now() - start;
+    const double bytes = double(rounds) * batchSize * pktSize;
+    std::cout << name << ": " << (bytes / dlt.count()) / (1024 * 1024)
+              << " MiB/s/core" << std::endl;
+  };
+
+  measure("libsodium per packet", [&]() {
+    for(const auto& item : batch.items)
+    {
+      crypto_stream_xchacha20_xor(item.data, item.data, item.sz, item.nonce,
+                                  key.data());
+      crypto_generichash_blake2b(item.mac, HMACSIZE, item.data, item.sz,
+                                 key.data(), key.size());
+    }
+  });
+  for(const auto kernel : Kernels())
+  {
+    measure(llarp::multibuf::KernelName(kernel), [&]() {
+      llarp::multibuf::xchacha20(kernel, batch.items.data(), batchSize,
+                                 key.data());
+      llarp::multibuf::hmac(kernel, batch.items.data(), batchSize,
+                            key.data());
+    });
+  }
+}
@@ -0,0 +1,188 @@
+#include <dht/bucket.hpp>
+#include <dht/kademlia.hpp>
+#include <dht/node.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <random>
+
+using llarp::dht::Key_t;
+using Bucket_t = llarp::dht::Bucket< llarp::dht::RCNode >;
+
+namespace
+{
+  Key_t
+  RandomKey(std::mt19937& rng)
+  {
+    Key_t key;
+    for(auto& b : key)
+      b = rng();
+    return key;
+  }
+
+  llarp::dht::RCNode
+  MakeNode(const Key_t& key)
+  {
+    llarp::dht::RCNode node;
+    node.ID = key;
+    return node;
+  }
+}  // namespace
+
+TEST_CASE("bucket near queries match a full sort", "[dht]")
+{
+  std::mt19937 rng(42);
+  Bucket_t bucket(RandomKey(rng), [&rng]() { return rng(); });
+  std::vector< Key_t > keys;
+  for(size_t idx = 0; idx < 500; ++idx)
+  {
+    keys.push_back(RandomKey(rng));
+    bucket.PutNode(MakeNode(keys.back()));
+  }
+  // drop some again so the arrays get shuffled around
+  for(size_t idx = 0; idx < keys.size(); idx += 5)
+    bucket.DelNode(keys[idx]);
+  bucket.RemoveIf([&keys](const Key_t& key) { return key == keys[1]; });
+  std::vector< Key_t > kept;
+  for(size_t idx = 0; idx < keys.size(); ++idx)
+  {
+    if(idx % 5 != 0 && idx != 1)
+      kept.push_back(keys[idx]);
+  }
+  REQUIRE(bucket.size() == kept.size());
+
+  for(size_t round = 0; round < 100; ++round)
+  {
+    const Key_t target = RandomKey(rng);
+    std::set< Key_t > exclude;
+    for(size_t idx = 0; idx < 3; ++idx)
+      exclude.insert(kept[rng() % kept.size()]);
+
+    std::vector< Key_t > expect;
+    std::copy_if(kept.begin(), kept.end(), std::back_inserter(expect),
+                 [&exclude](const Key_t& k) { return !exclude.count(k); });
+    std::partial_sort(expect.begin(), expect.begin() + 4, expect.end(),
+                      llarp::dht::XorMetric{target});
+    expect.resize(4);
+
+    std::set< Key_t > found;
+    REQUIRE(bucket.GetManyNearExcluding(target, found, 4, exclude));
+    REQUIRE(found == std::set< Key_t >(expect.begin(), expect.end()));
+    Key_t closest;
+    REQUIRE(bucket.FindCloseExcluding(target, closest, exclude));
+    REQUIRE(closest == expect.front());
+
+    Key_t picked;
+    REQUIRE(bucket.GetRandomNodeExcluding(picked, exclude));
+    REQUIRE(bucket.HasNode(picked));
+    REQUIRE(exclude.count(picked) == 0);
+  }
+
+  // with all but one excluded the one left is found
+  std::set< Key_t > exclude(kept.begin() + 1, kept.end());
+  Key_t picked;
+  REQUIRE(bucket.GetRandomNodeExcluding(picked, exclude));
+  REQUIRE(picked == kept.front());
+  exclude.insert(kept.front());
+  REQUIRE_FALSE(bucket.GetRandomNodeExcluding(picked, exclude));
+}
+
+TEST_CASE("bucket search microbenchmarks", "[.][benchmark][dht]")
+{
+  static constexpr size_t queries = 20000;
+  using Clock_t                   = std::chrono::steady_clock;
+
+  std::mt19937 rng(42);
+  for(const size_t numNodes : {100, 1000, 10000})
+  {
+    const Key_t us = RandomKey(rng);
+    Bucket_t bucket(us, [&rng]() { return rng(); });
+    // what the bucket kept its nodes in before
+    std::map< Key_t, llarp::dht::RCNode, llarp::dht::XorMetric > nodes{
+        llarp::dht::XorMetric{us}};
+    std::vector< Key_t > keys;
+    for(size_t idx = 0; idx < numNodes; ++idx)
+    {
+      keys.push_back(RandomKey(rng));
+      bucket.PutNode(MakeNode(keys.back()));
+      nodes.emplace(keys.back(), MakeNode(keys.back()));
+    }
+    // a lookup that already asked a few peers
+    std::set< Key_t > exclude;
+    for(size_t idx = 0; idx < 8; ++idx)
+      exclude.insert(keys[idx]);
+
+    auto measure = [&](const char* name, auto&& func) {
+      const auto start = Clock_t::now();
+      for(size_t idx = 0; idx < queries; ++idx)
+        func(RandomKey(rng));
+      const std::chrono::duration< double, std::nano > dlt =
+          Clock_t::now() - start;
+      std::cout << numNodes << " nodes " << name << ": "
+                << dlt.count() / queries << " ns/query" << std::endl;
+    };
+
+    measure("map FindClosest", [&](const Key_t& target) {
+      Key_t mindist, result;
+      mindist.Fill(0xff);
+      for(const auto& item : nodes)
+      {
+        const auto dist = item.first ^ target;
+        if(dist < mindist)
+        {
+          mindist = dist;
+          result  = item.first;
+        }
+      }
+      REQUIRE(nodes.count(result));
+    });
+    measure("flat FindClosest", [&](const Key_t& target) {
+      Key_t result;
+      REQUIRE(bucket.FindClosest(target, result));
+    });
+
+    measure("map GetManyNearExcluding", [&](const Key_t& target) {
+      // one linear pass per peer wanted
+      std::set< Key_t > skip(exclude), result;
+      for(size_t n = 0; n < 4; ++n)
+      {
+        Key_t mindist, found;
+        mindist.Fill(0xff);
+        for(const auto& item : nodes)
+        {
+          const auto dist = item.first ^ target;
+          if(not skip.count(item.first) && dist < mindist)
+          {
+            mindist = dist;
+            found   = item.first;
+          }
+        }
+        skip.insert(found);
+        result.insert(found);
+      }
+      REQUIRE(result.size() == 4);
+    });
+    measure("flat GetManyNearExcluding", [&](const Key_t& target) {
+      std::set< Key_t > result;
+      REQUIRE(bucket.GetManyNearExcluding(target, result, 4, exclude));
+    });
+
+    measure("map GetRandomNodeExcluding", [&](const Key_t&) {
+      std::vector< std::pair< const Key_t, llarp::dht::RCNode > > candidates;
+      for(const auto& item : nodes)
+      {
+        if(not exclude.count(item.first))
+          candidates.push_back(item);
+      }
+      REQUIRE(not candidates.empty());
+    });
+    measure("flat GetRandomNodeExcluding", [&](const Key_t&) {
+      Key_t result;
+      REQUIRE(bucket.GetRandomNodeExcluding(result, exclude));
+    });
+  }
+}
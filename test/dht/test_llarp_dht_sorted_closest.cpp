@@ -0,0 +1,90 @@
+#include <dht/kademlia.hpp>
+#include <dht/sorted_closest.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using llarp::dht::Key_t;
+
+namespace
+{
+  Key_t
+  RandomKey(std::mt19937& rng)
+  {
+    Key_t key;
+    for(auto& b : key)
+      b = rng();
+    return key;
+  }
+
+  std::vector< Key_t >
+  BruteForceClosest(std::vector< Key_t > keys, const Key_t& target, size_t num)
+  {
+    num = std::min(num, keys.size());
+    std::partial_sort(keys.begin(), keys.begin() + num, keys.end(),
+                      llarp::dht::XorMetric{target});
+    keys.resize(num);
+    return keys;
+  }
+
+  std::vector< Key_t >
+  SortedClosest(const std::vector< Key_t >& sorted, const Key_t& target,
+                size_t num)
+  {
+    std::vector< Key_t > found;
+    llarp::dht::VisitSortedClosest(
+        sorted.begin(), sorted.end(), target,
+        [](const Key_t& key) -> const Key_t& { return key; },
+        [&](auto itr) {
+          if(found.size() == num)
+            return false;
+          found.push_back(*itr);
+          return true;
+        });
+    return found;
+  }
+}  // namespace
+
+TEST_CASE("sorted keys come out in xor distance order", "[dht][xor]")
+{
+  REQUIRE(SortedClosest({}, Key_t{}, 4).empty());
+
+  // keys sharing long prefixes make for deep splits
+  std::vector< Key_t > keys;
+  for(byte_t fill = 0; fill < 8; ++fill)
+  {
+    Key_t key;
+    key.Fill(0xAA);
+    key[31] = fill;
+    keys.push_back(key);
+  }
+
+  Key_t target;
+  target.Fill(0xAA);
+  target[31] = 5;
+  REQUIRE(SortedClosest(keys, target, 8) == BruteForceClosest(keys, target, 8));
+  REQUIRE(SortedClosest(keys, target, 0).empty());
+  REQUIRE(SortedClosest(keys, target, 1).front() == keys[5]);
+}
+
+TEST_CASE("sorted closest matches a full sort", "[dht][xor]")
+{
+  std::mt19937 rng(1337);
+  std::vector< Key_t > keys;
+  for(size_t idx = 0; idx < 2000; ++idx)
+    keys.push_back(RandomKey(rng));
+  std::sort(keys.begin(), keys.end());
+
+  for(size_t round = 0; round < 200; ++round)
+  {
+    const Key_t target = RandomKey(rng);
+    const size_t num   = 1 + rng() % 32;
+    REQUIRE(SortedClosest(keys, target, num)
+            == BruteForceClosest(keys, target, num));
+  }
+  // a key in the range is closest to itself
+  REQUIRE(SortedClosest(keys, keys[7], 1).front() == keys[7]);
+}
@@ -0,0 +1,160 @@
+#include <dht/txholder.hpp>
+
+#include <dht/messages/findintro.hpp>
+#include <dht/messages/gotintro.hpp>
+#include <dht/mock_context.hpp>
+#include <dht/serviceaddresslookup.hpp>
+#include <service/tag.hpp>
+#include <test_util.hpp>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+using namespace llarp;
+using namespace ::testing;
+
+using llarp::test::makeBuf;
+
+using Val_t = llarp::service::Tag;
+
+namespace
+{
+  struct TestTx final : public dht::TX< dht::Key_t, Val_t >
+  {
+    TestTx(const dht::TXOwner& asker, const dht::Key_t& k)
+        : dht::TX< dht::Key_t, Val_t >(asker, k, nullptr)
+    {
+    }
+
+    MOCK_CONST_METHOD1(Validate, bool(const Val_t&));
+
+    MOCK_METHOD1(Start, void(const dht::TXOwner&));
+
+    MOCK_METHOD0(SendReply, void());
+  };
+
+  using Holder_t = dht::TXHolder< dht::Key_t, Val_t, dht::Key_t::Hash >;
+}  // namespace
+
+struct TestDhtTxHolder : public Test
+{
+  Holder_t holder;
+  dht::TXOwner asker;
+  dht::Key_t key;
+  std::vector< dht::TXOwner > peers;
+
+  TestDhtTxHolder() : key(makeBuf< dht::Key_t >(0x01))
+  {
+    for(byte_t idx = 0; idx < dht::LookupAlpha; ++idx)
+      peers.emplace_back(makeBuf< dht::Key_t >(0x10 + idx), idx);
+  }
+
+  TestTx*
+  StartParallel()
+  {
+    auto tx = new TestTx(asker, key);
+    for(const auto& peer : peers)
+      EXPECT_CALL(*tx, Start(peer)).Times(1);
+    holder.NewTX(peers, asker, key, tx);
+    return tx;
+  }
+};
+
+TEST_F(TestDhtTxHolder, first_valid_value_wins)
+{
+  auto tx = StartParallel();
+  const Val_t val("good value");
+
+  // a miss only drops the peer that missed
+  EXPECT_CALL(*tx, SendReply()).Times(0);
+  holder.NotFound(peers[0], nullptr);
+  ASSERT_FALSE(holder.HasPendingLookupFrom(peers[0]));
+  ASSERT_TRUE(holder.HasPendingLookupFrom(peers[1]));
+  ASSERT_TRUE(holder.HasLookupFor(key));
+  Mock::VerifyAndClearExpectations(tx);
+
+  EXPECT_CALL(*tx, Validate(val)).WillOnce(Return(true));
+  EXPECT_CALL(*tx, SendReply()).Times(1);
+  holder.Found(peers[1], key, {val});
+  ASSERT_FALSE(holder.HasLookupFor(key));
+  ASSERT_FALSE(holder.HasPendingLookupFrom(peers[2]));
+  ASSERT_TRUE(holder.waiting.empty());
+}
+
+TEST_F(TestDhtTxHolder, empty_once_every_peer_missed)
+{
+  auto tx = StartParallel();
+  const Val_t bad("bad value");
+
+  // invalid values count as a miss
+  EXPECT_CALL(*tx, Validate(bad)).WillOnce(Return(false));
+  EXPECT_CALL(*tx, SendReply()).Times(0);
+  holder.Found(peers[2], key, {bad});
+  holder.NotFound(peers[0], nullptr);
+  ASSERT_TRUE(holder.HasLookupFor(key));
+  Mock::VerifyAndClearExpectations(tx);
+
+  EXPECT_CALL(*tx, SendReply()).Times(1);
+  holder.NotFound(peers[1], nullptr);
+  ASSERT_FALSE(holder.HasLookupFor(key));
+  ASSERT_TRUE(holder.tx.empty());
+}
+
+TEST_F(TestDhtTxHolder, later_lookups_wait_on_the_running_one)
+{
+  auto tx    = StartParallel();
+  auto other = new TestTx(asker, key);
+  EXPECT_CALL(*other, Start(_)).Times(0);
+  holder.NewTX(std::vector< dht::TXOwner >{{makeBuf< dht::Key_t >(0x20), 9},
+                                            {makeBuf< dht::Key_t >(0x21), 10}},
+               asker, key, other);
+  ASSERT_EQ(holder.waiting.count(key), peers.size() + 1);
+
+  // both hear the answer exactly once
+  const Val_t val("good value");
+  EXPECT_CALL(*tx, Validate(val)).WillOnce(Return(true));
+  EXPECT_CALL(*other, Validate(val)).WillOnce(Return(true));
+  EXPECT_CALL(*tx, SendReply()).Times(1);
+  EXPECT_CALL(*other, SendReply()).Times(1);
+  holder.Found(peers[0], key, {val});
+  ASSERT_TRUE(holder.tx.empty());
+}
+
+TEST_F(TestDhtTxHolder, service_lookup_asks_peers_at_once)
+{
+  test::MockContext context;
+  const auto ourKey = makeBuf< dht::Key_t >(0x02);
+  const dht::TXOwner whoasked(makeBuf< dht::Key_t >(0x03), 7);
+  EXPECT_CALL(context, OurKey()).WillRepeatedly(ReturnRef(ourKey));
+
+  size_t results = 0;
+  auto lookup    = new dht::ServiceAddressLookup(
+      whoasked, key, &context, 0,
+      [&results](const std::vector< service::EncryptedIntroSet >& found) {
+        ASSERT_TRUE(found.empty());
+        ++results;
+      });
+
+  dht::AbstractContext::PendingIntrosetLookups lookups;
+  for(const auto& peer : peers)
+  {
+    EXPECT_CALL(context,
+                DHTSendTo(Eq(peer.node.as_array()),
+                          WhenDynamicCastTo< dht::FindIntroMessage* >(
+                              NotNull()),
+                          true))
+        .Times(1);
+  }
+  lookups.NewTX(peers, whoasked, whoasked, lookup);
+  Mock::VerifyAndClearExpectations(&context);
+
+  EXPECT_CALL(context, DHTSendTo(Eq(whoasked.node.as_array()),
+                                 WhenDynamicCastTo< dht::GotIntroMessage* >(
+                                     NotNull()),
+                                 true))
+      .Times(1);
+  for(const auto& peer : peers)
+    lookups.NotFound(peer, nullptr);
+  ASSERT_EQ(results, 1u);
+  ASSERT_FALSE(lookups.HasLookupFor(whoasked));
+}
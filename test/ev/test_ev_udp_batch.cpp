@@ -0,0 +1,148 @@
+#include <ev/udp_batch.hpp>
+
+#include <catch2/catch.hpp>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <iostream>
+
+namespace
+{
+  struct LoopbackPair
+  {
+    int sender   = -1;
+    int receiver = -1;
+    sockaddr_in to;
+
+    LoopbackPair()
+    {
+      sender   = socket(AF_INET, SOCK_DGRAM, 0);
+      receiver = socket(AF_INET, SOCK_DGRAM, 0);
+      std::memset(&to, 0, sizeof(to));
+      to.sin_family      = AF_INET;
+      to.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+      to.sin_port        = 0;
+      bind(receiver, (const sockaddr*)&to, sizeof(to));
+      socklen_t len = sizeof(to);
+      getsockname(receiver, (sockaddr*)&to, &len);
+      fcntl(receiver, F_SETFL, fcntl(receiver, F_GETFL) | O_NONBLOCK);
+      int bufsz = 4 * 1024 * 1024;
+      setsockopt(receiver, SOL_SOCKET, SO_RCVBUF, &bufsz, sizeof(bufsz));
+    }
+
+    ~LoopbackPair()
+    {
+      close(sender);
+      close(receiver);
+    }
+
+    const sockaddr*
+    Remote() const
+    {
+      return (const sockaddr*)&to;
+    }
+  };
+}  // namespace
+
+TEST_CASE("UDPBatchIO round trips a batch over loopback", "[ev][udp]")
+{
+  LoopbackPair pair;
+  REQUIRE(pair.sender != -1);
+  REQUIRE(pair.receiver != -1);
+
+  constexpr size_t numPkts = llarp::UDPBatchIO::BatchSize + 5;
+  std::vector< std::array< byte_t, 64 > > payloads(numPkts);
+  std::vector< llarp_udp_pkt > pkts;
+  for(size_t idx = 0; idx < numPkts; ++idx)
+  {
+    payloads[idx].fill(byte_t(idx));
+    pkts.emplace_back(llarp_udp_pkt{payloads[idx].data(), idx + 1});
+  }
+
+  REQUIRE(llarp::UDPBatchIO::SendMany(pair.sender, pair.Remote(), pkts.data(),
+                                      pkts.size())
+          == ssize_t(numPkts));
+
+  llarp::UDPBatchIO batch;
+  llarp_pkt_list got;
+  // one call never reads more than a batch
+  REQUIRE(batch.RecvMany(pair.receiver, got)
+          == ssize_t(llarp::UDPBatchIO::BatchSize));
+  while(batch.RecvMany(pair.receiver, got) > 0)
+    ;
+  REQUIRE(got.size() == numPkts);
+  for(size_t idx = 0; idx < numPkts; ++idx)
+  {
+    REQUIRE(got[idx].pkt.size() == idx + 1);
+    REQUIRE(got[idx].pkt[0] == byte_t(idx));
+  }
+}
+
+TEST_CASE("UDPBatchIO never waits on a blocking socket", "[ev][udp]")
+{
+  LoopbackPair pair;
+  fcntl(pair.receiver, F_SETFL, fcntl(pair.receiver, F_GETFL) & ~O_NONBLOCK);
+  llarp::UDPBatchIO batch;
+  llarp_pkt_list got;
+  REQUIRE(batch.RecvMany(pair.receiver, got) == 0);
+  REQUIRE(got.empty());
+}
+
+TEST_CASE("UDPBatchIO packets per second", "[.][benchmark][ev][udp]")
+{
+  static constexpr size_t numPkts = 200000;
+  static constexpr size_t pktSize = 1024;
+  using Clock_t                   = std::chrono::steady_clock;
+
+  std::array< byte_t, pktSize > payload;
+  payload.fill(0x42);
+
+  auto runSingle = [&]() -> double {
+    LoopbackPair pair;
+    std::array< char, 1500 > buf;
+    size_t recvd    = 0;
+    const auto start = Clock_t::now();
+    for(size_t sent = 0; sent < numPkts; ++sent)
+    {
+      sendto(pair.sender, payload.data(), payload.size(), 0, pair.Remote(),
+             sizeof(sockaddr_in));
+      while(recv(pair.receiver, buf.data(), buf.size(), 0) > 0)
+        ++recvd;
+    }
+    const std::chrono::duration< double > dlt = Clock_t::now() - start;
+    return recvd / dlt.count();
+  };
+
+  auto runBatched = [&]() -> double {
+    LoopbackPair pair;
+    llarp::UDPBatchIO batch;
+    std::vector< llarp_udp_pkt > pkts(
+        llarp::UDPBatchIO::BatchSize,
+        llarp_udp_pkt{payload.data(), payload.size()});
+    size_t recvd     = 0;
+    const auto start = Clock_t::now();
+    for(size_t sent = 0; sent < numPkts; sent += pkts.size())
+    {
+      llarp::UDPBatchIO::SendMany(pair.sender, pair.Remote(), pkts.data(),
+                                  pkts.size());
+      llarp_pkt_list got;
+      while(batch.RecvMany(pair.receiver, got) > 0)
+        ;
+      recvd += got.size();
+    }
+    const std::chrono::duration< double > dlt = Clock_t::now() - start;
+    return recvd / dlt.count();
+  };
+
+  const auto single  = runSingle();
+  const auto batched = runBatched();
+  std::cout << "udp single: " << single << " pkt/s" << std::endl;
+  std::cout << "udp batched: " << batched << " pkt/s" << std::endl;
+  REQUIRE(single > 0);
+  REQUIRE(batched > 0);
+}
+#endif
@@ -0,0 +1,388 @@
+#include <ev/vnet.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <cstring>
+#include <numeric>
+#include <vector>
+
+#ifdef LLARP_TUN_VNET
+#include <arpa/inet.h>
+#include <net/if.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sched.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+using namespace llarp;
+
+namespace
+{
+  uint16_t
+  Get16(const byte_t* ptr)
+  {
+    return (uint16_t(ptr[0]) << 8) | ptr[1];
+  }
+
+  void
+  Put16(byte_t* ptr, uint16_t val)
+  {
+    ptr[0] = val >> 8;
+    ptr[1] = val;
+  }
+
+  uint32_t
+  Sum(const byte_t* buf, size_t sz, uint32_t sum = 0)
+  {
+    for(; sz > 1; sz -= 2, buf += 2)
+      sum += Get16(buf);
+    if(sz)
+      sum += uint32_t(*buf) << 8;
+    while(sum >> 16)
+      sum = (sum & 0xFFff) + (sum >> 16);
+    return sum;
+  }
+
+  /// sum of the l4 pseudo header, not folded
+  uint32_t
+  Pseudo(const byte_t* pkt, uint8_t proto, size_t l4len)
+  {
+    const bool v4 = (pkt[0] >> 4) == 4;
+    uint32_t sum  = proto + l4len;
+    return v4 ? Sum(pkt + 12, 8, sum) : Sum(pkt + 8, 32, sum);
+  }
+
+  /// an ip packet with a tcp header and payload, checksums left empty
+  std::vector< byte_t >
+  MakeTCP(bool v4, size_t payload)
+  {
+    const size_t l3 = v4 ? 20 : 40;
+    std::vector< byte_t > pkt(l3 + 20 + payload, 0);
+    if(v4)
+    {
+      pkt[0] = 0x45;
+      Put16(pkt.data() + 2, pkt.size());
+      Put16(pkt.data() + 4, 100);
+      pkt[8] = 64;
+      pkt[9] = 6;
+      std::fill_n(pkt.data() + 12, 4, 10);
+      std::fill_n(pkt.data() + 16, 4, 11);
+    }
+    else
+    {
+      pkt[0] = 0x60;
+      Put16(pkt.data() + 4, pkt.size() - l3);
+      pkt[6] = 6;
+      pkt[7] = 64;
+      std::fill_n(pkt.data() + 8, 16, 0xfd);
+      std::fill_n(pkt.data() + 24, 16, 0xfe);
+    }
+    byte_t* tcp = pkt.data() + l3;
+    Put16(tcp, 4000);
+    Put16(tcp + 2, 80);
+    // seq close to wrapping
+    tcp[4] = tcp[5] = tcp[6] = 0xff;
+    tcp[7]               = 0x00;
+    tcp[12]              = 5 << 4;
+    // cwr, ack, psh and fin
+    tcp[13] = 0x80 | 0x10 | 0x08 | 0x01;
+    std::iota(tcp + 20, pkt.data() + pkt.size(), 0);
+    return pkt;
+  }
+
+  void
+  CheckSegments(bool v4)
+  {
+    const size_t l3  = v4 ? 20 : 40;
+    const size_t mss = 1400;
+    auto pkt         = MakeTCP(v4, 3000);
+    vnet::Header hdr;
+    hdr.flags   = vnet::Header::NeedsChecksum;
+    hdr.gsoType = v4 ? vnet::Header::GSOTCPv4 : vnet::Header::GSOTCPv6;
+    hdr.gsoSize = mss;
+
+    std::vector< std::vector< byte_t > > segs;
+    std::vector< byte_t > scratch;
+    REQUIRE(vnet::Segment(hdr, pkt.data(), pkt.size(), scratch,
+                          [&](const llarp_buffer_t& seg) {
+                            segs.emplace_back(seg.base, seg.base + seg.sz);
+                          }));
+    REQUIRE(segs.size() == 3);
+
+    std::vector< byte_t > joined;
+    for(size_t idx = 0; idx < segs.size(); ++idx)
+    {
+      auto& seg         = segs[idx];
+      const byte_t* tcp = seg.data() + l3;
+      const size_t len  = seg.size() - l3 - 20;
+      REQUIRE(len == (idx < 2 ? mss : 200));
+      if(v4)
+      {
+        REQUIRE(Get16(seg.data() + 2) == seg.size());
+        REQUIRE(Get16(seg.data() + 4) == 100 + idx);
+        REQUIRE(Sum(seg.data(), l3) == 0xFFff);
+      }
+      else
+        REQUIRE(Get16(seg.data() + 4) == seg.size() - l3);
+      const uint32_t seq = (uint32_t(Get16(tcp + 4)) << 16) | Get16(tcp + 6);
+      REQUIRE(seq == uint32_t(0xffffff00 + idx * mss));
+      const bool last = idx + 1 == segs.size();
+      REQUIRE(bool(tcp[13] & 0x80) == (idx == 0));
+      REQUIRE(bool(tcp[13] & 0x09) == last);
+      REQUIRE(tcp[13] & 0x10);
+      REQUIRE(Sum(tcp, seg.size() - l3, Pseudo(seg.data(), 6, seg.size() - l3))
+              == 0xFFff);
+      joined.insert(joined.end(), tcp + 20, tcp + seg.size() - l3);
+    }
+    REQUIRE(std::equal(joined.begin(), joined.end(), pkt.begin() + l3 + 20));
+  }
+}  // namespace
+
+TEST_CASE("vnet splits tcp gso super packets", "[ev][vnet]")
+{
+  SECTION("ipv4")
+  {
+    CheckSegments(true);
+  }
+  SECTION("ipv6")
+  {
+    CheckSegments(false);
+  }
+}
+
+TEST_CASE("vnet finishes partial checksums", "[ev][vnet]")
+{
+  // ipv4 udp with the pseudo header sum where the checksum goes
+  std::vector< byte_t > pkt(20 + 8 + 33, 0);
+  pkt[0] = 0x45;
+  Put16(pkt.data() + 2, pkt.size());
+  pkt[9] = 17;
+  std::fill_n(pkt.data() + 12, 8, 7);
+  Put16(pkt.data() + 24, 8 + 33);
+  std::iota(pkt.begin() + 28, pkt.end(), 1);
+  Put16(pkt.data() + 26, Sum(pkt.data() + 12, 8, 17 + 8 + 33));
+
+  vnet::Header hdr;
+  hdr.flags      = vnet::Header::NeedsChecksum;
+  hdr.csumStart  = 20;
+  hdr.csumOffset = 6;
+  std::vector< byte_t > scratch;
+  size_t seen = 0;
+  REQUIRE(vnet::Segment(hdr, pkt.data(), pkt.size(), scratch,
+                        [&](const llarp_buffer_t& buf) {
+                          REQUIRE(buf.base == pkt.data());
+                          ++seen;
+                        }));
+  REQUIRE(seen == 1);
+  REQUIRE(Sum(pkt.data() + 20, pkt.size() - 20, Pseudo(pkt.data(), 17, 41))
+          == 0xFFff);
+
+  // out of bounds checksum spot and offloads we never turn on
+  hdr.csumStart = pkt.size();
+  REQUIRE_FALSE(vnet::Segment(hdr, pkt.data(), pkt.size(), scratch,
+                              [](const llarp_buffer_t&) {}));
+  hdr.gsoType = 3;
+  REQUIRE_FALSE(vnet::Segment(hdr, pkt.data(), pkt.size(), scratch,
+                              [](const llarp_buffer_t&) {}));
+}
+
+TEST_CASE("vnet headers in either byte order", "[ev][vnet]")
+{
+  vnet::Header hdr;
+  hdr.flags      = vnet::Header::NeedsChecksum;
+  hdr.gsoType    = vnet::Header::GSOTCPv4;
+  hdr.hdrLen     = 0x0102;
+  hdr.gsoSize    = 1448;
+  hdr.csumStart  = 20;
+  hdr.csumOffset = 16;
+  byte_t buf[vnet::Header::SIZE];
+  hdr.Encode(buf, true);
+  REQUIRE(buf[2] == 0x02);
+  REQUIRE(buf[3] == 0x01);
+  for(const bool le : {true, false})
+  {
+    hdr.Encode(buf, le);
+    vnet::Header decoded;
+    REQUIRE(decoded.Decode(buf, sizeof(buf), le));
+    REQUIRE(decoded.flags == hdr.flags);
+    REQUIRE(decoded.gsoType == hdr.gsoType);
+    REQUIRE(decoded.hdrLen == hdr.hdrLen);
+    REQUIRE(decoded.gsoSize == hdr.gsoSize);
+    REQUIRE(decoded.csumStart == hdr.csumStart);
+    REQUIRE(decoded.csumOffset == hdr.csumOffset);
+  }
+  vnet::Header decoded;
+  REQUIRE_FALSE(decoded.Decode(buf, vnet::Header::SIZE - 1, true));
+}
+
+TEST_CASE("vnet flow hash keeps a flow together", "[ev][vnet]")
+{
+  // ipv4 udp from 10.0.0.1:1000 to 10.0.0.2:53
+  std::vector< byte_t > pkt(20 + 8 + 10, 0);
+  pkt[0]  = 0x45;
+  pkt[9]  = 17;
+  pkt[12] = 10;
+  pkt[15] = 1;
+  pkt[16] = 10;
+  pkt[19] = 2;
+  Put16(pkt.data() + 20, 1000);
+  Put16(pkt.data() + 22, 53);
+  const auto hash = vnet::FlowHash(pkt.data(), pkt.size());
+
+  // the payload and the rest of the headers do not matter
+  auto other = pkt;
+  other[8]   = 64;
+  other[30]  = 'x';
+  REQUIRE(vnet::FlowHash(other.data(), other.size()) == hash);
+
+  // another port is another flow
+  Put16(other.data() + 20, 1001);
+  REQUIRE(vnet::FlowHash(other.data(), other.size()) != hash);
+
+  // later fragments have no ports to go by
+  other = pkt;
+  Put16(other.data() + 6, 185);
+  Put16(other.data() + 20, 1001);
+  auto frag = other;
+  Put16(frag.data() + 20, 1002);
+  REQUIRE(vnet::FlowHash(other.data(), other.size())
+          == vnet::FlowHash(frag.data(), frag.size()));
+
+  // too short to be ip at all
+  REQUIRE(vnet::FlowHash(pkt.data(), 10) == vnet::FlowHash(nullptr, 0));
+}
+
+#ifdef LLARP_TUN_VNET
+namespace
+{
+  constexpr int Skipped = 77;
+
+  /// runs in a child in its own network namespace, returns an exit code
+  int
+  TunRoundTrip()
+  {
+    if(unshare(CLONE_NEWNET) == -1
+       && unshare(CLONE_NEWUSER | CLONE_NEWNET) == -1)
+      return Skipped;
+    char ifname[IFNAMSIZ] = "llarp-vnet0";
+    std::vector< int > fds;
+    bool le = false;
+    if(not vnet::OpenQueues(ifname, 2, fds, le))
+      return Skipped;
+    if(fds.size() != 2)
+      return 1;
+
+    const int ctl = socket(AF_INET, SOCK_DGRAM, 0);
+    ifreq ifr;
+    std::memset(&ifr, 0, sizeof(ifr));
+    std::memcpy(ifr.ifr_name, ifname, IFNAMSIZ);
+    auto* addr       = reinterpret_cast< sockaddr_in* >(&ifr.ifr_addr);
+    addr->sin_family = AF_INET;
+    inet_pton(AF_INET, "10.66.0.1", &addr->sin_addr);
+    if(ioctl(ctl, SIOCSIFADDR, &ifr) == -1)
+      return 2;
+    inet_pton(AF_INET, "255.255.255.0", &addr->sin_addr);
+    if(ioctl(ctl, SIOCSIFNETMASK, &ifr) == -1)
+      return 3;
+    if(ioctl(ctl, SIOCGIFFLAGS, &ifr) == -1)
+      return 4;
+    ifr.ifr_flags |= IFF_UP;
+    if(ioctl(ctl, SIOCSIFFLAGS, &ifr) == -1)
+      return 5;
+
+    // out through the tun
+    const int sock = socket(AF_INET, SOCK_DGRAM, 0);
+    sockaddr_in local{};
+    local.sin_family = AF_INET;
+    inet_pton(AF_INET, "10.66.0.1", &local.sin_addr);
+    if(bind(sock, (const sockaddr*)&local, sizeof(local)) == -1)
+      return 6;
+    socklen_t locallen = sizeof(local);
+    getsockname(sock, (sockaddr*)&local, &locallen);
+    sockaddr_in remote{};
+    remote.sin_family = AF_INET;
+    remote.sin_port   = htons(5555);
+    inet_pton(AF_INET, "10.66.0.2", &remote.sin_addr);
+    if(sendto(sock, "hello", 5, 0, (const sockaddr*)&remote, sizeof(remote))
+       != 5)
+      return 7;
+
+    std::vector< byte_t > buf(vnet::MaxReadSize);
+    std::vector< byte_t > scratch;
+    bool found = false;
+    for(int tries = 0; tries < 20 && not found; ++tries)
+    {
+      pollfd pfds[2] = {{fds[0], POLLIN, 0}, {fds[1], POLLIN, 0}};
+      if(poll(pfds, 2, 100) <= 0)
+        continue;
+      for(const auto& pfd : pfds)
+      {
+        if(not(pfd.revents & POLLIN))
+          continue;
+        const auto sz = read(pfd.fd, buf.data(), buf.size());
+        vnet::Header hdr;
+        if(sz <= 0 || not hdr.Decode(buf.data(), sz, le))
+          continue;
+        vnet::Segment(hdr, buf.data() + hdr.SIZE, sz - hdr.SIZE, scratch,
+                      [&](const llarp_buffer_t& pkt) {
+                        const byte_t* ip = pkt.base;
+                        if(pkt.sz != 20 + 8 + 5 || ip[0] != 0x45 || ip[9] != 17
+                           || Get16(ip + 22) != 5555)
+                          return;
+                        const uint16_t l4len = pkt.sz - 20;
+                        found = std::memcmp(ip + 28, "hello", 5) == 0
+                            && Sum(ip + 20, l4len, Pseudo(ip, 17, l4len))
+                                == 0xFFff;
+                      });
+      }
+    }
+    if(not found)
+      return 8;
+
+    // and back in
+    std::vector< byte_t > pkt(20 + 8 + 5, 0);
+    pkt[0] = 0x45;
+    Put16(pkt.data() + 2, pkt.size());
+    pkt[8] = 64;
+    pkt[9] = 17;
+    std::memcpy(pkt.data() + 12, &remote.sin_addr, 4);
+    std::memcpy(pkt.data() + 16, &local.sin_addr, 4);
+    Put16(pkt.data() + 10, ~Sum(pkt.data(), 20));
+    Put16(pkt.data() + 20, 5555);
+    std::memcpy(pkt.data() + 22, &local.sin_port, 2);
+    Put16(pkt.data() + 24, 13);
+    std::memcpy(pkt.data() + 28, "world", 5);
+    Put16(pkt.data() + 26,
+          ~Sum(pkt.data() + 20, 13, Pseudo(pkt.data(), 17, 13)));
+    if(not vnet::Write(fds[1], pkt.data(), pkt.size(), le))
+      return 9;
+    pollfd pfd{sock, POLLIN, 0};
+    char got[16];
+    if(poll(&pfd, 1, 2000) <= 0 || recv(sock, got, sizeof(got), 0) != 5
+       || std::memcmp(got, "world", 5) != 0)
+      return 10;
+    return 0;
+  }
+}  // namespace
+
+TEST_CASE("vnet tun queues carry packets both ways", "[ev][vnet]")
+{
+  const pid_t child = fork();
+  REQUIRE(child != -1);
+  if(child == 0)
+    _exit(TunRoundTrip());
+  int status = 0;
+  REQUIRE(waitpid(child, &status, 0) == child);
+  REQUIRE(WIFEXITED(status));
+  if(WEXITSTATUS(status) == Skipped)
+  {
+    WARN("no network namespace with a tun for us, skipped");
+    return;
+  }
+  REQUIRE(WEXITSTATUS(status) == 0);
+}
+#endif
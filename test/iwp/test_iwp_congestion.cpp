@@ -0,0 +1,240 @@
+#include <iwp/congestion.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+using llarp::iwp::CongestionControl;
+
+namespace
+{
+  /// one way bottleneck with a drop tail queue, a fixed propagation delay
+  /// each way and random loss, stepped one millisecond at a time. the
+  /// sender always has data and resends a message when the rto fires,
+  /// the same way a session does.
+  struct LossyLink
+  {
+    /// bottleneck bytes per millisecond
+    size_t rate;
+    /// one way propagation delay in milliseconds
+    size_t delay;
+    /// bottleneck queue limit in bytes
+    size_t queueLimit;
+    /// chance a message is lost on the wire
+    double loss;
+
+    struct Result
+    {
+      /// unique bytes acked per second
+      double goodput;
+      /// mean rtt of acked messages in milliseconds
+      double rtt;
+      /// messages resent
+      size_t retransmits;
+    };
+
+    Result
+    Run(CongestionControl& cc, llarp_time_t duration,
+        uint64_t seed = 1) const
+    {
+      static constexpr size_t sz = CongestionControl::SegmentSize;
+
+      struct Message
+      {
+        CongestionControl::SendState st;
+        llarp_time_t lastSend = 0s;
+        bool acked            = false;
+      };
+
+      std::mt19937_64 rng(seed);
+      std::uniform_real_distribution< double > coin;
+      std::deque< Message > msgs;
+      /// msgids waiting at or crossing the bottleneck
+      std::deque< size_t > queue;
+      size_t queued = 0;
+      /// (arrival time, msgid) on the wire after the bottleneck
+      std::deque< std::pair< llarp_time_t, size_t > > forward, reverse;
+      /// messages before this are all acked
+      size_t firstUnacked = 0;
+      size_t retransmits  = 0;
+      double rttSum       = 0;
+      size_t rttCount     = 0;
+      double credit       = 0;
+
+      auto transmit = [&](size_t msgid) {
+        if(queued + sz > queueLimit || coin(rng) < loss)
+          return;
+        queue.push_back(msgid);
+        queued += sz;
+      };
+
+      for(llarp_time_t now = 1ms; now <= duration; ++now)
+      {
+        while(not reverse.empty() && reverse.front().first <= now)
+        {
+          auto& msg = msgs[reverse.front().second];
+          reverse.pop_front();
+          if(msg.acked)
+            continue;
+          msg.acked = true;
+          rttSum += (now - msg.st.sentAt).count();
+          ++rttCount;
+          cc.OnAck(msg.st, sz, now);
+        }
+        while(firstUnacked < msgs.size() && msgs[firstUnacked].acked)
+          ++firstUnacked;
+
+        for(size_t msgid = firstUnacked; msgid < msgs.size(); ++msgid)
+        {
+          auto& msg = msgs[msgid];
+          if(msg.acked || now - msg.lastSend < cc.RTO())
+            continue;
+          cc.OnRetransmit(msg.st, sz, now);
+          msg.lastSend = now;
+          ++retransmits;
+          transmit(msgid);
+        }
+
+        while(cc.CanSend(sz, now))
+        {
+          msgs.emplace_back();
+          cc.OnSend(msgs.back().st, sz, now);
+          msgs.back().lastSend = now;
+          transmit(msgs.size() - 1);
+        }
+
+        credit += rate;
+        while(not queue.empty() && credit >= sz)
+        {
+          forward.emplace_back(now + llarp_time_t(delay), queue.front());
+          queue.pop_front();
+          queued -= sz;
+          credit -= sz;
+        }
+        if(queue.empty())
+          credit = std::min(credit, double(sz));
+
+        while(not forward.empty() && forward.front().first <= now)
+        {
+          reverse.emplace_back(now + llarp_time_t(delay),
+                               forward.front().second);
+          forward.pop_front();
+        }
+      }
+      return {(cc.Delivered() * 1000.0) / duration.count(),
+              rttCount ? rttSum / rttCount : 0, retransmits};
+    }
+  };
+
+  LossyLink::Result
+  Run(const char* algo, const LossyLink& link, llarp_time_t duration)
+  {
+    auto cc = CongestionControl::Create(algo);
+    REQUIRE(cc);
+    return link.Run(*cc, duration);
+  }
+}  // namespace
+
+TEST_CASE("congestion control by name", "[iwp][congestion]")
+{
+  REQUIRE(CongestionControl::Create("nope") == nullptr);
+  for(const char* algo : {"cubic", "bbr"})
+  {
+    auto cc = CongestionControl::Create(algo);
+    REQUIRE(cc);
+    REQUIRE(std::string(cc->Name()) == algo);
+    REQUIRE(cc->Window() == CongestionControl::InitialWindow);
+    REQUIRE(cc->RTO() == CongestionControl::InitialRTO);
+  }
+  REQUIRE(CongestionControl::Create(CongestionControl::DefaultAlgorithm));
+}
+
+TEST_CASE("congestion control rtt estimate", "[iwp][congestion]")
+{
+  static constexpr size_t sz = CongestionControl::SegmentSize;
+  auto cc                    = CongestionControl::Create("cubic");
+  CongestionControl::SendState st;
+  cc->OnSend(st, sz, 1000ms);
+  REQUIRE(cc->BytesInFlight() == sz);
+  cc->OnAck(st, sz, 1080ms);
+  REQUIRE(cc->BytesInFlight() == 0);
+  REQUIRE(cc->SmoothedRTT() == 80ms);
+  REQUIRE(cc->MinRTT() == 80ms);
+  REQUIRE(cc->RTO() == 240ms);
+
+  // karn: no rtt sample from a resent message
+  cc->OnSend(st, sz, 2000ms);
+  cc->OnRetransmit(st, sz, 2300ms);
+  cc->OnAck(st, sz, 2310ms);
+  REQUIRE(cc->SmoothedRTT() == 80ms);
+  REQUIRE(cc->Delivered() == 2 * sz);
+
+  // loss halves-ish the window once per round trip
+  const auto window = cc->Window();
+  cc->OnSend(st, sz, 3000ms);
+  cc->OnDrop(sz, 3001ms);
+  const auto reduced = cc->Window();
+  REQUIRE(reduced < window);
+  cc->OnDrop(sz, 3002ms);
+  REQUIRE(cc->Window() == reduced);
+}
+
+TEST_CASE("congestion control fills a clean link", "[iwp][congestion]")
+{
+  const LossyLink link{1000, 20, 64 * 1024, 0};
+  for(const char* algo : {"cubic", "bbr"})
+  {
+    DYNAMIC_SECTION(algo)
+    {
+      const auto result = Run(algo, link, 10s);
+      REQUIRE(result.goodput > 0.9 * link.rate * 1000);
+    }
+  }
+}
+
+TEST_CASE("bbr keeps a deep queue short", "[iwp][congestion]")
+{
+  const LossyLink link{1000, 20, 256 * 1024, 0};
+  const auto cubic = Run("cubic", link, 10s);
+  const auto bbr   = Run("bbr", link, 10s);
+  REQUIRE(bbr.goodput > 0.9 * link.rate * 1000);
+  REQUIRE(bbr.rtt < 2 * (2 * link.delay));
+  REQUIRE(bbr.rtt < cubic.rtt);
+}
+
+TEST_CASE("bbr holds goodput under random loss", "[iwp][congestion]")
+{
+  const LossyLink link{1000, 20, 64 * 1024, 0.01};
+  const auto cubic = Run("cubic", link, 10s);
+  const auto bbr   = Run("bbr", link, 10s);
+  REQUIRE(cubic.goodput > 0);
+  REQUIRE(bbr.goodput > 0.9 * link.rate * 1000);
+  REQUIRE(bbr.goodput > 2 * cubic.goodput);
+}
+
+TEST_CASE("congestion control goodput", "[.][benchmark][iwp][congestion]")
+{
+  std::cout << std::setw(8) << "algo" << std::setw(8) << "loss"
+            << std::setw(8) << "queue" << std::setw(12) << "KiB/s"
+            << std::setw(8) << "rtt" << std::setw(10) << "resends"
+            << std::endl;
+  for(double loss : {0.0, 0.001, 0.01, 0.05})
+  {
+    for(size_t queue : {size_t{16}, size_t{64}, size_t{256}})
+    {
+      const LossyLink link{1000, 20, queue * 1024, loss};
+      for(const char* algo : {"cubic", "bbr"})
+      {
+        const auto result = Run(algo, link, 30s);
+        std::cout << std::setw(8) << algo << std::setw(8) << loss
+                  << std::setw(8) << queue << std::setw(12)
+                  << size_t(result.goodput / 1024) << std::setw(8)
+                  << size_t(result.rtt) << std::setw(10)
+                  << result.retransmits << std::endl;
+      }
+    }
+  }
+}
@@ -0,0 +1,111 @@
+#include <iwp/message_buffer.hpp>
+#include <iwp/pmtu.hpp>
+#include <iwp/session.hpp>
+
+#include <crypto/crypto_libsodium.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <numeric>
+#include <vector>
+
+using namespace llarp::iwp;
+using Packet_t = llarp::ILinkSession::Packet_t;
+
+namespace
+{
+  constexpr size_t BaseSize = FragmentSize + XMITOverhead;
+}  // namespace
+
+TEST_CASE("path mtu search settles on what the path acks", "[iwp][pmtu]")
+{
+  PathMTU mtu{BaseSize};
+  llarp_time_t now = 1000ms;
+  REQUIRE(mtu.Size() == BaseSize);
+
+  // the path carries up to 1400 bytes
+  for(size_t round = 0; round < 16; ++round)
+  {
+    const auto sz = mtu.NextProbe(now);
+    if(sz > 0 && sz <= 1400)
+      mtu.OnProbeAck(sz, now + 50ms);
+    now += PathMTU::ProbeTimeout;
+  }
+  REQUIRE(mtu.Size() == 1400);
+  REQUIRE(mtu.NextProbe(now) == 0);
+  // after a while we look for more room again
+  now += PathMTU::RaiseInterval;
+  REQUIRE(mtu.NextProbe(now) == 1452);
+}
+
+TEST_CASE("path mtu stays at the base size with an old peer", "[iwp][pmtu]")
+{
+  PathMTU mtu{BaseSize};
+  llarp_time_t now = 1000ms;
+  size_t probes    = 0;
+  for(size_t round = 0; round < 16; ++round)
+  {
+    if(mtu.NextProbe(now) > 0)
+      ++probes;
+    now += PathMTU::ProbeTimeout;
+  }
+  REQUIRE(probes == PathMTU::MaxProbes);
+  REQUIRE(mtu.Size() == BaseSize);
+}
+
+TEST_CASE("path mtu falls back on a black hole", "[iwp][pmtu]")
+{
+  PathMTU mtu{BaseSize};
+  const llarp_time_t now = 1000ms;
+  mtu.OnProbeAck(PathMTU::MaxSize, now);
+  REQUIRE(mtu.Size() == PathMTU::MaxSize);
+
+  // one drop in between deliveries is just loss
+  mtu.OnMessageDropped(now);
+  mtu.OnMessageDelivered();
+  mtu.OnMessageDropped(now);
+  REQUIRE(mtu.Size() == PathMTU::MaxSize);
+  mtu.OnMessageDropped(now);
+  REQUIRE(mtu.Size() == BaseSize);
+  REQUIRE(mtu.NextProbe(now + 1s) == 0);
+  REQUIRE(mtu.NextProbe(now + PathMTU::BlackHoleBackoff) > 0);
+}
+
+TEST_CASE("messages round trip at the biggest fragment size", "[iwp][pmtu]")
+{
+  llarp::sodium::CryptoLibSodium crypto;
+  llarp::CryptoManager manager(&crypto);
+  const llarp_time_t now = 1000ms;
+
+  llarp::ILinkSession::Message_t data(3 * MaxFragmentSize - 10);
+  std::iota(data.begin(), data.end(), 0);
+  OutboundMessage out{3, data, now, nullptr};
+  out.m_Sending  = true;
+  out.m_FragSize = MaxFragmentSize;
+  REQUIRE(out.UsesBigFragments());
+  REQUIRE(out.XMIT().size() == PathMTU::MaxSize);
+
+  std::vector< Packet_t > sent;
+  out.FlushUnAcked([&sent](Packet_t pkt) { sent.emplace_back(std::move(pkt)); },
+                   now);
+  REQUIRE(sent.size() == 3);
+
+  InboundMessage in{3, uint16_t(data.size()), out.m_Digest, now,
+                    MaxFragmentSize};
+  for(auto& pkt : sent)
+  {
+    REQUIRE(pkt.size() <= PathMTU::MaxSize);
+    const uint16_t idx = bufbe16toh(pkt.data() + 2 + PacketOverhead);
+    const llarp_buffer_t buf(pkt.data() + PacketOverhead + 12,
+                             pkt.size() - (PacketOverhead + 12));
+    in.HandleData(idx, buf, now);
+  }
+  REQUIRE(in.IsCompleted());
+  REQUIRE(in.Verify());
+
+  auto sack = in.SACKS();
+  const size_t offset = PacketOverhead + CommandOverhead + sizeof(uint64_t);
+  REQUIRE(out.AckRanges(llarp_buffer_t(sack.data() + offset,
+                                       sack.size() - offset)));
+  REQUIRE(out.IsTransmitted());
+}
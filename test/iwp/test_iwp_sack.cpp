@@ -0,0 +1,189 @@
+#include <iwp/message_buffer.hpp>
+#include <iwp/session.hpp>
+
+#include <crypto/crypto_libsodium.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+using namespace llarp::iwp;
+using Packet_t = llarp::ILinkSession::Packet_t;
+
+namespace
+{
+  /// hand a DATA packet to the receiving end of a message
+  void
+  Deliver(InboundMessage& in, Packet_t& pkt, llarp_time_t now)
+  {
+    const uint16_t idx = bufbe16toh(pkt.data() + 2 + PacketOverhead);
+    const llarp_buffer_t buf(pkt.data() + PacketOverhead + 12,
+                             pkt.size() - (PacketOverhead + 12));
+    in.HandleData(idx, buf, now);
+  }
+
+  /// apply the ranges part of a SACK packet
+  bool
+  AckRanges(OutboundMessage& out, Packet_t& sack)
+  {
+    const size_t offset = PacketOverhead + CommandOverhead + sizeof(uint64_t);
+    const llarp_buffer_t ranges(sack.data() + offset, sack.size() - offset);
+    return out.AckRanges(ranges);
+  }
+
+  size_t
+  NumRanges(Packet_t& sack)
+  {
+    return sack[PacketOverhead + CommandOverhead + sizeof(uint64_t)];
+  }
+}  // namespace
+
+TEST_CASE("SACK resends only lost fragments", "[iwp][sack]")
+{
+  llarp::sodium::CryptoLibSodium crypto;
+  llarp::CryptoManager manager(&crypto);
+  const llarp_time_t now = 1000ms;
+
+  llarp::ILinkSession::Message_t data(MaxFragments * FragmentSize - 100);
+  std::iota(data.begin(), data.end(), 0);
+  OutboundMessage out{7, data, now, nullptr};
+  out.m_Sending = true;
+
+  std::vector< Packet_t > sent;
+  auto sendpkt = [&sent](Packet_t pkt) { sent.emplace_back(std::move(pkt)); };
+  REQUIRE(out.FlushUnAcked(sendpkt, now) == data.size());
+  REQUIRE(sent.size() == MaxFragments);
+
+  InboundMessage in{7, uint16_t(data.size()), out.m_Digest, now};
+  std::vector< Packet_t > acks;
+  auto sendack = [&acks](Packet_t pkt) { acks.emplace_back(std::move(pkt)); };
+  Deliver(in, sent[0], now + 20ms);
+  Deliver(in, sent[1], now + 20ms);
+  in.SendACKS(sendack, now + 20ms, true);
+  REQUIRE(acks.back()[PacketOverhead + 1] == Command::eSACK);
+  REQUIRE_FALSE(in.ShouldSendACKS(now + 20ms));
+  // fragment 2 goes missing, so 3 opens a hole and wants a sack sent now
+  Deliver(in, sent[3], now + 20ms);
+  REQUIRE(in.ShouldSendACKS(now + 20ms));
+  for(size_t idx = 4; idx < MaxFragments; ++idx)
+  {
+    if(idx != 5)
+      Deliver(in, sent[idx], now + 20ms);
+  }
+
+  auto sack = in.SACKS();
+  REQUIRE(sack[PacketOverhead + 1] == Command::eSACK);
+  // [0, 2) [3, 5) [6, MaxFragments)
+  REQUIRE(NumRanges(sack) == 3);
+  REQUIRE(AckRanges(out, sack));
+  REQUIRE_FALSE(out.IsTransmitted());
+
+  sent.clear();
+  // inside the reorder window nothing counts as lost yet
+  REQUIRE(out.ResendLost(sendpkt, now + 5ms, 10ms) == 0);
+  REQUIRE(out.ResendLost(sendpkt, now + 40ms, 10ms) == 2 * FragmentSize);
+  REQUIRE(sent.size() == 2);
+  // the resent fragments wait for acks of something sent after them
+  REQUIRE(out.ResendLost(sendpkt, now + 45ms, 10ms) == 0);
+  REQUIRE_FALSE(out.ShouldFlush(now + 80ms, 100ms));
+  REQUIRE(out.ShouldFlush(now + 140ms, 100ms));
+
+  for(auto& pkt : sent)
+    Deliver(in, pkt, now + 60ms);
+  REQUIRE(in.IsCompleted());
+  REQUIRE(in.Verify());
+  REQUIRE(in.m_Data == data);
+
+  auto done = in.SACKS();
+  REQUIRE(NumRanges(done) == 1);
+  REQUIRE(AckRanges(out, done));
+  REQUIRE(out.IsTransmitted());
+  REQUIRE_FALSE(out.ShouldFlush(now + 1s, 100ms));
+}
+
+TEST_CASE("malformed SACK ranges are rejected", "[iwp][sack]")
+{
+  OutboundMessage out;
+  std::vector< byte_t > buf(1 + (MaxSACKRanges + 1) * 4, 0);
+
+  // more ranges than a message can have
+  buf[0] = MaxSACKRanges + 1;
+  REQUIRE_FALSE(out.AckRanges(llarp_buffer_t(buf)));
+  // truncated
+  buf[0] = 2;
+  REQUIRE_FALSE(out.AckRanges(llarp_buffer_t(buf.data(), 5)));
+  // past the last fragment
+  buf[0] = 1;
+  htobe16buf(buf.data() + 1, MaxFragments - 1);
+  htobe16buf(buf.data() + 3, 2);
+  REQUIRE_FALSE(out.AckRanges(llarp_buffer_t(buf)));
+  htobe16buf(buf.data() + 3, 1);
+  REQUIRE(out.AckRanges(llarp_buffer_t(buf)));
+}
+
+TEST_CASE("remotes without SACK get legacy acks", "[iwp][sack]")
+{
+  llarp::sodium::CryptoLibSodium crypto;
+  llarp::CryptoManager manager(&crypto);
+  const llarp_time_t now = 1000ms;
+
+  llarp::ILinkSession::Message_t data(3 * FragmentSize);
+  std::iota(data.begin(), data.end(), 0);
+  OutboundMessage out{9, data, now, nullptr};
+  InboundMessage in{9, uint16_t(data.size()), out.m_Digest, now};
+  std::vector< Packet_t > sent;
+  out.FlushUnAcked([&sent](Packet_t pkt) { sent.emplace_back(std::move(pkt)); },
+                   now);
+  Deliver(in, sent[0], now);
+  Deliver(in, sent[2], now);
+
+  std::vector< Packet_t > acks;
+  in.SendACKS([&acks](Packet_t pkt) { acks.emplace_back(std::move(pkt)); },
+              now, false);
+  REQUIRE(acks.size() == 1);
+  auto& ack = acks[0];
+  REQUIRE(ack[PacketOverhead + 1] == Command::eACKS);
+  REQUIRE(bufbe64toh(ack.data() + PacketOverhead + CommandOverhead) == 9);
+  out.Ack(ack[PacketOverhead + 10]);
+  REQUIRE_FALSE(out.IsTransmitted());
+  Deliver(in, sent[1], now);
+  out.Ack(in.ACKS()[PacketOverhead + 10]);
+  REQUIRE(out.IsTransmitted());
+}
+
+TEST_CASE("the first fragment rides in the xmit only for SACK remotes",
+          "[iwp][sack]")
+{
+  llarp::sodium::CryptoLibSodium crypto;
+  llarp::CryptoManager manager(&crypto);
+  const llarp_time_t now = 1000ms;
+
+  llarp::ILinkSession::Message_t data(3 * FragmentSize - 10);
+  std::iota(data.begin(), data.end(), 0);
+  auto countData = [](std::vector< Packet_t >& pkts) {
+    return std::count_if(pkts.begin(), pkts.end(), [](Packet_t& pkt) {
+      return pkt[PacketOverhead + 1] == Command::eDATA;
+    });
+  };
+
+  // a legacy remote only takes fragments from DATA
+  OutboundMessage legacy{1, data, now, nullptr};
+  std::vector< Packet_t > sent;
+  legacy.Start([&sent](Packet_t pkt) { sent.emplace_back(std::move(pkt)); },
+               now, false);
+  REQUIRE(sent[0][PacketOverhead + 1] == Command::eXMIT);
+  REQUIRE(countData(sent) == 3);
+
+  OutboundMessage out{2, data, now, nullptr};
+  out.m_Sending = true;
+  sent.clear();
+  out.Start([&sent](Packet_t pkt) { sent.emplace_back(std::move(pkt)); }, now,
+            true);
+  REQUIRE(sent[0][PacketOverhead + 1] == Command::eXMIT);
+  REQUIRE(countData(sent) == 2);
+  // the xmit counts as sending the first fragment
+  REQUIRE_FALSE(out.ShouldFlush(now + 50ms, 100ms));
+  REQUIRE(out.ShouldFlush(now + 100ms, 100ms));
+}
@@ -0,0 +1,280 @@
+#include <iwp/window.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+using llarp::iwp::MessageWindow;
+using llarp::iwp::ReplayBitmap;
+
+TEST_CASE("MessageWindow keys messages by msgid", "[iwp][window]")
+{
+  MessageWindow< int, 64 > window;
+  REQUIRE(window.Find(0) == nullptr);
+  for(uint64_t msgid = 100; msgid < 110; ++msgid)
+    REQUIRE(window.Emplace(msgid, int(msgid)) != nullptr);
+  REQUIRE(window.Size() == 10);
+  REQUIRE(*window.Find(105) == 105);
+  // same slot, different msgid
+  REQUIRE(window.Find(105 + window.Capacity()) == nullptr);
+  // already there
+  REQUIRE(window.Emplace(105, 0) == nullptr);
+  REQUIRE(window.Erase(105));
+  REQUIRE_FALSE(window.Erase(105));
+  REQUIRE(window.Find(105) == nullptr);
+  window.EraseIf([](uint64_t msgid, int&) { return msgid % 2 == 0; });
+  REQUIRE(window.Size() == 4);
+  size_t visited = 0;
+  window.ForEach([&visited](uint64_t msgid, int& val) {
+    REQUIRE(uint64_t(val) == msgid);
+    ++visited;
+  });
+  REQUIRE(visited == window.Size());
+}
+
+TEST_CASE("MessageWindow grows up to its max size", "[iwp][window]")
+{
+  MessageWindow< int, 64 > window;
+  for(uint64_t msgid = 0; msgid < 64; ++msgid)
+    REQUIRE(window.Emplace(msgid, int(msgid)) != nullptr);
+  REQUIRE(window.Capacity() == 64);
+  for(uint64_t msgid = 0; msgid < 64; ++msgid)
+    REQUIRE(*window.Find(msgid) == int(msgid));
+
+  // msgid 64 wants the slot msgid 0 holds
+  int val = 64;
+  REQUIRE(window.Emplace(64, std::move(val)) == nullptr);
+  window.EvictFor(64);
+  REQUIRE(window.Find(0) == nullptr);
+  REQUIRE(window.Emplace(64, std::move(val)) != nullptr);
+  REQUIRE(window.Size() == 64);
+}
+
+TEST_CASE("ReplayBitmap remembers recent msgids", "[iwp][window]")
+{
+  ReplayBitmap< 128 > filter;
+  REQUIRE_FALSE(filter.Contains(0));
+  REQUIRE(filter.Insert(5));
+  REQUIRE_FALSE(filter.Insert(5));
+  REQUIRE(filter.Contains(5));
+  // out of order below the highest msgid
+  REQUIRE_FALSE(filter.Contains(3));
+  REQUIRE(filter.Insert(3));
+  REQUIRE(filter.Contains(3));
+  REQUIRE_FALSE(filter.Contains(4));
+  REQUIRE(filter.Count() == 2);
+
+  // sliding forward forgets bits but reports old msgids as seen
+  REQUIRE(filter.Insert(200));
+  REQUIRE(filter.Contains(5));
+  REQUIRE(filter.Contains(4));
+  REQUIRE_FALSE(filter.Contains(150));
+  REQUIRE(filter.Count() == 1);
+  REQUIRE_FALSE(filter.Insert(10));
+
+  // a jump past the whole window clears it
+  REQUIRE(filter.Insert(1000));
+  REQUIRE(filter.Count() == 1);
+  REQUIRE_FALSE(filter.Contains(999));
+}
+
+namespace
+{
+  /// stand in for the per message state a session keeps
+  struct FakeMessage
+  {
+    std::array< uint64_t, 16 > state{};
+    uint64_t acks = 0;
+  };
+
+  enum class Event
+  {
+    Xmit,
+    Data,
+    Ack,
+    Done
+  };
+
+  using Trace_t = std::vector< std::pair< Event, uint64_t > >;
+
+  /// messages go out inFlight at a time, their fragments and acks
+  /// interleaved, with a few replayed xmits of finished messages
+  Trace_t
+  MakeTrace(size_t numMsgs, size_t inFlight, size_t frags)
+  {
+    std::mt19937 rng(7);
+    Trace_t trace;
+    for(uint64_t base = 0; base < numMsgs; base += inFlight)
+    {
+      std::vector< uint64_t > ids;
+      for(uint64_t msgid = base; msgid < base + inFlight; ++msgid)
+      {
+        trace.emplace_back(Event::Xmit, msgid);
+        ids.push_back(msgid);
+      }
+      for(size_t frag = 0; frag < frags; ++frag)
+      {
+        std::shuffle(ids.begin(), ids.end(), rng);
+        for(const auto msgid : ids)
+        {
+          trace.emplace_back(Event::Data, msgid);
+          trace.emplace_back(Event::Ack, msgid);
+        }
+      }
+      for(const auto msgid : ids)
+      {
+        trace.emplace_back(Event::Done, msgid);
+        if(rng() % 20 == 0 && msgid > inFlight)
+          trace.emplace_back(Event::Xmit, msgid - inFlight);
+      }
+    }
+    return trace;
+  }
+
+  /// session bookkeeping before the windows
+  struct MapBookkeeping
+  {
+    std::unordered_map< uint64_t, FakeMessage > tx;
+    std::unordered_map< uint64_t, FakeMessage > rx;
+    std::unordered_map< uint64_t, uint64_t > replay;
+    std::unordered_set< uint64_t > macks;
+
+    void
+    Xmit(uint64_t msgid)
+    {
+      if(replay.find(msgid) != replay.end())
+      {
+        macks.emplace(msgid);
+        return;
+      }
+      tx.emplace(msgid, FakeMessage{});
+      rx.emplace(msgid, FakeMessage{});
+    }
+
+    void
+    Data(uint64_t msgid)
+    {
+      auto itr = rx.find(msgid);
+      if(itr != rx.end())
+        itr->second.acks++;
+    }
+
+    void
+    Ack(uint64_t msgid)
+    {
+      auto itr = tx.find(msgid);
+      if(itr != tx.end())
+        itr->second.acks++;
+    }
+
+    void
+    Done(uint64_t msgid)
+    {
+      rx.erase(msgid);
+      if(replay.emplace(msgid, msgid).second)
+        macks.emplace(msgid);
+      for(const auto acked : macks)
+        tx.erase(acked);
+      macks.clear();
+    }
+  };
+
+  /// session bookkeeping with the windows
+  struct WindowBookkeeping
+  {
+    MessageWindow< FakeMessage, 1024 > tx;
+    MessageWindow< FakeMessage, 1024 > rx;
+    ReplayBitmap< 4096 > replay;
+    std::vector< uint64_t > macks;
+
+    void
+    Xmit(uint64_t msgid)
+    {
+      if(replay.Contains(msgid))
+      {
+        macks.emplace_back(msgid);
+        return;
+      }
+      tx.Emplace(msgid, FakeMessage{});
+      rx.Emplace(msgid, FakeMessage{});
+    }
+
+    void
+    Data(uint64_t msgid)
+    {
+      auto* msg = rx.Find(msgid);
+      if(msg)
+        msg->acks++;
+    }
+
+    void
+    Ack(uint64_t msgid)
+    {
+      auto* msg = tx.Find(msgid);
+      if(msg)
+        msg->acks++;
+    }
+
+    void
+    Done(uint64_t msgid)
+    {
+      rx.Erase(msgid);
+      if(replay.Insert(msgid))
+        macks.emplace_back(msgid);
+      for(const auto acked : macks)
+        tx.Erase(acked);
+      macks.clear();
+    }
+  };
+
+  template < typename Bookkeeping >
+  double
+  Replay(const Trace_t& trace, size_t rounds)
+  {
+    using Clock_t    = std::chrono::steady_clock;
+    const auto start = Clock_t::now();
+    for(size_t round = 0; round < rounds; ++round)
+    {
+      Bookkeeping book;
+      for(const auto& ev : trace)
+      {
+        switch(ev.first)
+        {
+          case Event::Xmit:
+            book.Xmit(ev.second);
+            break;
+          case Event::Data:
+            book.Data(ev.second);
+            break;
+          case Event::Ack:
+            book.Ack(ev.second);
+            break;
+          case Event::Done:
+            book.Done(ev.second);
+            break;
+        }
+      }
+      REQUIRE(book.macks.empty());
+    }
+    const std::chrono::duration< double > dlt = Clock_t::now() - start;
+    return (trace.size() * rounds) / dlt.count();
+  }
+}  // namespace
+
+TEST_CASE("iwp session bookkeeping trace replay", "[.][benchmark][iwp]")
+{
+  const auto trace = MakeTrace(200000, 64, 4);
+  const auto maps  = Replay< MapBookkeeping >(trace, 5);
+  const auto flat  = Replay< WindowBookkeeping >(trace, 5);
+  std::cout << "unordered_map: " << maps << " events/s" << std::endl;
+  std::cout << "window: " << flat << " events/s" << std::endl;
+  REQUIRE(maps > 0);
+  REQUIRE(flat > 0);
+}
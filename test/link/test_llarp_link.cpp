@@ -1,5 +1,6 @@
 #include <crypto/crypto_libsodium.hpp>
 #include <ev/ev.h>
+#include <iwp/congestion.hpp>
 #include <iwp/iwp.hpp>
 #include <llarp_test.hpp>
 #include <iwp/iwp.hpp>
@@ -257,7 +258,10 @@ TEST_F(LinkLayerTest, TestIWP)
       [&](RouterID router) { ASSERT_EQ(router, Alice.GetRouterID()); },
 
       // PumpDoneHandler
-      []() {});
+      []() {},
+
+      // congestion control
+      iwp::CongestionControl::DefaultAlgorithm);
 
   Bob.link = iwp::NewInboundLink(
       // KeyManager
@@ -314,7 +318,10 @@ TEST_F(LinkLayerTest, TestIWP)
       [&](RouterID router) { ASSERT_EQ(router, Alice.GetRouterID()); },
 
       // PumpDoneHandler
-      []() {});
+      []() {},
+
+      // congestion control
+      iwp::CongestionControl::DefaultAlgorithm);
 
   ASSERT_TRUE(Alice.Start(m_logic, netLoop, AlicePort));
   ASSERT_TRUE(Bob.Start(m_logic, netLoop, BobPort));
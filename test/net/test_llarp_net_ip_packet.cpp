@@ -0,0 +1,120 @@
+#include <net/ip.hpp>
+#include <util/codel.hpp>
+#include <util/packet_pool.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+using llarp::net::IPPacket;
+
+namespace
+{
+  /// a minimal ipv4 header from 10.0.0.1 to 10.0.0.2
+  std::vector< byte_t >
+  MakeV4(size_t sz)
+  {
+    std::vector< byte_t > data(sz, 0);
+    data[0]  = 0x45;
+    data[9]  = 17;
+    data[12] = 10;
+    data[15] = 1;
+    data[16] = 10;
+    data[19] = 2;
+    return data;
+  }
+
+  /// queue everything with the same timestamp so codel never drops
+  struct PutNothing
+  {
+    void
+    operator()(IPPacket& pkt) const
+    {
+      pkt.timestamp = 0s;
+    }
+  };
+
+  using PacketQueue_t =
+      llarp::util::CoDelQueue< IPPacket, IPPacket::GetTime, PutNothing,
+                               IPPacket::CompareOrder >;
+}  // namespace
+
+TEST_CASE("ip packets share their bytes until written", "[net]")
+{
+  const auto data = MakeV4(100);
+  IPPacket pkt;
+  REQUIRE(pkt.Load(llarp_buffer_t(data)));
+
+  IPPacket copy(pkt);
+  REQUIRE(copy.buf == pkt.buf);
+  REQUIRE(copy.dstv4() == pkt.dstv4());
+
+  // the writer gets its own copy, the other keeps the old bytes
+  copy.UpdateIPv4Address(llarp::nuint32_t{0}, llarp::nuint32_t{0});
+  REQUIRE(copy.buf != pkt.buf);
+  REQUIRE(copy.sz == pkt.sz);
+  REQUIRE(pkt.dstv4() == llarp::ipaddr_ipv4_bits(10, 0, 0, 2));
+  REQUIRE(copy.dstv4() == llarp::huint32_t{0});
+
+  // moves hand over the bytes as they are
+  const auto* bytes = pkt.buf;
+  IPPacket moved(std::move(pkt));
+  REQUIRE(moved.buf == bytes);
+  REQUIRE(pkt.buf == nullptr);
+  REQUIRE(pkt.sz == 0);
+
+  REQUIRE_FALSE(pkt.Load(llarp_buffer_t(MakeV4(IPPacket::MaxSize + 1))));
+}
+
+TEST_CASE("codel queue lets go of the packets it passes on", "[net]")
+{
+  const auto data        = MakeV4(1400);
+  const auto outstanding = llarp::util::PacketPool::GetStats().bytesOutstanding;
+  {
+    PacketQueue_t queue("test", PutNothing{}, {});
+    for(size_t idx = 0; idx < 10; ++idx)
+    {
+      IPPacket pkt;
+      REQUIRE(pkt.Load(llarp_buffer_t(data)));
+      queue.Emplace(std::move(pkt));
+    }
+    // a packet the filter turns down goes back to the pool right away
+    REQUIRE_FALSE(queue.EmplaceIf([](IPPacket&) { return false; }));
+    REQUIRE(queue.Size() == 10);
+
+    std::vector< IPPacket > sent;
+    queue.Process([&sent](IPPacket& pkt) { sent.emplace_back(std::move(pkt)); });
+    REQUIRE(sent.size() == 10);
+    for(const auto& pkt : sent)
+      REQUIRE(pkt.sz == data.size());
+  }
+  REQUIRE(llarp::util::PacketPool::GetStats().bytesOutstanding == outstanding);
+}
+
+TEST_CASE("ip packet queue throughput", "[.][benchmark][net]")
+{
+  static constexpr size_t rounds = 2000;
+  static constexpr size_t burst  = 512;
+  using Clock_t                  = std::chrono::steady_clock;
+
+  const auto data = MakeV4(1400);
+  PacketQueue_t queue("bench", PutNothing{}, {});
+  size_t passed    = 0;
+  const auto start = Clock_t::now();
+  for(size_t round = 0; round < rounds; ++round)
+  {
+    for(size_t idx = 0; idx < burst; ++idx)
+    {
+      IPPacket pkt;
+      pkt.Load(llarp_buffer_t(data));
+      queue.Emplace(std::move(pkt));
+    }
+    queue.Process([&passed](IPPacket&) { ++passed; });
+  }
+  REQUIRE(passed == rounds * burst);
+  const std::chrono::duration< double, std::nano > dlt = Clock_t::now() - start;
+  std::cout << "queue of " << sizeof(PacketQueue_t) << " bytes, "
+            << dlt.count() / (rounds * burst) << " ns/packet" << std::endl;
+}
@@ -1,8 +1,19 @@
 #include <catch2/catch.hpp>
 #include "config/config.hpp"
 
+#include <crypto/crypto.hpp>
+#include <crypto/crypto_libsodium.hpp>
 #include <router_contact.hpp>
 #include <nodedb.hpp>
+#include <dht/kademlia.hpp>
+#include <util/thread/thread_pool.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <thread>
 
 TEST_CASE("FindClosestTo returns correct number of elements", "[nodedb][dht]")
 {
@@ -63,3 +74,298 @@ TEST_CASE("FindClosestTo returns properly ordered set", "[nodedb][dht]")
   REQUIRE(c.pubkey == results[0].pubkey);
   REQUIRE(b.pubkey == results[1].pubkey);
 }
+
+static llarp::RouterContact
+MakeRouter(const llarp::PubKey &pk, bool isPublic, bool isExit)
+{
+  llarp::RouterContact rc;
+  rc.pubkey = pk;
+  if(isPublic)
+  {
+    rc.routerVersion = llarp::RouterVersion{};
+    rc.addrs.emplace_back();
+  }
+  if(isExit)
+    rc.exits.emplace_back();
+  return rc;
+}
+
+TEST_CASE("random hop selection only picks allowed routers", "[nodedb]")
+{
+  llarp_nodedb nodeDB(nullptr, "");
+  llarp::RouterContact rc;
+  REQUIRE_FALSE(nodeDB.select_random_hop_excluding(rc, {}));
+
+  // routers 1 to 4 are public, 5 and 6 are not, 4 and 6 are exits
+  for(byte_t idx = 1; idx <= 6; ++idx)
+  {
+    llarp::PubKey pk;
+    pk.Fill(idx);
+    nodeDB.Insert(MakeRouter(pk, idx <= 4, idx % 2 == 0 && idx >= 4));
+  }
+
+  std::set< llarp::RouterID > exclude;
+  for(byte_t idx = 1; idx <= 3; ++idx)
+  {
+    llarp::RouterID pk;
+    pk.Fill(idx);
+    exclude.insert(pk);
+  }
+  for(size_t round = 0; round < 100; ++round)
+  {
+    REQUIRE(nodeDB.select_random_hop_excluding(rc, exclude));
+    REQUIRE(rc.pubkey[0] == 4);
+    REQUIRE(nodeDB.select_random_exit(rc));
+    REQUIRE((rc.pubkey[0] == 4 || rc.pubkey[0] == 6));
+  }
+
+  // router 4 stops being a public exit when it is updated
+  llarp::PubKey four;
+  four.Fill(4);
+  nodeDB.Insert(MakeRouter(four, false, false));
+  REQUIRE_FALSE(nodeDB.select_random_hop_excluding(rc, exclude));
+  for(size_t round = 0; round < 100; ++round)
+  {
+    REQUIRE(nodeDB.select_random_hop_excluding(rc, {}));
+    REQUIRE(rc.pubkey[0] <= 3);
+    REQUIRE(nodeDB.select_random_exit(rc));
+    REQUIRE(rc.pubkey[0] == 6);
+  }
+}
+
+TEST_CASE("readers keep their snapshot while writers publish", "[nodedb]")
+{
+  llarp_nodedb nodeDB(nullptr, "");
+  llarp::PubKey pks[4];
+  for(byte_t idx = 0; idx < 4; ++idx)
+    pks[idx].Fill(idx + 1);
+  for(byte_t idx = 0; idx < 3; ++idx)
+    nodeDB.Insert(MakeRouter(pks[idx], true, false));
+
+  const auto before = nodeDB.GetSnapshot();
+  nodeDB.Insert(MakeRouter(pks[3], true, true));
+  REQUIRE(nodeDB.Remove(pks[0]));
+  REQUIRE_FALSE(nodeDB.Remove(pks[0]));
+
+  REQUIRE(before->size() == 3);
+  REQUIRE(before->Has(pks[0]));
+  REQUIRE_FALSE(before->Has(pks[3]));
+  REQUIRE(before->PickExit() == nullptr);
+
+  const auto after = nodeDB.GetSnapshot();
+  REQUIRE(after->size() == 3);
+  REQUIRE_FALSE(after->Has(pks[0]));
+  REQUIRE(after->PickExit()->pubkey == pks[3]);
+  // routers nobody touched are shared between the two
+  REQUIRE(before->Get(pks[1]) == after->Get(pks[1]));
+
+  // dropping wins over putting the same router in one batch
+  REQUIRE_FALSE(
+      after->With({MakeRouter(pks[0], true, false)}, {pks[0]})->Has(pks[0]));
+}
+
+TEST_CASE("nodedb read contention", "[.][benchmark][nodedb]")
+{
+  static constexpr size_t numRCs = 10000;
+  static constexpr auto runTime  = std::chrono::milliseconds(500);
+
+  std::mt19937 rng(42);
+  std::vector< llarp::PubKey > pks(numRCs);
+  llarp_nodedb nodeDB(nullptr, "");
+  for(auto &pk : pks)
+  {
+    for(auto &b : pk)
+      b = rng();
+    nodeDB.Insert(MakeRouter(pk, true, false));
+  }
+
+  for(const size_t numReaders : {1, 2, 4, 8})
+  {
+    std::atomic_bool running{true};
+    std::atomic_size_t reads{0};
+    std::atomic_size_t writes{0};
+    std::atomic_size_t failed{0};
+    std::vector< std::thread > threads;
+    for(size_t idx = 0; idx < numReaders; ++idx)
+    {
+      threads.emplace_back([&, idx]() {
+        std::mt19937 r(idx);
+        size_t n = 0;
+        llarp::RouterContact rc;
+        while(running)
+        {
+          // what the dht and path builder ask of the nodedb
+          const llarp::dht::Key_t key{pks[r() % numRCs]};
+          if(not nodeDB.Get(pks[r() % numRCs], rc)
+             || nodeDB.FindClosestTo(key, 4).size() != 4
+             || not nodeDB.select_random_hop_excluding(rc, {}))
+            ++failed;
+          n += 3;
+        }
+        reads += n;
+      });
+    }
+    // gossip keeps updating the routers we already have
+    threads.emplace_back([&]() {
+      std::mt19937 r(1337);
+      size_t n = 0;
+      while(running)
+      {
+        nodeDB.Insert(MakeRouter(pks[r() % numRCs], true, false));
+        ++n;
+      }
+      writes += n;
+    });
+    std::this_thread::sleep_for(runTime);
+    running = false;
+    for(auto &thread : threads)
+      thread.join();
+    REQUIRE(failed == 0);
+    const double secs = std::chrono::duration< double >(runTime).count();
+    std::cout << numReaders << " readers: " << reads / secs << " reads/s with "
+              << writes / secs << " writes/s" << std::endl;
+  }
+}
+
+TEST_CASE("FindClosestTo latency", "[.][benchmark][nodedb][dht]")
+{
+  static constexpr size_t lookups = 10000;
+  using Clock_t                   = std::chrono::steady_clock;
+
+  std::mt19937 rng(42);
+  auto randomKey = [&rng]() {
+    llarp::dht::Key_t key;
+    for(auto &b : key)
+      b = rng();
+    return key;
+  };
+
+  for(const size_t numRCs : {10000, 30000, 100000})
+  {
+    llarp_nodedb nodeDB(nullptr, "");
+    for(size_t idx = 0; idx < numRCs; ++idx)
+    {
+      llarp::RouterContact rc;
+      rc.pubkey = llarp::PubKey{randomKey().as_array()};
+      nodeDB.Insert(rc);
+    }
+
+    // what FindClosestTo did before it had an index
+    std::vector< llarp::RouterContact > all;
+    nodeDB.visit([&all](const llarp::RouterContact &rc) -> bool {
+      all.push_back(rc);
+      return true;
+    });
+    std::vector< const llarp::RouterContact * > sorted;
+
+    auto measure = [&](const char *name, auto &&func) {
+      const auto start = Clock_t::now();
+      for(size_t idx = 0; idx < lookups; ++idx)
+        func(randomKey());
+      const std::chrono::duration< double, std::micro > dlt =
+          Clock_t::now() - start;
+      std::cout << numRCs << " rcs " << name << ": " << dlt.count() / lookups
+                << " us/lookup" << std::endl;
+    };
+    measure("partial_sort", [&](const llarp::dht::Key_t &key) {
+      sorted.clear();
+      for(const auto &rc : all)
+        sorted.push_back(&rc);
+      std::partial_sort(sorted.begin(), sorted.begin() + 4, sorted.end(),
+                        [compare = llarp::dht::XorMetric{key}](
+                            auto *a, auto *b) { return compare(*a, *b); });
+    });
+    measure("index", [&](const llarp::dht::Key_t &key) {
+      REQUIRE(nodeDB.FindClosestTo(key, 4).size() == 4);
+    });
+  }
+}
+
+TEST_CASE("SelectHops throughput", "[.][benchmark][nodedb][path]")
+{
+  static constexpr size_t paths   = 20000;
+  static constexpr size_t numHops = 4;
+  using Clock_t                   = std::chrono::steady_clock;
+
+  std::mt19937 rng(42);
+  for(const size_t numRCs : {1000, 10000, 100000})
+  {
+    llarp_nodedb nodeDB(nullptr, "");
+    for(size_t idx = 0; idx < numRCs; ++idx)
+    {
+      llarp::PubKey pk;
+      for(auto &b : pk)
+        b = rng();
+      // a few routers are clients and a few more run exits
+      nodeDB.Insert(MakeRouter(pk, idx % 10 != 0, idx % 20 == 1));
+    }
+
+    // what Builder::SelectHops asks of the nodedb after the first hop
+    const auto start = Clock_t::now();
+    for(size_t path = 0; path < paths; ++path)
+    {
+      std::set< llarp::RouterID > exclude;
+      llarp::RouterContact hop;
+      for(size_t idx = 1; idx < numHops; ++idx)
+      {
+        REQUIRE(nodeDB.select_random_hop_excluding(hop, exclude));
+        exclude.emplace(hop.pubkey);
+      }
+    }
+    const std::chrono::duration< double > dlt = Clock_t::now() - start;
+    std::cout << numRCs << " rcs: " << paths / dlt.count() << " paths/s"
+              << std::endl;
+  }
+}
+
+TEST_CASE("old nodedb files move over until the store has them",
+          "[nodedb]")
+{
+  llarp::sodium::CryptoLibSodium crypto;
+  llarp::CryptoManager manager(&crypto);
+  std::random_device rd;
+  const auto dir = fs::temp_directory_path()
+      / ("llarp-nodedb-" + std::to_string(rd()));
+  REQUIRE(llarp_nodedb::ensure_dir(dir.string().c_str()));
+  auto disk = std::make_shared< llarp::thread::ThreadPool >(1, 64, "disk");
+  REQUIRE(disk->start());
+
+  std::vector< std::string > files;
+  {
+    llarp_nodedb nodeDB(disk, dir.string());
+    for(size_t idx = 0; idx < 3; ++idx)
+    {
+      llarp::SecretKey identity;
+      crypto.identity_keygen(identity);
+      llarp::RouterContact rc;
+      rc.enckey = identity.toPublic();
+      REQUIRE(rc.Sign(identity));
+      files.emplace_back(nodeDB.getRCFilePath(rc.pubkey));
+      fs::create_directories(fs::path(files.back()).parent_path());
+      REQUIRE(rc.Write(files.back().c_str()));
+    }
+  }
+  // we died after making the store but before anything went into it
+  {
+    llarp::RCStore store(dir / llarp::RCStore::FileName);
+    REQUIRE(store.Open());
+  }
+
+  {
+    llarp_nodedb nodeDB(disk, dir.string());
+    REQUIRE(nodeDB.LoadAll() == 3);
+    REQUIRE(nodeDB.num_loaded() == 3);
+  }
+  disk->drain();
+  for(const auto &file : files)
+    REQUIRE_FALSE(fs::exists(file));
+  {
+    llarp::RCStore store(dir / llarp::RCStore::FileName);
+    REQUIRE(store.Open());
+    REQUIRE(store.size() == 3);
+  }
+
+  disk->stop();
+  std::error_code ec;
+  fs::remove_all(dir, ec);
+}
@@ -0,0 +1,193 @@
+#include <rc_store.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <random>
+
+namespace
+{
+  struct TempDir
+  {
+    fs::path path;
+
+    TempDir()
+    {
+      std::random_device rd;
+      path = fs::temp_directory_path()
+          / ("llarp-rc-store-" + std::to_string(rd()));
+      fs::create_directories(path);
+    }
+
+    ~TempDir()
+    {
+      std::error_code ec;
+      fs::remove_all(path, ec);
+    }
+  };
+
+  llarp::RouterContact
+  MakeRC(byte_t fill, uint64_t updated)
+  {
+    llarp::RouterContact rc;
+    rc.pubkey.Fill(fill);
+    rc.last_updated = std::chrono::milliseconds(updated);
+    return rc;
+  }
+
+  /// newest rc of every router in the store keyed by the id's first byte
+  std::map< byte_t, uint64_t >
+  Contents(llarp::RCStore& store)
+  {
+    std::map< byte_t, uint64_t > found;
+    store.ForEach([&](const llarp::RouterID& pk, const llarp_buffer_t& rcbuf) {
+      llarp::RouterContact rc;
+      llarp_buffer_t buf(rcbuf.base, rcbuf.sz);
+      REQUIRE(rc.BDecode(&buf));
+      REQUIRE(rc.pubkey == pk);
+      found[pk[0]] = rc.last_updated.count();
+    });
+    return found;
+  }
+}  // namespace
+
+TEST_CASE("rc store keeps the newest record of every router", "[nodedb]")
+{
+  TempDir dir;
+  const auto file = dir.path / llarp::RCStore::FileName;
+  {
+    llarp::RCStore store(file);
+    REQUIRE(store.Open());
+    REQUIRE(store.size() == 0);
+    REQUIRE(store.Append({MakeRC(1, 10), MakeRC(2, 20), MakeRC(3, 30)}, {}));
+    const llarp::RouterID three(MakeRC(3, 0).pubkey);
+    REQUIRE(store.Append({MakeRC(2, 21)}, {three}));
+    REQUIRE(Contents(store) == std::map< byte_t, uint64_t >{{1, 10}, {2, 21}});
+  }
+
+  // everything survives a restart
+  llarp::RCStore store(file);
+  REQUIRE(store.Open());
+  REQUIRE(store.size() == 2);
+  REQUIRE(Contents(store) == std::map< byte_t, uint64_t >{{1, 10}, {2, 21}});
+
+  // dropping a router that is not there writes nothing
+  const auto before = fs::file_size(file);
+  const llarp::RouterID missing(MakeRC(9, 0).pubkey);
+  REQUIRE(store.Append({}, {missing}));
+  REQUIRE(fs::file_size(file) == before);
+}
+
+TEST_CASE("rc store cuts off a torn record", "[nodedb]")
+{
+  TempDir dir;
+  const auto file = dir.path / llarp::RCStore::FileName;
+  {
+    llarp::RCStore store(file);
+    REQUIRE(store.Append({MakeRC(1, 10), MakeRC(2, 20)}, {}));
+  }
+  // lose the tail of the last record as if we died while appending it
+  const auto full = fs::file_size(file);
+  fs::resize_file(file, full - 5);
+
+  llarp::RCStore store(file);
+  REQUIRE(store.Open());
+  REQUIRE(store.size() == 1);
+  REQUIRE(fs::file_size(file) < full - 5);
+  REQUIRE(store.Append({MakeRC(3, 30)}, {}));
+  REQUIRE(Contents(store).size() == 2);
+}
+
+TEST_CASE("rc store compacts replaced records away", "[nodedb]")
+{
+  TempDir dir;
+  const auto file = dir.path / llarp::RCStore::FileName;
+  llarp::RCStore store(file);
+  REQUIRE(store.Open());
+
+  uint64_t updated = 0;
+  while(not store.NeedsCompaction())
+  {
+    std::vector< llarp::RouterContact > put;
+    for(byte_t fill = 1; fill <= 16; ++fill)
+      put.emplace_back(MakeRC(fill, ++updated));
+    REQUIRE(store.Append(put, {}));
+  }
+  const auto before = fs::file_size(file);
+  REQUIRE(store.Compact());
+  REQUIRE_FALSE(store.NeedsCompaction());
+  REQUIRE(fs::file_size(file) < before / 2);
+
+  auto found = Contents(store);
+  REQUIRE(found.size() == 16);
+  REQUIRE(found[16] == updated);
+
+  // a store that is not ours gets moved aside rather than read
+  store.Close();
+  {
+    std::ofstream garbage(file.string(), std::ios::trunc);
+    garbage << "not a store";
+  }
+  REQUIRE(store.Open());
+  REQUIRE(store.size() == 0);
+  REQUIRE(fs::exists(file.string() + ".bad"));
+}
+
+TEST_CASE("rc store load time", "[.][benchmark][nodedb]")
+{
+  static constexpr size_t numRCs = 10000;
+  using Clock_t                  = std::chrono::steady_clock;
+
+  TempDir dir;
+  std::mt19937 rng(42);
+  std::vector< llarp::RouterContact > rcs;
+  for(size_t idx = 0; idx < numRCs; ++idx)
+  {
+    llarp::RouterContact rc;
+    for(auto& b : rc.pubkey)
+      b = rng();
+    rc.last_updated = std::chrono::milliseconds(idx);
+    rcs.emplace_back(rc);
+    const auto fpath = dir.path / (rc.pubkey.ToHex() + ".signed");
+    REQUIRE(rc.Write(fpath.string().c_str()));
+  }
+  {
+    llarp::RCStore store(dir.path / llarp::RCStore::FileName);
+    REQUIRE(store.Append(rcs, {}));
+  }
+
+  auto measure = [&](const char* name, auto&& func) {
+    const auto start = Clock_t::now();
+    const size_t num = func();
+    const std::chrono::duration< double, std::milli > dlt =
+        Clock_t::now() - start;
+    REQUIRE(num == numRCs);
+    std::cout << name << ": " << dlt.count() << " ms for " << num << " rcs"
+              << std::endl;
+  };
+  measure("one file per rc", [&]() {
+    size_t num = 0;
+    llarp::util::IterDir(dir.path, [&](const fs::path& f) -> bool {
+      llarp::RouterContact rc;
+      if(f.extension().string() == ".signed" && rc.Read(f.string().c_str()))
+        ++num;
+      return true;
+    });
+    return num;
+  });
+  measure("store", [&]() {
+    size_t num = 0;
+    llarp::RCStore store(dir.path / llarp::RCStore::FileName);
+    REQUIRE(store.Open());
+    store.ForEach([&](const llarp::RouterID&, const llarp_buffer_t& rcbuf) {
+      llarp::RouterContact rc;
+      llarp_buffer_t buf(rcbuf.base, rcbuf.sz);
+      if(rc.BDecode(&buf))
+        ++num;
+    });
+    return num;
+  });
+}
@@ -0,0 +1,246 @@
+#include <path/path_context.hpp>
+
+#include <crypto/crypto.hpp>
+#include <crypto/crypto_libsodium.hpp>
+#include <link/session.hpp>
+#include <messages/relay_commit.hpp>
+#include <router/router.hpp>
+#include <util/logging/logger.hpp>
+#include <util/thread/thread_pool.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+using namespace llarp;
+
+namespace
+{
+  /// just enough of a link session for a LRCM to come from
+  struct FakeSession final : public ILinkSession
+  {
+    std::shared_ptr< ILinkSession >
+    BorrowSelf() override
+    {
+      return nullptr;
+    }
+
+    void
+    Pump() override
+    {
+    }
+
+    void Tick(llarp_time_t) override
+    {
+    }
+
+    bool
+    SendMessageBuffer(Message_t, CompletionHandler) override
+    {
+      return false;
+    }
+
+    void
+    Start() override
+    {
+    }
+
+    void
+    Close() override
+    {
+    }
+
+    bool
+    SendKeepAlive() override
+    {
+      return false;
+    }
+
+    bool
+    IsEstablished() const override
+    {
+      return true;
+    }
+
+    bool TimedOut(llarp_time_t) const override
+    {
+      return false;
+    }
+
+    PubKey
+    GetPubKey() const override
+    {
+      return PubKey{};
+    }
+
+    bool
+    IsInbound() const override
+    {
+      return true;
+    }
+
+    Addr
+    GetRemoteEndpoint() const override
+    {
+      return Addr{};
+    }
+
+    RouterContact
+    GetRemoteRC() const override
+    {
+      return RouterContact{};
+    }
+
+    size_t
+    SendQueueBacklog() const override
+    {
+      return 0;
+    }
+
+    ILinkLayer*
+    GetLinkLayer() const override
+    {
+      return nullptr;
+    }
+
+    bool
+    RenegotiateSession() override
+    {
+      return false;
+    }
+
+    bool
+    ShouldPing() const override
+    {
+      return false;
+    }
+
+    util::StatusObject
+    ExtractStatus() const override
+    {
+      return {};
+    }
+  };
+
+  struct CommitBatchTest
+  {
+    sodium::CryptoLibSodium crypto;
+    CryptoManager manager{&crypto};
+    std::shared_ptr< thread::ThreadPool > worker;
+    Router router;
+    FakeSession session;
+
+    CommitBatchTest()
+        : worker(std::make_shared< thread::ThreadPool >(4, 4096, "test"))
+        , router(worker, nullptr, nullptr)
+    {
+      worker->start();
+      crypto.encryption_keygen(router._encryption);
+    }
+
+    ~CommitBatchTest()
+    {
+      worker->drain();
+      worker->stop();
+    }
+
+    path::PathContext&
+    context()
+    {
+      return router.pathContext();
+    }
+
+    /// a LRCM whose first frame is for our router. the record inside has
+    /// no path ids so the hop gets refused right after the decrypt.
+    LR_CommitMessage
+    MakeCommit()
+    {
+      LR_CommitMessage msg;
+      msg.session = &session;
+      LR_CommitRecord record;
+      record.nextHop.Fill(1);
+      record.tunnelNonce.Randomize();
+      auto& frame = msg.frames[0];
+      auto buf    = frame.Buffer();
+      buf->cur    = buf->base + EncryptedFrameOverheadSize;
+      REQUIRE(record.BEncode(buf));
+      SecretKey commkey;
+      crypto.encryption_keygen(commkey);
+      REQUIRE(frame.EncryptInPlace(commkey, router._encryption.toPublic()));
+      return msg;
+    }
+
+    void
+    WaitForBatches(uint64_t num)
+    {
+      while(context().CommitBatchesDone() < num)
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+  };
+}  // namespace
+
+TEST_CASE("LRCM decrypts go out in batches", "[path]")
+{
+  CommitBatchTest test;
+  std::atomic< size_t > decrypted{0};
+  auto decrypt = [&decrypted]() { ++decrypted; };
+
+  // nothing goes out until the batch is full
+  for(size_t idx = 1; idx < path::PathContext::MaxCommitBatch; ++idx)
+    test.context().QueueCommitDecrypt(decrypt);
+  REQUIRE(test.context().CommitBatchesDone() == 0);
+  REQUIRE(decrypted == 0);
+  test.context().QueueCommitDecrypt(decrypt);
+  test.WaitForBatches(1);
+  REQUIRE(decrypted == path::PathContext::MaxCommitBatch);
+
+  // or until it gets flushed
+  test.context().FlushCommitDecrypts();
+  for(size_t idx = 0; idx < 3; ++idx)
+    test.context().QueueCommitDecrypt(decrypt);
+  test.context().FlushCommitDecrypts();
+  test.WaitForBatches(2);
+  REQUIRE(decrypted == path::PathContext::MaxCommitBatch + 3);
+  REQUIRE(test.context().CommitBatchesDone() == 2);
+}
+
+TEST_CASE("LRCM decrypt batching benchmark", "[.][benchmark][path]")
+{
+  static constexpr size_t commits = 4000;
+  using Clock_t                   = std::chrono::steady_clock;
+
+  CommitBatchTest test;
+  const auto level = LogContext::Instance().curLevel;
+  SetLogLevel(eLogNone);
+  std::vector< LR_CommitMessage > msgs;
+  for(size_t idx = 0; idx < commits; ++idx)
+    msgs.emplace_back(test.MakeCommit());
+
+  uint64_t batches = test.context().CommitBatchesDone();
+  auto measure     = [&](const char* name, bool batched) {
+    const auto start = Clock_t::now();
+    for(const auto& msg : msgs)
+    {
+      REQUIRE(test.context().HandleRelayCommit(msg));
+      // flushing every commit is one worker job each, as before batching
+      if(not batched)
+        test.context().FlushCommitDecrypts();
+    }
+    test.context().FlushCommitDecrypts();
+    batches += batched
+        ? (commits + path::PathContext::MaxCommitBatch - 1)
+            / path::PathContext::MaxCommitBatch
+        : commits;
+    test.WaitForBatches(batches);
+    const std::chrono::duration< double, std::micro > dlt =
+        Clock_t::now() - start;
+    std::cout << name << ": " << dlt.count() / commits << " us/LRCM, last batch "
+              << test.context().LastCommitBatchLatency() << " us" << std::endl;
+  };
+  measure("one job per LRCM", false);
+  measure("batched", true);
+  SetLogLevel(level);
+}
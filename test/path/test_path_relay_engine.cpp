@@ -0,0 +1,111 @@
+#include <path/relay_engine.hpp>
+
+#include <crypto/crypto.hpp>
+#include <crypto/crypto_libsodium.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <numeric>
+#include <random>
+
+using llarp::PathID_t;
+using llarp::path::RelayEngine;
+
+namespace
+{
+  std::vector< PathID_t >
+  MakePaths(size_t num)
+  {
+    std::mt19937 rng(7);
+    std::vector< PathID_t > paths(num);
+    for(auto& path : paths)
+    {
+      for(auto& b : path)
+        b = rng();
+    }
+    return paths;
+  }
+}  // namespace
+
+TEST_CASE("relay engine keeps the work of a path in order", "[path]")
+{
+  static constexpr size_t jobsPerPath = 50;
+  const auto paths = MakePaths(64);
+
+  RelayEngine engine(4, 4096);
+  REQUIRE(engine.Start());
+  // only the lane of a path touches its log so it needs no lock
+  std::vector< std::vector< size_t > > logs(paths.size());
+  for(size_t seq = 0; seq < jobsPerPath; ++seq)
+  {
+    for(size_t idx = 0; idx < paths.size(); ++idx)
+    {
+      auto& log = logs[idx];
+      REQUIRE(engine.AddJob(paths[idx], 10, [&log, seq]() {
+        log.emplace_back(seq);
+      }));
+    }
+  }
+  engine.Stop();
+  REQUIRE_FALSE(engine.AddJob(paths[0], 10, []() {}));
+
+  std::vector< size_t > expect(jobsPerPath);
+  std::iota(expect.begin(), expect.end(), 0);
+  for(const auto& log : logs)
+    REQUIRE(log == expect);
+
+  const auto bytes = engine.RelayedBytes();
+  REQUIRE(bytes.size() == 4);
+  REQUIRE(std::accumulate(bytes.begin(), bytes.end(), uint64_t{0})
+          == paths.size() * jobsPerPath * 10);
+  for(const auto& path : paths)
+    REQUIRE(engine.LaneFor(path) == engine.LaneFor(path));
+}
+
+TEST_CASE("relay engine throughput", "[.][benchmark][path]")
+{
+  static constexpr size_t numPaths      = 4096;
+  static constexpr size_t batchesOnPath = 4;
+  static constexpr size_t msgsInBatch   = 8;
+  static constexpr size_t msgSize       = 1024;
+  using Clock_t                         = std::chrono::steady_clock;
+
+  llarp::sodium::CryptoLibSodium crypto;
+  llarp::CryptoManager manager(&crypto);
+  const auto paths = MakePaths(numPaths);
+  llarp::SharedSecret key;
+  key.Randomize();
+
+  for(const size_t numLanes : {1, 2, 4, 8})
+  {
+    std::vector< std::vector< byte_t > > bufs(
+        numPaths, std::vector< byte_t >(msgsInBatch * msgSize));
+    RelayEngine engine(numLanes, numPaths * batchesOnPath);
+    REQUIRE(engine.Start());
+    const auto start = Clock_t::now();
+    for(size_t batch = 0; batch < batchesOnPath; ++batch)
+    {
+      for(size_t idx = 0; idx < numPaths; ++idx)
+      {
+        auto& buf = bufs[idx];
+        engine.AddJob(paths[idx], buf.size(), [&buf, &key]() {
+          llarp::TunnelNonce nonce;
+          for(size_t msg = 0; msg < msgsInBatch; ++msg)
+          {
+            const llarp_buffer_t chunk(buf.data() + msg * msgSize, msgSize);
+            llarp::CryptoManager::instance()->xchacha20(chunk, key, nonce);
+          }
+        });
+      }
+    }
+    engine.Stop();
+    const std::chrono::duration< double > dlt = Clock_t::now() - start;
+    const auto bytes                          = engine.RelayedBytes();
+    const double total = std::accumulate(bytes.begin(), bytes.end(), 0.0);
+    const double mbits = total * 8 / 1e6 / dlt.count();
+    std::cout << numLanes << " lanes: " << mbits << " Mbit/s, "
+              << mbits / numLanes << " Mbit/s per lane" << std::endl;
+  }
+}
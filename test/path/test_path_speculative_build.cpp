@@ -0,0 +1,195 @@
+#include <path/pathbuilder.hpp>
+
+#include <crypto/crypto.hpp>
+#include <crypto/crypto_libsodium.hpp>
+#include <path/path.hpp>
+#include <router/router.hpp>
+#include <util/thread/logic.hpp>
+#include <util/thread/thread_pool.hpp>
+
+#include <catch2/catch.hpp>
+
+using namespace llarp;
+
+namespace
+{
+  /// a builder that makes its paths without asking the network
+  struct TestBuilder final : public path::Builder
+  {
+    std::vector< path::Path_ptr > started;
+
+    TestBuilder(AbstractRouter* r) : path::Builder(r, 2, 3)
+    {
+      // one round of builds per test, however long it takes
+      buildIntervalLimit = 1h;
+    }
+
+    path::PathSet_ptr
+    GetSelf() override
+    {
+      return nullptr;
+    }
+
+    std::string
+    Name() const override
+    {
+      return "test";
+    }
+
+    bool
+    ShouldBundleRC() const override
+    {
+      return false;
+    }
+
+    void
+    HandlePathDied(path::Path_ptr) override
+    {
+    }
+
+    bool
+    SelectHop(llarp_nodedb*, const std::set< RouterID >&, RouterContact& cur,
+              size_t, path::PathRole) override
+    {
+      cur.pubkey.Randomize();
+      return true;
+    }
+
+   protected:
+    path::Path_ptr
+    StartBuild(const std::vector< RouterContact >& hops,
+               path::PathRole roles) override
+    {
+      lastBuild = Now();
+      auto path = std::make_shared< path::Path >(hops, this, roles, "test");
+      AddPath(path);
+      started.emplace_back(path);
+      return path;
+    }
+  };
+
+  struct SpeculativeBuildTest
+  {
+    sodium::CryptoLibSodium crypto;
+    CryptoManager manager{&crypto};
+    std::shared_ptr< thread::ThreadPool > worker;
+    std::shared_ptr< Logic > logic;
+    Router router;
+    util::Mutex m_JobsMutex;
+    std::vector< std::function< void(void) > > m_Jobs GUARDED_BY(m_JobsMutex);
+
+    SpeculativeBuildTest()
+        : worker(std::make_shared< thread::ThreadPool >(1, 1024, "test"))
+        , logic(std::make_shared< Logic >())
+        , router(worker, nullptr, logic)
+    {
+      worker->start();
+      // logic calls wait here, running them would need links to send on
+      logic->SetQueuer([this](std::function< void(void) > job) {
+        util::Lock lock(m_JobsMutex);
+        m_Jobs.emplace_back(std::move(job));
+      });
+      std::function< void(void) > setID;
+      {
+        util::Lock lock(m_JobsMutex);
+        setID = std::move(m_Jobs.back());
+        m_Jobs.clear();
+      }
+      setID();
+    }
+
+    ~SpeculativeBuildTest()
+    {
+      worker->drain();
+      worker->stop();
+    }
+
+    /// logic calls sent our way once the worker is done
+    size_t
+    PendingLogic()
+    {
+      worker->drain();
+      util::Lock lock(m_JobsMutex);
+      return m_Jobs.size();
+    }
+
+    /// what a confirm and the first latency reply do to a path
+    static void
+    Establish(const path::Path_ptr& path)
+    {
+      path->EnterState(path::ePathEstablished, time_now_ms());
+      path->intro.latency = 10ms;
+    }
+  };
+}  // namespace
+
+TEST_CASE("only builders given a budget build speculatively", "[path]")
+{
+  SpeculativeBuildTest test;
+  TestBuilder builder(&test.router);
+  builder.Tick(time_now_ms());
+  REQUIRE(builder.started.size() == 1);
+
+  TestBuilder endpoint(&test.router);
+  endpoint.buildBudget = 4;
+  endpoint.Tick(time_now_ms());
+  REQUIRE(endpoint.started.size() == 4);
+  REQUIRE(endpoint.NumInStatus(path::ePathBuilding) == 4);
+}
+
+TEST_CASE("first speculative builds to finish win", "[path]")
+{
+  SpeculativeBuildTest test;
+  TestBuilder builder(&test.router);
+  builder.buildBudget = 4;
+  builder.Tick(time_now_ms());
+  REQUIRE(builder.started.size() == 4);
+  const auto paths = builder.started;
+
+  // one winner is not enough to give up on the rest
+  SpeculativeBuildTest::Establish(paths[3]);
+  builder.Tick(time_now_ms());
+  REQUIRE(builder.NumInStatus(path::ePathBuilding) == 3);
+
+  SpeculativeBuildTest::Establish(paths[1]);
+  builder.Tick(time_now_ms());
+  REQUIRE(builder.started.size() == 4);
+  REQUIRE(paths[1]->IsReady());
+  REQUIRE(paths[3]->IsReady());
+  REQUIRE(paths[0]->Status() == path::ePathIgnore);
+  REQUIRE(paths[2]->Status() == path::ePathIgnore);
+  REQUIRE(builder.NumInStatus(path::ePathBuilding) == 0);
+  REQUIRE(builder.NumInStatus(path::ePathEstablished) == 2);
+  // the stragglers are not held against their hops
+  REQUIRE(builder.CurrentBuildStats().fails == 0);
+  REQUIRE(builder.CurrentBuildStats().timeouts == 0);
+}
+
+TEST_CASE("speculative builds that lose are closed", "[path]")
+{
+  SpeculativeBuildTest test;
+  TestBuilder builder(&test.router);
+  builder.buildBudget = 2;
+  const auto now = time_now_ms();
+  builder.Tick(now);
+  REQUIRE(builder.started.size() == 2);
+  const auto winner = builder.started[0];
+  const auto loser  = builder.started[1];
+  SpeculativeBuildTest::Establish(winner);
+  builder.Tick(now);
+  REQUIRE(loser->Status() == path::ePathIgnore);
+
+  // it waits for its build to come back rather than going away
+  REQUIRE_FALSE(loser->Expired(now));
+  REQUIRE(loser->Expired(loser->buildStarted + path::build_timeout));
+
+  // built late, it sends a close up the path and never becomes usable
+  const auto pending = test.PendingLogic();
+  REQUIRE(loser->HandlePathConfirmMessage(&test.router));
+  REQUIRE(test.PendingLogic() == pending + 1);
+  REQUIRE_FALSE(loser->IsReady());
+  REQUIRE(builder.NumInStatus(path::ePathEstablished) == 1);
+
+  // paths we never gave up on still ignore an unwarranted confirm
+  REQUIRE_FALSE(winner->HandlePathConfirmMessage(&test.router));
+}
@@ -0,0 +1,185 @@
+#include <path/transit_hop.hpp>
+
+#include <crypto/crypto.hpp>
+#include <crypto/crypto_libsodium.hpp>
+#include <path/path_context.hpp>
+#include <router/router.hpp>
+#include <util/thread/logic.hpp>
+#include <util/thread/thread_pool.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+
+using namespace llarp;
+
+namespace
+{
+  /// a transit hop that keeps what it would have sent on
+  struct RecordingHop final : public path::TransitHop
+  {
+    UpstreamQueue_t upstream;
+    DownstreamQueue_t downstream;
+
+   protected:
+    void
+    HandleAllUpstream(UpstreamQueue_t cells, AbstractRouter*) override
+    {
+      for(auto& cell : cells)
+        upstream.emplace_back(std::move(cell));
+    }
+
+    void
+    HandleAllDownstream(DownstreamQueue_t cells, AbstractRouter*) override
+    {
+      for(auto& cell : cells)
+        downstream.emplace_back(std::move(cell));
+    }
+  };
+
+  struct TransitHopTest
+  {
+    static constexpr size_t numMsgs = 16;
+    static constexpr size_t msgSize = 512;
+
+    sodium::CryptoLibSodium crypto;
+    CryptoManager manager{&crypto};
+    std::shared_ptr< thread::ThreadPool > worker;
+    std::shared_ptr< Logic > logic;
+    Router router;
+    std::shared_ptr< RecordingHop > hop;
+    util::Mutex m_JobsMutex;
+    std::vector< std::function< void(void) > > m_Jobs GUARDED_BY(m_JobsMutex);
+
+    TransitHopTest()
+        : worker(std::make_shared< thread::ThreadPool >(1, 1024, "test"))
+        , logic(std::make_shared< Logic >())
+        , router(worker, nullptr, logic)
+        , hop(std::make_shared< RecordingHop >())
+    {
+      worker->start();
+      // logic calls run on the test thread when it asks for them
+      logic->SetQueuer([this](std::function< void(void) > job) {
+        util::Lock lock(m_JobsMutex);
+        m_Jobs.emplace_back(std::move(job));
+      });
+      RunLogic();
+      hop->info.txID.Randomize();
+      hop->info.rxID.Randomize();
+      hop->pathKey.Randomize();
+      hop->nonceXOR.Randomize();
+      REQUIRE(router.pathContext().StartRelaying(2));
+    }
+
+    ~TransitHopTest()
+    {
+      router.pathContext().StopRelaying();
+      worker->drain();
+      worker->stop();
+    }
+
+    void
+    RunLogic()
+    {
+      std::vector< std::function< void(void) > > jobs;
+      {
+        util::Lock lock(m_JobsMutex);
+        jobs = std::move(m_Jobs);
+        m_Jobs.clear();
+      }
+      for(const auto& job : jobs)
+        job();
+    }
+
+    /// wait for the lanes to run everything queued and hand it to logic
+    void
+    Finish()
+    {
+      router.pathContext().StopRelaying();
+      RunLogic();
+    }
+
+    /// bytes relayed over all lanes
+    uint64_t
+    RelayedBytes() const
+    {
+      uint64_t bytes = 0;
+      const auto status = router.pathContext().ExtractRelayStatus();
+      for(const auto& lane : status["relayedBytes"])
+        bytes += lane.get< uint64_t >();
+      return bytes;
+    }
+  };
+}  // namespace
+
+TEST_CASE("transit hop flushes queued upstream traffic to its lane", "[path]")
+{
+  TransitHopTest test;
+  std::vector< byte_t > data(TransitHopTest::msgSize, 'x');
+  TunnelNonce nonce;
+  for(size_t idx = 0; idx < TransitHopTest::numMsgs; ++idx)
+  {
+    nonce.Randomize();
+    REQUIRE(test.hop->HandleUpstream(llarp_buffer_t(data), nonce,
+                                     &test.router));
+  }
+  test.hop->FlushUpstream(&test.router);
+  // nothing left to flush
+  test.hop->FlushUpstream(&test.router);
+  test.Finish();
+
+  REQUIRE(test.hop->upstream.size() == TransitHopTest::numMsgs);
+  REQUIRE(test.RelayedBytes()
+          == TransitHopTest::numMsgs * TransitHopTest::msgSize);
+}
+
+TEST_CASE("transit hop does one onion layer each way", "[path]")
+{
+  TransitHopTest test;
+  auto crypto = CryptoManager::instance();
+  std::vector< std::vector< byte_t > > sent;
+  std::vector< TunnelNonce > nonces;
+  uint64_t bytes = 0;
+  for(size_t idx = 0; idx < TransitHopTest::numMsgs; ++idx)
+  {
+    std::vector< byte_t > data(TransitHopTest::msgSize + idx);
+    crypto->randbytes(data.data(), data.size());
+    TunnelNonce nonce;
+    nonce.Randomize();
+    REQUIRE(test.hop->HandleUpstream(llarp_buffer_t(data), nonce,
+                                     &test.router));
+    REQUIRE(test.hop->HandleDownstream(llarp_buffer_t(data), nonce,
+                                       &test.router));
+    bytes += 2 * data.size();
+    sent.emplace_back(std::move(data));
+    nonces.emplace_back(nonce);
+  }
+  test.hop->FlushUpstream(&test.router);
+  test.hop->FlushDownstream(&test.router);
+  test.Finish();
+
+  REQUIRE(test.hop->upstream.size() == TransitHopTest::numMsgs);
+  REQUIRE(test.hop->downstream.size() == TransitHopTest::numMsgs);
+  for(size_t idx = 0; idx < TransitHopTest::numMsgs; ++idx)
+  {
+    // the same layer either way, only the path id it goes out on differs
+    auto expect = sent[idx];
+    REQUIRE(crypto->xchacha20(llarp_buffer_t(expect), test.hop->pathKey,
+                              nonces[idx]));
+    TunnelNonce nextNonce = nonces[idx];
+    nextNonce ^= test.hop->nonceXOR;
+
+    const auto& up = test.hop->upstream[idx];
+    REQUIRE(up.pathid == test.hop->info.txID);
+    REQUIRE(up.Y == nextNonce);
+    REQUIRE(up.size() == expect.size());
+    REQUIRE(std::equal(expect.begin(), expect.end(), up.data()));
+
+    const auto& down = test.hop->downstream[idx];
+    REQUIRE(down.pathid == test.hop->info.rxID);
+    REQUIRE(down.Y == nextNonce);
+    REQUIRE(down.size() == expect.size());
+    REQUIRE(std::equal(expect.begin(), expect.end(), down.data()));
+  }
+  REQUIRE(test.RelayedBytes() == bytes);
+}
@@ -0,0 +1,142 @@
+#include <crypto/crypto.hpp>
+#include <crypto/crypto_libsodium.hpp>
+#include <service/identity.hpp>
+#include <service/protocol.hpp>
+#include <util/bencode.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <string>
+
+using namespace llarp;
+
+namespace
+{
+  struct ProtocolFrameTest
+  {
+    sodium::CryptoLibSodium crypto;
+    CryptoManager manager{&crypto};
+    service::Identity ident;
+    SharedSecret key;
+    service::ProtocolMessage msg;
+
+    ProtocolFrameTest()
+    {
+      ident.RegenerateKeys();
+      key.Randomize();
+      msg.tag.Randomize();
+      msg.sender = ident.pub;
+      std::vector< byte_t > payload(1024, 'x');
+      msg.PutBuffer(llarp_buffer_t(payload));
+    }
+
+    service::ProtocolFrame
+    MakeFrame() const
+    {
+      service::ProtocolFrame frame;
+      frame.T = msg.tag;
+      frame.N.Randomize();
+      return frame;
+    }
+  };
+}  // namespace
+
+TEST_CASE("protocol frames authenticated with the session key",
+          "[service]")
+{
+  ProtocolFrameTest test;
+  auto frame = test.MakeFrame();
+  REQUIRE(frame.EncryptAndMac(test.msg, test.key));
+  REQUIRE(frame.Z.IsZero());
+  REQUIRE(frame.VerifyMac(test.key));
+
+  // M survives the wire
+  std::array< byte_t, service::MAX_PROTOCOL_MESSAGE_SIZE > tmp;
+  llarp_buffer_t buf(tmp);
+  REQUIRE(frame.BEncode(&buf));
+  buf.sz  = buf.cur - buf.base;
+  buf.cur = buf.base;
+  service::ProtocolFrame decoded;
+  REQUIRE(decoded.BDecode(&buf));
+  REQUIRE(decoded == frame);
+  REQUIRE(decoded.VerifyMac(test.key));
+  service::ProtocolMessage msg;
+  REQUIRE(decoded.DecryptPayloadInto(test.key, msg));
+  REQUIRE(msg.payload == test.msg.payload);
+
+  // any other key or a changed frame fails
+  SharedSecret other;
+  other.Randomize();
+  REQUIRE_FALSE(decoded.VerifyMac(other));
+  decoded.F.Randomize();
+  REQUIRE_FALSE(decoded.VerifyMac(test.key));
+
+  // signed frames carry no mac
+  REQUIRE(frame.EncryptAndSign(test.msg, test.key, test.ident));
+  REQUIRE(frame.M.IsZero());
+  REQUIRE_FALSE(frame.VerifyMac(test.key));
+  REQUIRE(frame.Verify(test.ident.pub));
+}
+
+TEST_CASE("protocol capabilities survive the wire", "[service]")
+{
+  service::ProtocolCapabilities caps;
+  caps.flags = service::LocalCapabilities;
+  std::array< byte_t, 64 > tmp;
+  llarp_buffer_t buf(tmp);
+  REQUIRE(caps.BEncode(&buf));
+  buf.sz  = buf.cur - buf.base;
+  buf.cur = buf.base;
+  service::ProtocolCapabilities decoded;
+  REQUIRE(decoded.BDecode(&buf));
+  REQUIRE(decoded.flags & service::eCapMacFrames);
+
+  // bits and keys of later capabilities do not get in the way
+  const std::string later("d1:A1:C1:ci7e1:zi1ee");
+  llarp_buffer_t laterBuf(later.data(), later.size());
+  REQUIRE(decoded.BDecode(&laterBuf));
+  REQUIRE(decoded.flags == 7);
+
+  // older endpoints put random noise in control messages
+  std::string noise("noise");
+  llarp_buffer_t noiseBuf(noise.data(), noise.size());
+  REQUIRE_FALSE(decoded.BDecode(&noiseBuf));
+}
+
+TEST_CASE("protocol frame signature against mac", "[.][benchmark][service]")
+{
+  static constexpr size_t frames = 2000;
+  using Clock_t                  = std::chrono::steady_clock;
+
+  ProtocolFrameTest test;
+  auto measure = [&](const char* name, auto seal, auto open) {
+    const auto start = Clock_t::now();
+    for(size_t idx = 0; idx < frames; ++idx)
+    {
+      auto frame = test.MakeFrame();
+      REQUIRE(seal(frame));
+      REQUIRE(open(frame));
+    }
+    const std::chrono::duration< double > dlt = Clock_t::now() - start;
+    std::cout << name << ": " << frames / dlt.count() << " frames/s"
+              << std::endl;
+  };
+  measure(
+      "sign and verify",
+      [&](service::ProtocolFrame& frame) {
+        return frame.EncryptAndSign(test.msg, test.key, test.ident);
+      },
+      [&](service::ProtocolFrame& frame) {
+        return frame.Verify(test.ident.pub);
+      });
+  measure(
+      "mac",
+      [&](service::ProtocolFrame& frame) {
+        return frame.EncryptAndMac(test.msg, test.key);
+      },
+      [&](service::ProtocolFrame& frame) {
+        return frame.VerifyMac(test.key);
+      });
+}
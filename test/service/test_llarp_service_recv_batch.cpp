@@ -0,0 +1,191 @@
+#include <service/endpoint.hpp>
+
+#include <crypto/crypto.hpp>
+#include <crypto/crypto_libsodium.hpp>
+#include <router/router.hpp>
+#include <util/logging/logger.hpp>
+#include <util/thread/logic.hpp>
+#include <util/thread/thread_pool.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <numeric>
+
+using namespace llarp;
+
+namespace
+{
+  /// an endpoint that only keeps the seqno of the messages it gets
+  struct RecvEndpoint final : public service::Endpoint
+  {
+    std::vector< uint64_t > seqnos;
+
+    RecvEndpoint(AbstractRouter* r) : service::Endpoint("test", r, nullptr)
+    {
+      m_DataHandler = this;
+    }
+
+    bool
+    HandleDataMessage(path::Path_ptr, const PathID_t,
+                      std::shared_ptr< service::ProtocolMessage > msg) override
+    {
+      seqnos.emplace_back(msg->seqno);
+      return true;
+    }
+
+    bool
+    HandleInboundPacket(const service::ConvoTag, const llarp_buffer_t&,
+                        service::ProtocolType) override
+    {
+      return true;
+    }
+
+    path::PathSet_ptr
+    GetSelf() override
+    {
+      return nullptr;
+    }
+
+    bool
+    SupportsV6() const override
+    {
+      return false;
+    }
+  };
+
+  struct RecvBatchTest
+  {
+    sodium::CryptoLibSodium crypto;
+    CryptoManager manager{&crypto};
+    std::shared_ptr< thread::ThreadPool > worker;
+    std::shared_ptr< Logic > logic;
+    Router router;
+    RecvEndpoint endpoint;
+    service::Identity remote;
+    service::ConvoTag tag;
+    SharedSecret key;
+    path::Path_ptr path;
+    util::Mutex m_JobsMutex;
+    std::vector< std::function< void(void) > > m_Jobs GUARDED_BY(m_JobsMutex);
+
+    RecvBatchTest()
+        : worker(std::make_shared< thread::ThreadPool >(4, 4096, "test"))
+        , logic(std::make_shared< Logic >())
+        , router(worker, nullptr, logic)
+        , endpoint(&router)
+        , path(std::make_shared< path::Path >(
+              std::vector< RouterContact >(1), nullptr, 0, "test"))
+    {
+      worker->start();
+      // logic calls run on the test thread when it asks for them
+      logic->SetQueuer([this](std::function< void(void) > job) {
+        util::Lock lock(m_JobsMutex);
+        m_Jobs.emplace_back(std::move(job));
+      });
+      RunLogic();
+      remote.RegenerateKeys();
+      tag.Randomize();
+      key.Randomize();
+      endpoint.PutSenderFor(tag, remote.pub, true);
+      endpoint.PutCachedSessionKeyFor(tag, key);
+    }
+
+    ~RecvBatchTest()
+    {
+      worker->drain();
+      worker->stop();
+    }
+
+    void
+    RunLogic()
+    {
+      std::vector< std::function< void(void) > > jobs;
+      {
+        util::Lock lock(m_JobsMutex);
+        jobs = std::move(m_Jobs);
+        m_Jobs.clear();
+      }
+      for(const auto& job : jobs)
+        job();
+    }
+
+    service::ProtocolFrame
+    MakeFrame(uint64_t seqno)
+    {
+      service::ProtocolMessage msg;
+      msg.tag    = tag;
+      msg.seqno  = seqno;
+      msg.sender = remote.pub;
+      std::vector< byte_t > payload(1024, 'x');
+      msg.PutBuffer(llarp_buffer_t(payload));
+      service::ProtocolFrame frame;
+      frame.T = tag;
+      frame.N.Randomize();
+      REQUIRE(frame.EncryptAndMac(msg, key));
+      return frame;
+    }
+
+    /// pump until all of num messages came through
+    void
+    WaitFor(size_t num)
+    {
+      while(endpoint.seqnos.size() < num)
+      {
+        RunLogic();
+        endpoint.Pump(endpoint.Now());
+      }
+    }
+  };
+}  // namespace
+
+TEST_CASE("frames of a convo come through batches in order", "[service]")
+{
+  static constexpr size_t numFrames = 200;
+  RecvBatchTest test;
+  for(size_t idx = 0; idx < numFrames; ++idx)
+  {
+    REQUIRE(test.endpoint.HandleHiddenServiceFrame(test.path,
+                                                   test.MakeFrame(idx)));
+    // batches of every size, which can finish in any order
+    if(idx % 7 == 0 || idx % 11 == 0)
+      test.endpoint.Pump(test.endpoint.Now());
+  }
+  test.WaitFor(numFrames);
+  std::vector< uint64_t > expect(numFrames);
+  std::iota(expect.begin(), expect.end(), 0);
+  REQUIRE(test.endpoint.seqnos == expect);
+}
+
+TEST_CASE("hidden service frame batching benchmark", "[.][benchmark][service]")
+{
+  static constexpr size_t numFrames = 4000;
+  static constexpr size_t perTick   = 32;
+  using Clock_t                     = std::chrono::steady_clock;
+
+  RecvBatchTest test;
+  const auto level = LogContext::Instance().curLevel;
+  SetLogLevel(eLogNone);
+  std::vector< service::ProtocolFrame > frames;
+  for(size_t idx = 0; idx < numFrames; ++idx)
+    frames.emplace_back(test.MakeFrame(idx));
+
+  auto measure = [&](const char* name, size_t batchSize) {
+    test.endpoint.seqnos.clear();
+    const auto start = Clock_t::now();
+    for(size_t idx = 0; idx < numFrames; ++idx)
+    {
+      REQUIRE(test.endpoint.HandleHiddenServiceFrame(test.path, frames[idx]));
+      if((idx + 1) % batchSize == 0)
+        test.endpoint.Pump(test.endpoint.Now());
+    }
+    test.WaitFor(numFrames);
+    const std::chrono::duration< double > dlt = Clock_t::now() - start;
+    std::cout << name << ": " << numFrames / dlt.count() << " frames/s"
+              << std::endl;
+  };
+  measure("one batch per frame", 1);
+  measure("batched", perTick);
+  SetLogLevel(level);
+}
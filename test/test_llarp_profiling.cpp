@@ -0,0 +1,97 @@
+#include <crypto/crypto.hpp>
+#include <crypto/crypto_libsodium.hpp>
+#include <path/path.hpp>
+#include <profiling.hpp>
+#include <util/bencode.hpp>
+
+#include <catch2/catch.hpp>
+
+using namespace llarp;
+
+namespace
+{
+  RouterContact
+  MakeHop(char name)
+  {
+    RouterContact rc;
+    rc.pubkey.Fill(name);
+    return rc;
+  }
+
+  path::Path_ptr
+  MakePath(const std::vector< char >& names)
+  {
+    std::vector< RouterContact > hops;
+    for(const auto name : names)
+      hops.emplace_back(MakeHop(name));
+    return std::make_shared< path::Path >(hops, nullptr, 0, "test");
+  }
+
+  /// how often out of 2000 picks between fast and slow fast wins
+  double
+  FastShare(Profiling& profiling, const RouterContact& fast,
+            const RouterContact& slow)
+  {
+    static constexpr size_t picks = 2000;
+    size_t wins                   = 0;
+    for(size_t idx = 0; idx < picks; ++idx)
+    {
+      if(profiling.PickHop({slow, fast}) == 1)
+        ++wins;
+    }
+    return double(wins) / picks;
+  }
+}  // namespace
+
+TEST_CASE("router profiles smooth latency", "[profiling]")
+{
+  RouterProfile profile;
+  const double unknown = profile.HopScore();
+  profile.AddLatency(80ms);
+  REQUIRE(profile.latency == 80ms);
+  profile.AddLatency(160ms);
+  REQUIRE(profile.latency == 90ms);
+  REQUIRE(profile.HopScore() > unknown);
+
+  // it survives a save and load
+  std::array< byte_t, RouterProfile::MaxSize > tmp;
+  llarp_buffer_t buf(tmp);
+  REQUIRE(profile.BEncode(&buf));
+  buf.sz  = buf.cur - buf.base;
+  buf.cur = buf.base;
+  RouterProfile loaded;
+  REQUIRE(bencode_decode_dict(loaded, &buf));
+  REQUIRE(loaded.latency == profile.latency);
+}
+
+TEST_CASE("hop picks favour measured fast routers", "[profiling]")
+{
+  sodium::CryptoLibSodium crypto;
+  CryptoManager manager(&crypto);
+
+  Profiling profiling;
+  profiling.SetHopRandomness(0);
+  const auto fast = MakeHop('f');
+  const auto slow = MakeHop('s');
+  // every hop gets an even share of the round trip
+  profiling.MarkPathLatency(MakePath({'f', 'a', 'b'}).get(), 60ms);
+  profiling.MarkPathLatency(MakePath({'s', 'c', 'd'}).get(), 1500ms);
+
+  // 100 / 120 against 100 / 600 makes fast five times as likely
+  const double weighted = FastShare(profiling, fast, slow);
+  REQUIRE(weighted > 0.75);
+  REQUIRE(weighted < 0.92);
+
+  // a failing fast router loses its edge
+  for(size_t idx = 0; idx < 8; ++idx)
+    profiling.MarkHopFail(fast.pubkey);
+  REQUIRE(FastShare(profiling, fast, slow) < weighted);
+
+  // the randomness floor ignores the profiles altogether
+  profiling.SetHopRandomness(100);
+  const double random = FastShare(profiling, fast, slow);
+  REQUIRE(random > 0.4);
+  REQUIRE(random < 0.6);
+
+  REQUIRE(profiling.PickHop({fast}) == 0);
+}
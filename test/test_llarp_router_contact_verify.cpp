@@ -0,0 +1,90 @@
+#include <crypto/crypto.hpp>
+#include <crypto/crypto_libsodium.hpp>
+#include <router_contact.hpp>
+#include <util/thread/thread_pool.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <chrono>
+#include <iostream>
+
+using namespace llarp;
+
+namespace
+{
+  struct SignedRCs
+  {
+    sodium::CryptoLibSodium crypto;
+    CryptoManager manager{&crypto};
+    std::vector< RouterContact > rcs;
+
+    explicit SignedRCs(size_t num)
+    {
+      for(size_t idx = 0; idx < num; ++idx)
+      {
+        SecretKey identity;
+        crypto.identity_keygen(identity);
+        RouterContact rc;
+        rc.enckey = identity.toPublic();
+        rc.SetNick("rc" + std::to_string(idx));
+        REQUIRE(rc.Sign(identity));
+        rcs.emplace_back(rc);
+      }
+    }
+  };
+}  // namespace
+
+TEST_CASE("rcs verify in parallel batches", "[rc][crypto]")
+{
+  SignedRCs signed_rcs(200);
+  auto& rcs = signed_rcs.rcs;
+  // break a few of them, one after its signature was already checked
+  REQUIRE(rcs[7].VerifySignature());
+  rcs[7].SetNick("tampered");
+  rcs[42].signature.Randomize();
+  rcs[199].last_updated += 1s;
+
+  thread::ThreadPool workers(4, 64, "verify");
+  REQUIRE(workers.start());
+  for(auto* pool : {&workers, static_cast< thread::ThreadPool* >(nullptr)})
+  {
+    // the second round hits the verified cache for the good ones
+    const auto valid = VerifyRCs(rcs, time_now_ms(), pool);
+    REQUIRE(valid.size() == rcs.size());
+    for(size_t idx = 0; idx < rcs.size(); ++idx)
+    {
+      const bool broken = idx == 7 || idx == 42 || idx == 199;
+      REQUIRE(bool(valid[idx]) != broken);
+    }
+  }
+  workers.stop();
+}
+
+TEST_CASE("rc verification throughput", "[.][benchmark][rc][crypto]")
+{
+  static constexpr size_t numRCs = 2000;
+  using Clock_t                  = std::chrono::steady_clock;
+  SignedRCs signed_rcs(numRCs * 2);
+  // neither half has been verified yet
+  const auto mid = signed_rcs.rcs.begin() + numRCs;
+  const std::vector< RouterContact > first(signed_rcs.rcs.begin(), mid);
+  const std::vector< RouterContact > second(mid, signed_rcs.rcs.end());
+
+  const size_t cores = std::max(2u, std::thread::hardware_concurrency());
+  thread::ThreadPool workers(cores, 1024, "verify");
+  REQUIRE(workers.start());
+
+  auto measure = [&](const char* name, const std::vector< RouterContact >& rcs,
+                     thread::ThreadPool* pool) {
+    const auto start = Clock_t::now();
+    const auto valid = VerifyRCs(rcs, time_now_ms(), pool);
+    const std::chrono::duration< double > dlt = Clock_t::now() - start;
+    REQUIRE(std::count(valid.begin(), valid.end(), 1) == long(rcs.size()));
+    std::cout << name << ": " << rcs.size() / dlt.count() << " rcs/s"
+              << std::endl;
+  };
+  measure("one thread", first, nullptr);
+  measure(std::to_string(cores).append(" workers").c_str(), second, &workers);
+  measure("cached", first, nullptr);
+  workers.stop();
+}
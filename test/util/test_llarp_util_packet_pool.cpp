@@ -0,0 +1,122 @@
+#include <util/packet_pool.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <thread>
+#include <vector>
+
+using llarp::util::PacketPool;
+
+TEST_CASE("PacketPool rounds up to a size class", "[packet-pool]")
+{
+  char* small = PacketPool::Alloc(1);
+  REQUIRE(PacketPool::Capacity(small) == PacketPool::ClassSize(0));
+  char* mtu = PacketPool::Alloc(1500);
+  REQUIRE(PacketPool::Capacity(mtu) >= 1500);
+  REQUIRE(PacketPool::Capacity(mtu) < 4096);
+  PacketPool::Free(small);
+  PacketPool::Free(mtu);
+}
+
+TEST_CASE("PacketPool recycles freed blocks", "[packet-pool]")
+{
+  const auto before = PacketPool::GetStats();
+  char* first       = PacketPool::Alloc(1024);
+  PacketPool::Free(first);
+  char* second = PacketPool::Alloc(1024);
+  // the freed block sits in this thread's cache
+  REQUIRE(second == first);
+  const auto after = PacketPool::GetStats();
+  REQUIRE(after.hits > before.hits);
+  REQUIRE(after.bytesOutstanding >= PacketPool::Capacity(second));
+  PacketPool::Free(second);
+  REQUIRE(PacketPool::GetStats().bytesOutstanding
+          == after.bytesOutstanding - PacketPool::Capacity(second));
+}
+
+TEST_CASE("PacketPool does not pool oversize allocations", "[packet-pool]")
+{
+  const auto before = PacketPool::GetStats();
+  char* big         = PacketPool::Alloc(64 * 1024);
+  REQUIRE(PacketPool::Capacity(big) == 64 * 1024);
+  REQUIRE(PacketPool::GetStats().oversize == before.oversize + 1);
+  PacketPool::Free(big);
+  REQUIRE(PacketPool::GetStats().bytesOutstanding == before.bytesOutstanding);
+}
+
+TEST_CASE("PacketPool hands blocks between threads", "[packet-pool]")
+{
+  constexpr size_t numBlocks = PacketPool::ThreadCacheSize * 4;
+  std::vector< char* > blocks;
+  // allocate on this thread and free on another, which spills the
+  // other thread's cache into the depot on the way
+  for(size_t idx = 0; idx < numBlocks; ++idx)
+    blocks.push_back(PacketPool::Alloc(512));
+  std::thread freer([&blocks]() {
+    for(auto* ptr : blocks)
+      PacketPool::Free(ptr);
+  });
+  freer.join();
+  REQUIRE(PacketPool::GetStats().blocksInDepot >= PacketPool::TransferBatch);
+
+  // we can now allocate from the depot without going to the heap
+  const auto before = PacketPool::GetStats();
+  blocks.clear();
+  for(size_t idx = 0; idx < PacketPool::TransferBatch; ++idx)
+    blocks.push_back(PacketPool::Alloc(512));
+  const auto after = PacketPool::GetStats();
+  REQUIRE(after.misses == before.misses);
+  REQUIRE(after.hits == before.hits + PacketPool::TransferBatch);
+  for(auto* ptr : blocks)
+    PacketPool::Free(ptr);
+}
+
+TEST_CASE("PacketPool keeps the counts of threads that exited",
+          "[packet-pool]")
+{
+  constexpr size_t numBlocks = 16;
+  const auto before          = PacketPool::GetStats();
+  std::vector< char* > blocks;
+  std::thread allocator([&blocks]() {
+    for(size_t idx = 0; idx < numBlocks; ++idx)
+      blocks.push_back(PacketPool::Alloc(1024));
+  });
+  allocator.join();
+  const auto after  = PacketPool::GetStats();
+  const size_t bytes = numBlocks * PacketPool::Capacity(blocks[0]);
+  REQUIRE(after.hits + after.misses == before.hits + before.misses + numBlocks);
+  REQUIRE(after.bytesOutstanding == before.bytesOutstanding + bytes);
+  // freed here, counted against this thread
+  for(auto* ptr : blocks)
+    PacketPool::Free(ptr);
+  REQUIRE(PacketPool::GetStats().bytesOutstanding == before.bytesOutstanding);
+}
+
+namespace
+{
+  /// frees its block when the thread it lives on exits
+  struct FreeAtExit
+  {
+    char* ptr = nullptr;
+
+    ~FreeAtExit()
+    {
+      PacketPool::Free(ptr);
+    }
+  };
+}  // namespace
+
+TEST_CASE("PacketPool takes frees after a thread's cache is gone",
+          "[packet-pool]")
+{
+  const auto before = PacketPool::GetStats();
+  std::thread exiting([]() {
+    // made before the pool's cache for this thread, so destroyed after it
+    static thread_local FreeAtExit late;
+    late.ptr = PacketPool::Alloc(256);
+  });
+  exiting.join();
+  const auto after = PacketPool::GetStats();
+  REQUIRE(after.bytesOutstanding == before.bytesOutstanding);
+  REQUIRE(after.blocksInDepot == before.blocksInDepot + 1);
+}
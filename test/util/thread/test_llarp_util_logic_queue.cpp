@@ -0,0 +1,118 @@
+#include <util/thread/logic_queue.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <future>
+#include <thread>
+#include <vector>
+
+using namespace llarp;
+
+namespace
+{
+  struct Item
+  {
+    size_t producer;
+    size_t seq;
+  };
+
+  constexpr size_t NumProducers = 4;
+
+  bool
+  WaitFor(const std::atomic< size_t >& count, size_t want)
+  {
+    for(size_t tries = 0; tries < 500; ++tries)
+    {
+      if(count.load() >= want)
+        return true;
+      std::this_thread::sleep_for(10ms);
+    }
+    return false;
+  }
+}  // namespace
+
+TEST_CASE("logic queue hands items over in push order", "[logic][queue]")
+{
+  constexpr size_t PerProducer = 1000;
+  std::vector< std::vector< size_t > > seen(NumProducers);
+  std::atomic< size_t > handled{0};
+  LogicQueue< Item > queue{4096, [&](Item item) {
+                             seen[item.producer].push_back(item.seq);
+                             handled++;
+                           }};
+  auto logic = std::make_shared< Logic >();
+
+  std::vector< std::thread > producers;
+  for(size_t producer = 0; producer < NumProducers; ++producer)
+  {
+    producers.emplace_back([&, producer]() {
+      for(size_t seq = 0; seq < PerProducer; ++seq)
+        queue.Push(logic, Item{producer, seq});
+    });
+  }
+  for(auto& producer : producers)
+    producer.join();
+  REQUIRE(WaitFor(handled, NumProducers * PerProducer));
+
+  auto status = queue.ExtractStatus();
+  REQUIRE(status["depth"] == 0);
+  REQUIRE(status["overflows"] == 0);
+  REQUIRE(status["handled"] == NumProducers * PerProducer);
+  for(const auto& seqs : seen)
+  {
+    REQUIRE(seqs.size() == PerProducer);
+    REQUIRE(std::is_sorted(seqs.begin(), seqs.end()));
+  }
+  logic->stop();
+}
+
+TEST_CASE("logic queue falls back when the ring is full", "[logic][queue]")
+{
+  constexpr size_t Capacity = 16;
+  constexpr size_t Pushes   = 40;
+  std::atomic< size_t > handled{0};
+  LogicQueue< Item > queue{Capacity, [&](Item) { handled++; }};
+  auto logic = std::make_shared< Logic >();
+
+  // hold the logic thread so nothing drains while we fill the ring
+  std::promise< void > release;
+  auto held = release.get_future().share();
+  LogicCall(logic, [held]() { held.wait(); });
+  for(size_t seq = 0; seq < Pushes; ++seq)
+    queue.Push(logic, Item{0, seq});
+  REQUIRE(queue.Depth() == Capacity);
+  release.set_value();
+
+  REQUIRE(WaitFor(handled, Pushes));
+  auto status = queue.ExtractStatus();
+  REQUIRE(status["handled"] == Capacity);
+  REQUIRE(status["overflows"] == Pushes - Capacity);
+  REQUIRE(status["maxDepth"] == Capacity);
+  REQUIRE(status["drains"] == 1);
+  logic->stop();
+}
+
+TEST_CASE("logic queue drains left behind by a gone queue do nothing",
+          "[logic][queue]")
+{
+  std::atomic< size_t > handled{0};
+  auto logic = std::make_shared< Logic >();
+
+  std::promise< void > release;
+  auto held = release.get_future().share();
+  LogicCall(logic, [held]() { held.wait(); });
+  {
+    LogicQueue< Item > queue{1, [&](Item) { handled++; }};
+    // one drain and one overflow call wait behind the held logic thread
+    queue.Push(logic, Item{0, 0});
+    queue.Push(logic, Item{0, 1});
+  }
+  std::atomic< size_t > ran{0};
+  LogicCall(logic, [&ran]() { ran++; });
+  release.set_value();
+
+  REQUIRE(WaitFor(ran, 1));
+  REQUIRE(handled == 0);
+  logic->stop();
+}
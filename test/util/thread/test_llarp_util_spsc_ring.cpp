@@ -0,0 +1,56 @@
+#include <util/thread/spsc_ring.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <memory>
+#include <thread>
+
+using namespace llarp;
+
+TEST_CASE("spsc ring fills up and empties in order", "[queue]")
+{
+  thread::SPSCRing< std::unique_ptr< size_t > > ring{3};
+  REQUIRE(ring.capacity() == 4);
+  REQUIRE_FALSE(ring.tryPopFront().has_value());
+  for(size_t idx = 0; idx < ring.capacity(); ++idx)
+    REQUIRE(ring.tryPushBack(std::make_unique< size_t >(idx)));
+  REQUIRE_FALSE(ring.tryPushBack(std::make_unique< size_t >(4)));
+  REQUIRE(ring.size() == 4);
+  for(size_t idx = 0; idx < ring.capacity(); ++idx)
+  {
+    auto item = ring.tryPopFront();
+    REQUIRE(item.has_value());
+    REQUIRE(**item == idx);
+  }
+  REQUIRE_FALSE(ring.tryPopFront().has_value());
+  REQUIRE(ring.size() == 0);
+}
+
+TEST_CASE("spsc ring hands everything across threads in order", "[queue]")
+{
+  constexpr size_t NumItems = 100000;
+  thread::SPSCRing< size_t > ring{64};
+  std::thread producer([&ring]() {
+    for(size_t idx = 0; idx < NumItems; ++idx)
+    {
+      while(not ring.tryPushBack(size_t{idx}))
+        std::this_thread::yield();
+    }
+  });
+  size_t next  = 0;
+  bool inOrder = true;
+  while(next < NumItems)
+  {
+    auto item = ring.tryPopFront();
+    if(not item.has_value())
+    {
+      std::this_thread::yield();
+      continue;
+    }
+    inOrder = inOrder && *item == next;
+    ++next;
+  }
+  producer.join();
+  REQUIRE(inOrder);
+  REQUIRE(ring.size() == 0);
+}